@@ -16,6 +16,10 @@ Object.setPrototypeOf(URLRequest.prototype, EventEmitter.prototype)
 
 const kSupportedProtocols = new Set(['http:', 'https:'])
 
+// Size of the response chunks, and of the response buffer before reading from
+// the network is paused.
+const kDefaultHighWaterMark = 64 * 1024
+
 // set of headers that Node.js discards duplicates for
 // see https://nodejs.org/api/http.html#http_message_headers
 const discardableDuplicateHeaders = new Set([
@@ -40,18 +44,23 @@ const discardableDuplicateHeaders = new Set([
 ])
 
 class IncomingMessage extends Readable {
-  constructor (urlRequest) {
-    super()
+  constructor (urlRequest, highWaterMark, hasDestination) {
+    super({ highWaterMark })
     this.urlRequest = urlRequest
-    this.shouldPush = false
-    this.data = []
+    if (hasDestination) {
+      // The body goes to the file, so nobody has to read the stream for it to
+      // end.
+      this.resume()
+    }
     this.urlRequest.on('data', (event, chunk) => {
-      this._storeInternalData(chunk)
-      this._pushInternalData()
+      // Stop reading from the network until the consumer catches up, the
+      // native side resumes when _read is called.
+      if (!this.push(chunk)) {
+        this.urlRequest.pauseResponse()
+      }
     })
     this.urlRequest.on('end', () => {
-      this._storeInternalData(null)
-      this._pushInternalData()
+      this.push(null)
     })
   }
 
@@ -103,20 +112,8 @@ class IncomingMessage extends Readable {
     throw new Error('HTTP trailers are not supported')
   }
 
-  _storeInternalData (chunk) {
-    this.data.push(chunk)
-  }
-
-  _pushInternalData () {
-    while (this.shouldPush && this.data.length > 0) {
-      const chunk = this.data.shift()
-      this.shouldPush = this.push(chunk)
-    }
-  }
-
   _read () {
-    this.shouldPush = true
-    this._pushInternalData()
+    this.urlRequest.resumeResponse()
   }
 }
 
@@ -200,10 +197,32 @@ class ClientRequest extends EventEmitter {
       throw new Error('redirect mode should be one of follow, error or manual')
     }
 
+    const highWaterMark = options.highWaterMark === undefined ? kDefaultHighWaterMark : options.highWaterMark
+    if (!Number.isInteger(highWaterMark) || highWaterMark <= 0) {
+      throw new TypeError('`highWaterMark` should be a positive integer')
+    }
+
     const urlRequestOptions = {
       method: method,
       url: urlStr,
-      redirect: redirectPolicy
+      redirect: redirectPolicy,
+      highWaterMark
+    }
+    if (options.destination) {
+      const { path, fd, resume, progressInterval } = options.destination
+      if ((path === undefined) === (fd === undefined)) {
+        throw new TypeError('`destination` should have either a `path` or an `fd`')
+      }
+      if (path !== undefined && typeof path !== 'string') {
+        throw new TypeError('`destination.path` should be a string')
+      }
+      if (fd !== undefined && !Number.isInteger(fd)) {
+        throw new TypeError('`destination.fd` should be an integer')
+      }
+      if (progressInterval !== undefined && !(Number.isInteger(progressInterval) && progressInterval >= 0)) {
+        throw new TypeError('`destination.progressInterval` should be a non-negative integer')
+      }
+      urlRequestOptions.destination = { path, fd, resume: !!resume, progressInterval }
     }
     if (options.session) {
       if (options.session instanceof Session) {
@@ -241,7 +260,7 @@ class ClientRequest extends EventEmitter {
     this.chunkedEncodingEnabled = false
 
     urlRequest.on('response', () => {
-      const response = new IncomingMessage(urlRequest)
+      const response = new IncomingMessage(urlRequest, highWaterMark, !!urlRequestOptions.destination)
       urlRequest._response = response
       this.emit('response', response)
     })
@@ -4,6 +4,7 @@ const features = process.electronBinding('features')
 const { EventEmitter } = require('events')
 const electron = require('electron')
 const path = require('path')
+const { Readable } = require('stream')
 const url = require('url')
 const { app, ipcMain, session, deprecate } = electron
 
@@ -64,7 +65,7 @@ const PDFPageSizes = {
 
 // Default printing setting
 const defaultPrintingSetting = {
-  pageRage: [],
+  pageRange: [],
   mediaSize: {},
   landscape: false,
   color: 2,
@@ -202,7 +203,7 @@ WebContents.prototype.executeJavaScript = function (code, hasUserGesture) {
 }
 
 // Translate the options of printToPDF.
-WebContents.prototype.printToPDF = function (options) {
+const getPrintToPDFSetting = function (options) {
   const printingSetting = {
     ...defaultPrintingSetting,
     requestID: getNextId()
@@ -226,11 +227,25 @@ WebContents.prototype.printToPDF = function (options) {
     printingSetting.shouldPrintBackgrounds = options.printBackground
   }
 
+  if (options.pageRanges) {
+    if (!Array.isArray(options.pageRanges)) {
+      throw new Error('pageRanges must be an array')
+    }
+    printingSetting.pageRange = options.pageRanges.map(range => {
+      if (!range || !Number.isInteger(range.from) || !Number.isInteger(range.to) ||
+          range.from < 0 || range.to < range.from) {
+        throw new Error('pageRanges must have integer from and to, with from <= to')
+      }
+      // Chromium counts pages from 1.
+      return { from: range.from + 1, to: range.to + 1 }
+    })
+  }
+
   if (options.pageSize) {
     const pageSize = options.pageSize
     if (typeof pageSize === 'object') {
       if (!pageSize.height || !pageSize.width) {
-        return Promise.reject(new Error('Must define height and width for pageSize'))
+        throw new Error('Must define height and width for pageSize')
       }
       // Dimensions in Microns
       // 1 meter = 10^6 microns
@@ -243,7 +258,7 @@ WebContents.prototype.printToPDF = function (options) {
     } else if (PDFPageSizes[pageSize]) {
       printingSetting.mediaSize = PDFPageSizes[pageSize]
     } else {
-      return Promise.reject(new Error(`Does not support pageSize with ${pageSize}`))
+      throw new Error(`Does not support pageSize with ${pageSize}`)
     }
   } else {
     printingSetting.mediaSize = PDFPageSizes['A4']
@@ -253,11 +268,94 @@ WebContents.prototype.printToPDF = function (options) {
   printingSetting.scaleFactor = Math.ceil(printingSetting.scaleFactor) % 100
   // PrinterType enum from //printing/print_job_constants.h
   printingSetting.printerType = 2
-  if (features.isPrintingEnabled()) {
-    return this._printToPDF(printingSetting)
-  } else {
+  return printingSetting
+}
+
+// Every PDF is laid out by its page's renderer, so PDFs of different pages
+// are generated in parallel. The number generated at once is capped by
+// webContents.setPrintToPDFConcurrency().
+let printToPDFConcurrency = Infinity
+let printToPDFCount = 0
+const printToPDFQueue = []
+
+const runPrintToPDFJobs = function () {
+  while (printToPDFCount < printToPDFConcurrency && printToPDFQueue.length > 0) {
+    const { job, resolve, reject } = printToPDFQueue.shift()
+    printToPDFCount++
+    new Promise(resolve => resolve(job())).then(resolve, reject).finally(() => {
+      printToPDFCount--
+      runPrintToPDFJobs()
+    })
+  }
+}
+
+// Resolves with a Buffer, or with the PDF left in native memory when |raw|.
+const printToPDF = function (contents, options, raw) {
+  let printingSetting
+  try {
+    printingSetting = getPrintToPDFSetting(options)
+  } catch (error) {
+    return Promise.reject(error)
+  }
+  if (!features.isPrintingEnabled()) {
     return Promise.reject(new Error('Printing feature is disabled'))
   }
+  return new Promise((resolve, reject) => {
+    printToPDFQueue.push({
+      job: () => contents._printToPDF(printingSetting, raw),
+      resolve,
+      reject
+    })
+    runPrintToPDFJobs()
+  })
+}
+
+WebContents.prototype.printToPDF = function (options) {
+  return printToPDF(this, options, false)
+}
+
+WebContents.prototype.printToPDFStream = function (options) {
+  let data = null
+  let offset = 0
+  // The PDF stays in native memory and is copied out one chunk at a time.
+  const pushChunk = function (size) {
+    const chunk = data.read(offset, size)
+    offset += chunk.length
+    stream.push(chunk)
+    if (offset >= data.size) {
+      data = null
+      stream.push(null)
+    }
+  }
+  const stream = new Readable({
+    highWaterMark: 1024 * 1024,
+    read (size) {
+      if (data) pushChunk(size)
+    },
+    destroy (error, callback) {
+      data = null
+      callback(error)
+    }
+  })
+  printToPDF(this, options, true).then((result) => {
+    if (stream.destroyed) return
+    if (result.size === 0) {
+      stream.push(null)
+      return
+    }
+    data = result
+    pushChunk(stream.readableHighWaterMark)
+  }, (error) => {
+    stream.destroy(error)
+  })
+  return stream
+}
+
+WebContents.prototype.printToPDFFile = function (filePath, options) {
+  if (typeof filePath !== 'string') {
+    return Promise.reject(new Error('Must pass filePath as a string'))
+  }
+  return printToPDF(this, options, true).then(data => data.writeToFile(filePath))
 }
 
 WebContents.prototype.print = function (...args) {
@@ -276,6 +374,20 @@ WebContents.prototype.getPrinters = function () {
   }
 }
 
+WebContents.prototype.createHeapSnapshotStream = function (options = {}) {
+  const stream = new Readable({ read () {} })
+  this._streamHeapSnapshot(options, (chunk) => {
+    stream.push(chunk)
+  }, (success) => {
+    if (success) {
+      stream.push(null)
+    } else {
+      stream.destroy(new Error('takeHeapSnapshot failed'))
+    }
+  })
+  return stream
+}
+
 WebContents.prototype.loadFile = function (filePath, options = {}) {
   if (typeof filePath !== 'string') {
     throw new Error('Must pass filePath as a string')
@@ -466,5 +578,18 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  setPrintToPDFConcurrency (limit) {
+    if (limit !== Infinity && (!Number.isInteger(limit) || limit <= 0)) {
+      throw new Error('limit must be a positive integer or Infinity')
+    }
+    printToPDFConcurrency = limit
+    runPrintToPDFJobs()
+  },
+
+  createRenderPool (options) {
+    const { RenderPool } = require('@electron/internal/browser/render-pool')
+    return new RenderPool(options)
   }
 }
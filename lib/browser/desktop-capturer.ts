@@ -64,3 +64,81 @@ export const getSources = (event: Electron.IpcMainEvent, options: ElectronIntern
 
   return getSources
 }
+
+const watchers = new Map<string, () => void>()
+
+const serializeSource = (source: Electron.DesktopCapturerSource, fetchWindowIcons: boolean): ElectronInternal.GetSourcesResult => ({
+  id: source.id,
+  name: source.name,
+  thumbnail: source.thumbnail.toDataURL(),
+  display_id: source.display_id,
+  appIcon: (fetchWindowIcons && source.appIcon) ? source.appIcon.toDataURL() : null
+})
+
+// Changes to the sources are forwarded to the watcher in the renderer as they
+// happen, so it never waits for a full enumeration. The watcher is stopped
+// when its frame navigates away.
+export const startWatching = (event: Electron.IpcMainInvokeEvent, id: number, options: ElectronInternal.WatchSourcesOptions) => {
+  const sender = event.sender as Electron.WebContentsInternal
+  const { frameId } = event
+  const key = `${sender.id}-${frameId}-${id}`
+  if (watchers.has(key)) throw new Error('The watcher is already running')
+
+  let capturer: ElectronInternal.DesktopCapturer | null = createDesktopCapturer()
+
+  const send = (name: string, ...args: any[]) => {
+    if (!sender.isDestroyed()) {
+      sender._sendToFrameInternal(frameId, 'ELECTRON_RENDERER_DESKTOP_CAPTURER_WATCHER_EVENT', id, name, ...args)
+    }
+  }
+
+  const onFrameNavigate = (event: Electron.Event, url: string, httpResponseCode: number, httpStatusText: string, isMainFrame: boolean, frameProcessId: number, frameRoutingId: number) => {
+    if (isMainFrame || frameRoutingId === frameId) stop()
+  }
+
+  const stop = () => {
+    if (capturer) {
+      capturer.stopWatching()
+      capturer.emit = null
+      capturer = null
+    }
+    watchers.delete(key)
+    sender.removeListener('did-frame-navigate', onFrameNavigate)
+    sender.removeListener('crashed', stop)
+    sender.removeListener('destroyed', stop)
+  }
+
+  const emitter = new EventEmitter()
+  emitter.on('source-added', (event, source: Electron.DesktopCapturerSource) => {
+    send('source-added', serializeSource(source, options.fetchWindowIcons))
+  })
+  emitter.on('source-removed', (event, sourceId: string) => {
+    send('source-removed', sourceId)
+  })
+  emitter.on('source-name-changed', (event, sourceId: string, name: string) => {
+    send('source-name-changed', sourceId, name)
+  })
+  emitter.on('thumbnail-changed', (event, sourceId: string, thumbnail: Electron.NativeImage) => {
+    send('thumbnail-changed', sourceId, thumbnail.toDataURL())
+  })
+  emitter.on('ready', () => {
+    send('ready')
+  })
+  emitter.on('error', (event, error: string) => {
+    stop()
+    send('error', error)
+  })
+
+  capturer.emit = emitter.emit.bind(emitter)
+  capturer.startWatching(options.captureWindow, options.captureScreen, options.thumbnailSize, options.fetchWindowIcons, options.interval)
+
+  watchers.set(key, stop)
+  sender.on('did-frame-navigate', onFrameNavigate)
+  sender.once('crashed', stop)
+  sender.once('destroyed', stop)
+}
+
+export const stopWatching = (event: ElectronInternal.IpcMainInternalEvent, id: number) => {
+  const stop = watchers.get(`${event.sender.id}-${event.frameId}-${id}`)
+  if (stop) stop()
+}
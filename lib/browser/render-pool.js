@@ -0,0 +1,170 @@
+'use strict'
+
+const { webContents } = require('electron')
+
+const features = process.electronBinding('features')
+
+const formats = ['pdf', 'png', 'html']
+
+// Runs render jobs on a pool of offscreen web contents.
+//
+// A web contents is only created when no idle one is left, and at most |size|
+// of them exist at once, which is also the number of jobs run in parallel.
+// After a job its page is replaced by about:blank and its history cleared, so
+// the next job starts from a clean navigation state without paying for a new
+// web contents and renderer process.
+class RenderPool {
+  constructor (options = {}) {
+    if (!features.isOffscreenRenderingEnabled()) {
+      throw new Error('Offscreen rendering is disabled')
+    }
+    const { size = 4, width = 800, height = 600, session, partition, webPreferences = {} } = options
+    if (!Number.isInteger(size) || size <= 0) {
+      throw new Error('size must be a positive integer')
+    }
+    if (!Number.isInteger(width) || width <= 0 || !Number.isInteger(height) || height <= 0) {
+      throw new Error('width and height must be positive integers')
+    }
+
+    this._size = size
+    this._pageSize = { width, height }
+    this._contentsOptions = { ...webPreferences, session, partition, offscreen: true, show: false }
+    this._idle = []
+    this._count = 0
+    this._queue = []
+    this._destroyed = false
+  }
+
+  get size () {
+    return this._size
+  }
+
+  get pendingCount () {
+    return this._queue.length
+  }
+
+  render (job) {
+    if (this._destroyed) {
+      return Promise.reject(new Error('The render pool was destroyed'))
+    }
+    if (!job || typeof job.url !== 'string') {
+      return Promise.reject(new Error('Must pass a job with a url'))
+    }
+    const format = job.format || 'pdf'
+    if (!formats.includes(format)) {
+      return Promise.reject(new Error(`Unknown format: ${format}`))
+    }
+    return new Promise((resolve, reject) => {
+      this._queue.push({ job: { ...job, format }, resolve, reject })
+      this._schedule()
+    })
+  }
+
+  destroy () {
+    if (this._destroyed) return
+    this._destroyed = true
+    for (const { reject } of this._queue.splice(0)) {
+      reject(new Error('The render pool was destroyed'))
+    }
+    for (const contents of this._idle.splice(0)) {
+      this._discard(contents)
+    }
+  }
+
+  _schedule () {
+    while (this._queue.length > 0) {
+      const contents = this._acquire()
+      if (!contents) return
+      if (this._queue.length === 0) {
+        this._idle.push(contents)
+        return
+      }
+      const { job, resolve, reject } = this._queue.shift()
+      this._execute(contents, job).then(resolve, reject)
+    }
+  }
+
+  _acquire () {
+    while (this._idle.length > 0) {
+      const contents = this._idle.pop()
+      if (!contents.isDestroyed() && !contents.isCrashed()) return contents
+      // The caller schedules the queued jobs itself.
+      this._discard(contents, false)
+    }
+    if (this._count >= this._size) return null
+    this._count++
+    const contents = webContents.create(this._contentsOptions)
+    contents._setOffscreenSize(this._pageSize)
+    return contents
+  }
+
+  async _execute (contents, job) {
+    let reusable = false
+    try {
+      const result = await this._runWithTimeout(contents, job)
+      reusable = true
+      return result
+    } finally {
+      this._release(contents, reusable)
+    }
+  }
+
+  _runWithTimeout (contents, job) {
+    const run = this._run(contents, job)
+    if (!job.timeout) return run
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        reject(new Error(`The render job timed out after ${job.timeout}ms`))
+      }, job.timeout)
+      run.then(resolve, reject).finally(() => clearTimeout(timer))
+    })
+  }
+
+  async _run (contents, job) {
+    if (job.width || job.height) {
+      contents._setOffscreenSize({
+        width: job.width || this._pageSize.width,
+        height: job.height || this._pageSize.height
+      })
+    }
+    await contents.loadURL(job.url, job.loadOptions)
+    switch (job.format) {
+      case 'pdf':
+        return contents.printToPDF(job.printOptions || {})
+      case 'png': {
+        const image = await contents.capturePage()
+        return image.toPNG()
+      }
+      case 'html':
+        return contents.executeJavaScript('document.documentElement.outerHTML')
+    }
+  }
+
+  // Contents whose job failed are not reused, they may still be busy with it.
+  _release (contents, reusable) {
+    if (!reusable || this._destroyed || contents.isDestroyed() || contents.isCrashed()) {
+      this._discard(contents)
+      return
+    }
+    contents._setOffscreenSize(this._pageSize)
+    contents.loadURL('about:blank').then(() => {
+      if (this._destroyed || contents.isDestroyed()) {
+        this._discard(contents)
+        return
+      }
+      contents.clearHistory()
+      this._idle.push(contents)
+      this._schedule()
+    }, () => {
+      this._discard(contents)
+    })
+  }
+
+  _discard (contents, reschedule = true) {
+    if (!contents.isDestroyed()) contents.destroy()
+    this._count--
+    if (reschedule) this._schedule()
+  }
+}
+
+module.exports = { RenderPool }
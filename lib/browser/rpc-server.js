@@ -65,6 +65,12 @@ ipcMainUtils.handleSync('ELECTRON_BROWSER_CLIPBOARD', function (event, method, .
   return clipboardUtils.serialize(electron.clipboard[method](...clipboardUtils.deserialize(args)))
 })
 
+if (process.platform === 'linux') {
+  ipcMainInternal.handle('ELECTRON_BROWSER_CLIPBOARD_READ_ASYNC', async function (event, format, options) {
+    return clipboardUtils.serialize(await electron.clipboard.readAsync(format, options))
+  })
+}
+
 if (features.isDesktopCapturerEnabled()) {
   const desktopCapturer = require('@electron/internal/browser/desktop-capturer')
 
@@ -79,6 +85,23 @@ if (features.isDesktopCapturerEnabled()) {
 
     return desktopCapturer.getSources(event, options)
   })
+
+  ipcMainInternal.handle('ELECTRON_BROWSER_DESKTOP_CAPTURER_START_WATCHING', function (event, id, options, stack) {
+    logStack(event.sender, 'desktopCapturer.watchSources()', stack)
+    const customEvent = emitCustomEvent(event.sender, 'desktop-capturer-get-sources')
+
+    if (customEvent.defaultPrevented) {
+      console.error('Blocked desktopCapturer.watchSources()')
+      return false
+    }
+
+    desktopCapturer.startWatching(event, id, options)
+    return true
+  })
+
+  ipcMainInternal.on('ELECTRON_BROWSER_DESKTOP_CAPTURER_STOP_WATCHING', function (event, id) {
+    desktopCapturer.stopWatching(event, id)
+  })
 }
 
 const isRemoteModuleEnabled = features.isRemoteModuleEnabled()
@@ -19,6 +19,12 @@ if (process.type === 'renderer') {
     for (const method of Object.keys(clipboard)) {
       clipboard[method] = makeRemoteMethod(method)
     }
+    // Asynchronous reads must not block the renderer on a synchronous IPC.
+    const { ipcRendererInternal } = require('@electron/internal/renderer/ipc-renderer-internal')
+    clipboard.readAsync = async (...args) => {
+      const result = await ipcRendererInternal.invoke('ELECTRON_BROWSER_CLIPBOARD_READ_ASYNC', ...args)
+      return clipboardUtils.deserialize(result)
+    }
   } else if (process.platform === 'darwin') {
     // Read/write to find pasteboard over IPC since only main process is notified of changes
     clipboard.readFindText = makeRemoteMethod('readFindText')
@@ -26,4 +32,34 @@ if (process.type === 'renderer') {
   }
 }
 
+// Formats given as functions are provided after the others have been written,
+// and are then written together with them unless something else has been
+// copied in the meantime.
+clipboard.writeMany = function (data, type) {
+  if (data === null || typeof data !== 'object') {
+    throw new Error('data must be an object')
+  }
+  const formats = {}
+  const providers = []
+  for (const [format, value] of Object.entries(data)) {
+    if (typeof value === 'function') {
+      providers.push([format, value])
+    } else {
+      formats[format] = value
+    }
+  }
+  clipboard._writeMany(formats, type)
+  if (providers.length === 0) return Promise.resolve(true)
+
+  const sequenceNumber = clipboard._getSequenceNumber(type)
+  return Promise.all(providers.map(async ([format, provider]) => [format, await provider()])).then((provided) => {
+    if (clipboard._getSequenceNumber(type) !== sequenceNumber) return false
+    for (const [format, value] of provided) {
+      if (value != null) formats[format] = value
+    }
+    clipboard._writeMany(formats, type)
+    return true
+  })
+}
+
 module.exports = clipboard
@@ -1,10 +1,11 @@
+import { EventEmitter } from 'events'
 import { nativeImage } from 'electron'
 import { ipcRendererInternal } from '@electron/internal/renderer/ipc-renderer-internal'
 
 const { hasSwitch } = process.electronBinding('command_line')
 
 // |options.types| can't be empty and must be an array
-function isValid (options: Electron.SourcesOptions) {
+function isValid (options: Electron.SourcesOptions | Electron.WatchSourcesOptions) {
   const types = options ? options.types : undefined
   return Array.isArray(types)
 }
@@ -19,6 +20,16 @@ function getCurrentStack () {
   return (target as any).stack
 }
 
+function deserializeSource (source: ElectronInternal.GetSourcesResult) {
+  return {
+    id: source.id,
+    name: source.name,
+    thumbnail: nativeImage.createFromDataURL(source.thumbnail),
+    display_id: source.display_id,
+    appIcon: source.appIcon ? nativeImage.createFromDataURL(source.appIcon) : null
+  }
+}
+
 export async function getSources (options: Electron.SourcesOptions) {
   if (!isValid(options)) throw new Error('Invalid options')
 
@@ -35,11 +46,107 @@ export async function getSources (options: Electron.SourcesOptions) {
     fetchWindowIcons
   } as ElectronInternal.GetSourcesOptions, getCurrentStack())
 
-  return sources.map(source => ({
-    id: source.id,
-    name: source.name,
-    thumbnail: nativeImage.createFromDataURL(source.thumbnail),
-    display_id: source.display_id,
-    appIcon: source.appIcon ? nativeImage.createFromDataURL(source.appIcon) : null
-  }))
+  return sources.map(deserializeSource)
+}
+
+type Source = ReturnType<typeof deserializeSource>
+
+class DesktopCapturerWatcher extends EventEmitter {
+  private _sources = new Map<string, Source>()
+  private _stopped = false
+
+  constructor (private _id: number) {
+    super()
+  }
+
+  getSources () {
+    return Array.from(this._sources.values())
+  }
+
+  stop () {
+    if (this._stopped) return
+    this._stopped = true
+    watchers.delete(this._id)
+    ipcRendererInternal.send('ELECTRON_BROWSER_DESKTOP_CAPTURER_STOP_WATCHING', this._id)
+  }
+
+  _handleEvent (name: string, ...args: any[]) {
+    switch (name) {
+      case 'source-added': {
+        const source = deserializeSource(args[0])
+        this._sources.set(source.id, source)
+        this.emit('source-added', source)
+        break
+      }
+      case 'source-removed': {
+        const source = this._sources.get(args[0])
+        if (!source) return
+        this._sources.delete(source.id)
+        this.emit('source-removed', source)
+        break
+      }
+      case 'source-name-changed': {
+        const source = this._sources.get(args[0])
+        if (!source) return
+        source.name = args[1]
+        this.emit('source-name-changed', source)
+        break
+      }
+      case 'thumbnail-changed': {
+        const source = this._sources.get(args[0])
+        if (!source) return
+        source.thumbnail = nativeImage.createFromDataURL(args[1])
+        this.emit('thumbnail-changed', source)
+        break
+      }
+      case 'ready':
+        this.emit('ready')
+        break
+      case 'error':
+        this._stopped = true
+        watchers.delete(this._id)
+        this.emit('error', new Error(args[0]))
+        break
+    }
+  }
+}
+
+let nextWatcherId = 0
+const watchers = new Map<number, DesktopCapturerWatcher>()
+
+ipcRendererInternal.on('ELECTRON_RENDERER_DESKTOP_CAPTURER_WATCHER_EVENT', (event, id: number, name: string, ...args: any[]) => {
+  const watcher = watchers.get(id)
+  if (watcher) watcher._handleEvent(name, ...args)
+})
+
+export function watchSources (options: Electron.WatchSourcesOptions) {
+  if (!isValid(options)) throw new Error('Invalid options')
+
+  const captureWindow = options.types.includes('window')
+  const captureScreen = options.types.includes('screen')
+
+  const { thumbnailSize = { width: 150, height: 150 } } = options
+  const { fetchWindowIcons = false } = options
+  const { interval = 1000 } = options
+
+  // The id is picked here so that no event can arrive before the watcher is
+  // known.
+  const id = ++nextWatcherId
+  const watcher = new DesktopCapturerWatcher(id)
+  watchers.set(id, watcher)
+
+  ipcRendererInternal.invoke<boolean>('ELECTRON_BROWSER_DESKTOP_CAPTURER_START_WATCHING', id, {
+    captureWindow,
+    captureScreen,
+    thumbnailSize,
+    fetchWindowIcons,
+    interval
+  } as ElectronInternal.WatchSourcesOptions, getCurrentStack()).then(started => {
+    // Blocked by the main process, there are no sources to watch.
+    if (!started && watchers.has(id)) watcher._handleEvent('ready')
+  }, error => {
+    if (watchers.has(id)) watcher._handleEvent('error', error.message)
+  })
+
+  return watcher
 }
@@ -424,6 +424,8 @@ int GetPathConstant(const std::string& name) {
     return chrome::DIR_USER_VIDEOS;
   else if (name == "pepperFlashSystemPlugin")
     return chrome::FILE_PEPPER_FLASH_SYSTEM_PLUGIN;
+  else if (name == "dictionaries")
+    return chrome::DIR_APP_DICTIONARIES;
   else
     return -1;
 }
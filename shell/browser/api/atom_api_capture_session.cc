@@ -0,0 +1,296 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/atom_api_capture_session.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/task/post_task.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "gin/object_template_builder.h"
+#include "media/base/video_frame.h"
+#include "media/capture/mojom/video_capture_types.mojom.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "shell/common/gin_converters/image_converter.h"
+#include "shell/common/gin_helper/locker.h"
+#include "shell/common/node_includes.h"
+#include "shell/common/skia_util.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/size_conversions.h"
+#include "ui/gfx/image/image.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+using Promises = std::vector<gin_helper::Promise<v8::Local<v8::Value>>>;
+
+// |bitmap| is released here, its pixels may belong to a capturer that lives
+// on this thread.
+void ResolveWithEncoded(Promises promises,
+                        const SkBitmap& bitmap,
+                        std::vector<unsigned char> encoded) {
+  if (promises.empty())
+    return;
+  if (encoded.empty()) {
+    for (auto& promise : promises)
+      promise.RejectWithErrorMessage("Failed to encode the image");
+    return;
+  }
+  v8::Isolate* isolate = promises.front().isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  for (auto& promise : promises) {
+    v8::Context::Scope context_scope(promise.GetContext());
+    promise.Resolve(node::Buffer::Copy(isolate,
+                                       reinterpret_cast<char*>(encoded.data()),
+                                       encoded.size())
+                        .ToLocalChecked());
+  }
+}
+
+// Encodes |bitmap| on the thread pool.
+void EncodeAndResolve(Promises promises,
+                      scoped_refptr<ImagePipeline> encoder,
+                      const SkBitmap& bitmap) {
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&ImagePipeline::ProcessBitmap, std::move(encoder),
+                     bitmap),
+      base::BindOnce(&ResolveWithEncoded, std::move(promises), bitmap));
+}
+
+}  // namespace
+
+CaptureSession::Options::Options() = default;
+CaptureSession::Options::Options(const Options&) = default;
+CaptureSession::Options::~Options() = default;
+
+gin::WrapperInfo CaptureSession::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+CaptureSession::CaptureSession(v8::Isolate* isolate,
+                               content::WebContents* web_contents,
+                               const Options& options)
+    : content::WebContentsObserver(web_contents),
+      isolate_(isolate),
+      options_(options) {}
+
+CaptureSession::~CaptureSession() = default;
+
+// static
+gin::Handle<CaptureSession> CaptureSession::Create(
+    v8::Isolate* isolate,
+    content::WebContents* web_contents,
+    const Options& options) {
+  return gin::CreateHandle(isolate,
+                           new CaptureSession(isolate, web_contents, options));
+}
+
+v8::Local<v8::Promise> CaptureSession::Capture() {
+  return AddCapture(&pending_images_);
+}
+
+v8::Local<v8::Promise> CaptureSession::CaptureEncoded() {
+  return AddCapture(&pending_encoded_);
+}
+
+v8::Local<v8::Promise> CaptureSession::AddCapture(Promises* pending) {
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate_);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (stopped_) {
+    promise.RejectWithErrorMessage("The capture session was stopped");
+    return handle;
+  }
+
+  if (self_.IsEmpty()) {
+    v8::Local<v8::Object> wrapper;
+    if (GetWrapper(isolate_).ToLocal(&wrapper))
+      self_.Reset(isolate_, wrapper);
+  }
+  pending->push_back(std::move(promise));
+  // The captures that arrive while a frame is on its way share it.
+  if (!capturing_)
+    StartCapturing();
+  return handle;
+}
+
+void CaptureSession::Stop() {
+  stopped_ = true;
+  video_capturer_.reset();
+  capturing_ = false;
+  RejectPending("The capture session was stopped");
+}
+
+void CaptureSession::StartCapturing() {
+  content::RenderWidgetHostView* view =
+      web_contents()->GetRenderWidgetHostView();
+  if (!view) {
+    RejectPending("The page has no view to capture");
+    return;
+  }
+
+  // The size is checked on every capture, the page may have been resized.
+  gfx::Size view_size = gfx::ToRoundedSize(gfx::ScaleSize(
+      gfx::SizeF(view->GetViewBounds().size()), view->GetDeviceScaleFactor()));
+  gfx::Size size =
+      util::GetResizedSize(view_size, options_.width, options_.height);
+  if (size.IsEmpty()) {
+    RejectPending("The page has no size to capture");
+    return;
+  }
+
+  if (!video_capturer_) {
+    video_capturer_ = view->CreateVideoCapturer();
+    video_capturer_->SetAutoThrottlingEnabled(false);
+    video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
+    video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB,
+                               gfx::ColorSpace::CreateREC709());
+  }
+  video_capturer_->SetResolutionConstraints(size, size, true);
+  // Starting the capturer captures a frame right away.
+  video_capturer_->Start(this);
+  capturing_ = true;
+}
+
+void CaptureSession::StopCapturing() {
+  // The capturer keeps its buffers until it is destroyed.
+  if (video_capturer_)
+    video_capturer_->Stop();
+  capturing_ = false;
+}
+
+bool CaptureSession::HasPendingCaptures() const {
+  return !pending_images_.empty() || !pending_encoded_.empty();
+}
+
+void CaptureSession::Resolve(const SkBitmap& frame) {
+  Promises promises;
+  promises.swap(pending_images_);
+  Promises encoded_promises;
+  encoded_promises.swap(pending_encoded_);
+  self_.Reset();
+
+  if (!encoded_promises.empty())
+    EncodeAndResolve(std::move(encoded_promises), options_.encoder, frame);
+  if (promises.empty())
+    return;
+
+  // The frame's buffer goes back to the capturer, so the image gets a copy.
+  SkBitmap copy;
+  if (!copy.tryAllocN32Pixels(frame.width(), frame.height()) ||
+      !frame.readPixels(copy.pixmap())) {
+    for (auto& promise : promises)
+      promise.RejectWithErrorMessage("Failed to copy the frame");
+    return;
+  }
+  copy.setImmutable();
+  gfx::Image image = gfx::Image::CreateFrom1xBitmap(copy);
+
+  gin_helper::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+  for (auto& promise : promises) {
+    v8::Context::Scope context_scope(promise.GetContext());
+    promise.Resolve(gin::ConvertToV8(isolate_, image));
+  }
+}
+
+void CaptureSession::RejectPending(const std::string& message) {
+  Promises promises;
+  promises.swap(pending_images_);
+  for (auto& promise : pending_encoded_)
+    promises.push_back(std::move(promise));
+  pending_encoded_.clear();
+  self_.Reset();
+  for (auto& promise : promises)
+    promise.RejectWithErrorMessage(message);
+}
+
+void CaptureSession::RenderViewHostChanged(content::RenderViewHost* old_host,
+                                           content::RenderViewHost* new_host) {
+  // The capturer is bound to the view of the old host.
+  video_capturer_.reset();
+  capturing_ = false;
+  if (HasPendingCaptures())
+    StartCapturing();
+}
+
+void CaptureSession::RenderProcessGone(base::TerminationStatus status) {
+  video_capturer_.reset();
+  capturing_ = false;
+  RejectPending("The renderer process is gone");
+}
+
+void CaptureSession::WebContentsDestroyed() {
+  Stop();
+}
+
+void CaptureSession::OnFrameCaptured(
+    base::ReadOnlySharedMemoryRegion data,
+    ::media::mojom::VideoFrameInfoPtr info,
+    const gfx::Rect& content_rect,
+    mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
+        callbacks) {
+  mojo::Remote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
+      callbacks_remote(std::move(callbacks));
+  if (!HasPendingCaptures() || !data.IsValid() || content_rect.IsEmpty()) {
+    callbacks_remote->Done();
+    return;
+  }
+  base::ReadOnlySharedMemoryMapping mapping = data.Map();
+  if (!mapping.IsValid() ||
+      mapping.size() < media::VideoFrame::AllocationSize(info->pixel_format,
+                                                         info->coded_size)) {
+    callbacks_remote->Done();
+    return;
+  }
+
+  // The pixels are not modified, see FrameSubscriber::OnFrameCaptured.
+  size_t row_bytes =
+      media::VideoFrame::RowBytes(media::VideoFrame::kARGBPlane,
+                                  info->pixel_format, info->coded_size.width());
+  auto* pixels = static_cast<uint8_t*>(const_cast<void*>(mapping.memory())) +
+                 content_rect.y() * row_bytes + content_rect.x() * 4;
+
+  // Keeps the buffer mapped, and away from the capturer, until the bitmap is
+  // released.
+  struct FramePinner {
+    base::ReadOnlySharedMemoryMapping mapping;
+    mojo::Remote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks> releaser;
+  };
+  SkBitmap frame;
+  frame.installPixels(
+      SkImageInfo::MakeN32(content_rect.width(), content_rect.height(),
+                           kPremul_SkAlphaType),
+      pixels, row_bytes,
+      [](void* addr, void* context) {
+        delete static_cast<FramePinner*>(context);
+      },
+      new FramePinner{std::move(mapping), std::move(callbacks_remote)});
+  frame.setImmutable();
+
+  StopCapturing();
+  Resolve(frame);
+}
+
+void CaptureSession::OnStopped() {}
+
+gin::ObjectTemplateBuilder CaptureSession::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<CaptureSession>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("capture", &CaptureSession::Capture)
+      .SetMethod("captureEncoded", &CaptureSession::CaptureEncoded)
+      .SetMethod("stop", &CaptureSession::Stop);
+}
+
+const char* CaptureSession::GetTypeName() {
+  return "CaptureSession";
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,114 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ATOM_API_CAPTURE_SESSION_H_
+#define SHELL_BROWSER_API_ATOM_API_CAPTURE_SESSION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/optional.h"
+#include "components/viz/host/client_frame_sink_video_capturer.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "shell/common/gin_helper/promise.h"
+#include "shell/common/image_pipeline.h"
+
+class SkBitmap;
+
+namespace electron {
+
+namespace api {
+
+// Captures a page repeatedly at a fixed size, for taking periodic snapshots.
+//
+// The frames are scaled down by the compositor, and the capturer is kept
+// between captures so its readback buffers are reused. It only runs while a
+// capture is pending.
+class CaptureSession : public gin::Wrappable<CaptureSession>,
+                       public content::WebContentsObserver,
+                       public viz::mojom::FrameSinkVideoConsumer {
+ public:
+  struct Options {
+    Options();
+    Options(const Options&);
+    ~Options();
+
+    // The size of the snapshots in pixels, the missing one is scaled to
+    // preserve the aspect ratio of the page. Defaults to the page's size.
+    base::Optional<int> width;
+    base::Optional<int> height;
+    // Encodes the snapshots of captureEncoded().
+    scoped_refptr<ImagePipeline> encoder;
+  };
+
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<CaptureSession> Create(v8::Isolate* isolate,
+                                            content::WebContents* web_contents,
+                                            const Options& options);
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  CaptureSession(v8::Isolate* isolate,
+                 content::WebContents* web_contents,
+                 const Options& options);
+  ~CaptureSession() override;
+
+  using Promises = std::vector<gin_helper::Promise<v8::Local<v8::Value>>>;
+
+  v8::Local<v8::Promise> Capture();
+  v8::Local<v8::Promise> CaptureEncoded();
+  v8::Local<v8::Promise> AddCapture(Promises* pending);
+  void Stop();
+
+  void StartCapturing();
+  void StopCapturing();
+  bool HasPendingCaptures() const;
+  void Resolve(const SkBitmap& frame);
+  void RejectPending(const std::string& message);
+
+  // content::WebContentsObserver:
+  void RenderViewHostChanged(content::RenderViewHost* old_host,
+                             content::RenderViewHost* new_host) override;
+  void RenderProcessGone(base::TerminationStatus status) override;
+  void WebContentsDestroyed() override;
+
+  // viz::mojom::FrameSinkVideoConsumer:
+  void OnFrameCaptured(
+      base::ReadOnlySharedMemoryRegion data,
+      ::media::mojom::VideoFrameInfoPtr info,
+      const gfx::Rect& content_rect,
+      mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
+          callbacks) override;
+  void OnStopped() override;
+
+  v8::Isolate* isolate_;
+  Options options_;
+  bool stopped_ = false;
+
+  std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
+  bool capturing_ = false;
+  Promises pending_images_;
+  Promises pending_encoded_;
+
+  // Keeps the wrapper alive while captures are pending.
+  v8::Global<v8::Object> self_;
+
+  DISALLOW_COPY_AND_ASSIGN(CaptureSession);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ATOM_API_CAPTURE_SESSION_H_
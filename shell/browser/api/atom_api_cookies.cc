@@ -4,9 +4,15 @@
 
 #include "shell/browser/api/atom_api_cookies.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <set>
+#include <tuple>
 #include <utility>
+#include <vector>
 
+#include "base/memory/ref_counted.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -21,6 +27,7 @@
 #include "shell/browser/atom_browser_context.h"
 #include "shell/browser/cookie_change_notifier.h"
 #include "shell/common/gin_converters/gurl_converter.h"
+#include "shell/common/gin_converters/std_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
@@ -162,6 +169,143 @@ std::string InclusionStatusToString(
   return "Setting cookie failed";
 }
 
+// Builds the cookie described by the |details| passed to cookies.set(),
+// returns nullptr and sets |error| when they are invalid.
+std::unique_ptr<net::CanonicalCookie> CreateCookieFromDetails(
+    const base::Value& details,
+    std::string* scheme,
+    net::CookieOptions* options,
+    std::string* error) {
+  const std::string* url_string = details.FindStringKey("url");
+  const std::string* name = details.FindStringKey("name");
+  const std::string* value = details.FindStringKey("value");
+  const std::string* domain = details.FindStringKey("domain");
+  const std::string* path = details.FindStringKey("path");
+  bool secure = details.FindBoolKey("secure").value_or(false);
+  bool http_only = details.FindBoolKey("httpOnly").value_or(false);
+  base::Optional<double> creation_date = details.FindDoubleKey("creationDate");
+  base::Optional<double> expiration_date =
+      details.FindDoubleKey("expirationDate");
+  base::Optional<double> last_access_date =
+      details.FindDoubleKey("lastAccessDate");
+
+  base::Time creation_time = creation_date
+                                 ? base::Time::FromDoubleT(*creation_date)
+                                 : base::Time::UnixEpoch();
+  base::Time expiration_time = expiration_date
+                                   ? base::Time::FromDoubleT(*expiration_date)
+                                   : base::Time::UnixEpoch();
+  base::Time last_access_time = last_access_date
+                                    ? base::Time::FromDoubleT(*last_access_date)
+                                    : base::Time::UnixEpoch();
+
+  GURL url(url_string ? *url_string : "");
+  if (!url.is_valid()) {
+    *error =
+        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
+            net::CanonicalCookie::CookieInclusionStatus::
+                EXCLUDE_INVALID_DOMAIN));
+    return nullptr;
+  }
+
+  if (!name || name->empty()) {
+    *error =
+        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
+            net::CanonicalCookie::CookieInclusionStatus::
+                EXCLUDE_FAILURE_TO_STORE));
+    return nullptr;
+  }
+
+  auto canonical_cookie = net::CanonicalCookie::CreateSanitizedCookie(
+      url, *name, value ? *value : "", domain ? *domain : "", path ? *path : "",
+      creation_time, expiration_time, last_access_time, secure, http_only,
+      net::CookieSameSite::NO_RESTRICTION, net::COOKIE_PRIORITY_DEFAULT);
+  if (!canonical_cookie || !canonical_cookie->IsCanonical()) {
+    *error =
+        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
+            net::CanonicalCookie::CookieInclusionStatus::
+                EXCLUDE_FAILURE_TO_STORE));
+    return nullptr;
+  }
+
+  *scheme = url.scheme();
+  if (http_only)
+    options->set_include_httponly();
+  return canonical_cookie;
+}
+
+// Settles the promise of a setMany() or removeMany() call once all of its
+// cookie manager calls have completed, rejecting it with the first error.
+class CookieBatch : public base::RefCounted<CookieBatch> {
+ public:
+  CookieBatch(gin_helper::Promise<void> promise, size_t pending)
+      : promise_(std::move(promise)), pending_(pending) {
+    if (pending_ == 0)
+      promise_.Resolve();
+  }
+
+  void OnSetCookie(net::CanonicalCookie::CookieInclusionStatus status) {
+    if (!status.IsInclude() && error_.empty())
+      error_ = InclusionStatusToString(status);
+    OnDone();
+  }
+
+  void OnDeleteCookies(uint32_t num_deleted) { OnDone(); }
+
+ private:
+  friend class base::RefCounted<CookieBatch>;
+  ~CookieBatch() = default;
+
+  void OnDone() {
+    if (--pending_ > 0)
+      return;
+    if (error_.empty())
+      promise_.Resolve();
+    else
+      promise_.RejectWithErrorMessage(error_);
+  }
+
+  gin_helper::Promise<void> promise_;
+  size_t pending_;
+  std::string error_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieBatch);
+};
+
+// Merges the cookies of several URLs for getAllForUrls(), a cookie matching
+// more than one of the URLs is only reported once.
+class CookieListCollector : public base::RefCounted<CookieListCollector> {
+ public:
+  CookieListCollector(gin_helper::Promise<net::CookieList> promise,
+                      size_t pending)
+      : promise_(std::move(promise)), pending_(pending) {
+    if (pending_ == 0)
+      promise_.Resolve(cookies_);
+  }
+
+  void OnCookieList(const net::CookieStatusList& list,
+                    const net::CookieStatusList& excluded_list) {
+    for (const auto& cookie : net::cookie_util::StripStatuses(list)) {
+      if (seen_.emplace(cookie.Name(), cookie.Domain(), cookie.Path()).second)
+        cookies_.push_back(cookie);
+    }
+    if (--pending_ == 0)
+      promise_.Resolve(cookies_);
+  }
+
+ private:
+  friend class base::RefCounted<CookieListCollector>;
+  ~CookieListCollector() = default;
+
+  gin_helper::Promise<net::CookieList> promise_;
+  size_t pending_;
+  net::CookieList cookies_;
+  // (name, domain, path) of the cookies already in |cookies_|.
+  std::set<std::tuple<std::string, std::string, std::string>> seen_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieListCollector);
+};
+
 }  // namespace
 
 Cookies::Cookies(v8::Isolate* isolate, AtomBrowserContext* browser_context)
@@ -175,13 +319,17 @@ Cookies::Cookies(v8::Isolate* isolate, AtomBrowserContext* browser_context)
 
 Cookies::~Cookies() = default;
 
+network::mojom::CookieManager* Cookies::GetCookieManager() {
+  auto* storage_partition = content::BrowserContext::GetDefaultStoragePartition(
+      browser_context_.get());
+  return storage_partition->GetCookieManagerForBrowserProcess();
+}
+
 v8::Local<v8::Promise> Cookies::Get(const gin_helper::Dictionary& filter) {
   gin_helper::Promise<net::CookieList> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
-  auto* storage_partition = content::BrowserContext::GetDefaultStoragePartition(
-      browser_context_.get());
-  auto* manager = storage_partition->GetCookieManagerForBrowserProcess();
+  auto* manager = GetCookieManager();
 
   base::DictionaryValue dict;
   gin::ConvertFromV8(isolate(), filter.GetHandle(), &dict);
@@ -215,9 +363,7 @@ v8::Local<v8::Promise> Cookies::Remove(const GURL& url,
   cookie_deletion_filter->url = url;
   cookie_deletion_filter->cookie_name = name;
 
-  auto* storage_partition = content::BrowserContext::GetDefaultStoragePartition(
-      browser_context_.get());
-  auto* manager = storage_partition->GetCookieManagerForBrowserProcess();
+  auto* manager = GetCookieManager();
 
   manager->DeleteCookies(
       std::move(cookie_deletion_filter),
@@ -234,67 +380,18 @@ v8::Local<v8::Promise> Cookies::Set(base::DictionaryValue details) {
   gin_helper::Promise<void> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
-  const std::string* url_string = details.FindStringKey("url");
-  const std::string* name = details.FindStringKey("name");
-  const std::string* value = details.FindStringKey("value");
-  const std::string* domain = details.FindStringKey("domain");
-  const std::string* path = details.FindStringKey("path");
-  bool secure = details.FindBoolKey("secure").value_or(false);
-  bool http_only = details.FindBoolKey("httpOnly").value_or(false);
-  base::Optional<double> creation_date = details.FindDoubleKey("creationDate");
-  base::Optional<double> expiration_date =
-      details.FindDoubleKey("expirationDate");
-  base::Optional<double> last_access_date =
-      details.FindDoubleKey("lastAccessDate");
-
-  base::Time creation_time = creation_date
-                                 ? base::Time::FromDoubleT(*creation_date)
-                                 : base::Time::UnixEpoch();
-  base::Time expiration_time = expiration_date
-                                   ? base::Time::FromDoubleT(*expiration_date)
-                                   : base::Time::UnixEpoch();
-  base::Time last_access_time = last_access_date
-                                    ? base::Time::FromDoubleT(*last_access_date)
-                                    : base::Time::UnixEpoch();
-
-  GURL url(url_string ? *url_string : "");
-  if (!url.is_valid()) {
-    promise.RejectWithErrorMessage(
-        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
-            net::CanonicalCookie::CookieInclusionStatus::
-                EXCLUDE_INVALID_DOMAIN)));
-    return handle;
-  }
-
-  if (!name || name->empty()) {
-    promise.RejectWithErrorMessage(
-        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
-            net::CanonicalCookie::CookieInclusionStatus::
-                EXCLUDE_FAILURE_TO_STORE)));
-    return handle;
-  }
-
-  auto canonical_cookie = net::CanonicalCookie::CreateSanitizedCookie(
-      url, *name, value ? *value : "", domain ? *domain : "", path ? *path : "",
-      creation_time, expiration_time, last_access_time, secure, http_only,
-      net::CookieSameSite::NO_RESTRICTION, net::COOKIE_PRIORITY_DEFAULT);
-  if (!canonical_cookie || !canonical_cookie->IsCanonical()) {
-    promise.RejectWithErrorMessage(
-        InclusionStatusToString(net::CanonicalCookie::CookieInclusionStatus(
-            net::CanonicalCookie::CookieInclusionStatus::
-                EXCLUDE_FAILURE_TO_STORE)));
-    return handle;
-  }
+  std::string scheme;
   net::CookieOptions options;
-  if (http_only) {
-    options.set_include_httponly();
+  std::string error;
+  std::unique_ptr<net::CanonicalCookie> canonical_cookie =
+      CreateCookieFromDetails(details, &scheme, &options, &error);
+  if (!canonical_cookie) {
+    promise.RejectWithErrorMessage(error);
+    return handle;
   }
 
-  auto* storage_partition = content::BrowserContext::GetDefaultStoragePartition(
-      browser_context_.get());
-  auto* manager = storage_partition->GetCookieManagerForBrowserProcess();
-  manager->SetCanonicalCookie(
-      *canonical_cookie, url.scheme(), options,
+  GetCookieManager()->SetCanonicalCookie(
+      *canonical_cookie, scheme, options,
       base::BindOnce(
           [](gin_helper::Promise<void> promise,
              net::CanonicalCookie::CookieInclusionStatus status) {
@@ -309,13 +406,104 @@ v8::Local<v8::Promise> Cookies::Set(base::DictionaryValue details) {
   return handle;
 }
 
+v8::Local<v8::Promise> Cookies::SetMany(const base::ListValue& list) {
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // Invalid cookies fail the whole batch before anything is written.
+  std::vector<std::unique_ptr<net::CanonicalCookie>> cookies;
+  std::vector<std::pair<std::string, net::CookieOptions>> options;
+  for (const base::Value& details : list.GetList()) {
+    std::string scheme;
+    net::CookieOptions cookie_options;
+    std::string error;
+    std::unique_ptr<net::CanonicalCookie> cookie =
+        details.is_dict() ? CreateCookieFromDetails(details, &scheme,
+                                                    &cookie_options, &error)
+                          : nullptr;
+    if (!cookie) {
+      promise.RejectWithErrorMessage(error.empty() ? "Invalid cookie details"
+                                                   : error);
+      return handle;
+    }
+    cookies.push_back(std::move(cookie));
+    options.emplace_back(scheme, cookie_options);
+  }
+
+  auto batch =
+      base::MakeRefCounted<CookieBatch>(std::move(promise), cookies.size());
+  // The calls are queued on the cookie manager pipe back to back, so the
+  // network service handles them without waiting for each other.
+  auto* manager = GetCookieManager();
+  for (size_t i = 0; i < cookies.size(); ++i) {
+    manager->SetCanonicalCookie(
+        *cookies[i], options[i].first, options[i].second,
+        base::BindOnce(&CookieBatch::OnSetCookie, batch));
+  }
+
+  return handle;
+}
+
+v8::Local<v8::Promise> Cookies::RemoveMany(const base::ListValue& list) {
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  std::vector<network::mojom::CookieDeletionFilterPtr> filters;
+  for (const base::Value& item : list.GetList()) {
+    const std::string* url = item.is_dict() ? item.FindStringKey("url")
+                                            : nullptr;
+    const std::string* name = item.is_dict() ? item.FindStringKey("name")
+                                             : nullptr;
+    if (!url || !name || !GURL(*url).is_valid()) {
+      promise.RejectWithErrorMessage(
+          "Each cookie must have a valid url and a name");
+      return handle;
+    }
+    auto filter = network::mojom::CookieDeletionFilter::New();
+    filter->url = GURL(*url);
+    filter->cookie_name = *name;
+    filters.push_back(std::move(filter));
+  }
+
+  auto batch =
+      base::MakeRefCounted<CookieBatch>(std::move(promise), filters.size());
+  auto* manager = GetCookieManager();
+  for (auto& filter : filters) {
+    manager->DeleteCookies(std::move(filter),
+                           base::BindOnce(&CookieBatch::OnDeleteCookies,
+                                          batch));
+  }
+
+  return handle;
+}
+
+v8::Local<v8::Promise> Cookies::GetAllForUrls(const std::vector<GURL>& urls) {
+  gin_helper::Promise<net::CookieList> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  net::CookieOptions options;
+  options.set_include_httponly();
+  options.set_same_site_cookie_context(
+      net::CookieOptions::SameSiteCookieContext::SAME_SITE_STRICT);
+  options.set_do_not_update_access_time();
+
+  auto collector = base::MakeRefCounted<CookieListCollector>(
+      std::move(promise), urls.size());
+  auto* manager = GetCookieManager();
+  for (const GURL& url : urls) {
+    manager->GetCookieList(
+        url, options,
+        base::BindOnce(&CookieListCollector::OnCookieList, collector));
+  }
+
+  return handle;
+}
+
 v8::Local<v8::Promise> Cookies::FlushStore() {
   gin_helper::Promise<void> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
-  auto* storage_partition = content::BrowserContext::GetDefaultStoragePartition(
-      browser_context_.get());
-  auto* manager = storage_partition->GetCookieManagerForBrowserProcess();
+  auto* manager = GetCookieManager();
 
   manager->FlushCookieStore(base::BindOnce(
       gin_helper::Promise<void>::ResolvePromise, std::move(promise)));
@@ -323,11 +511,47 @@ v8::Local<v8::Promise> Cookies::FlushStore() {
   return handle;
 }
 
+void Cookies::SetChangeBatchInterval(int interval) {
+  FlushPendingChanges();
+  change_batch_interval_ =
+      base::TimeDelta::FromMilliseconds(std::max(interval, 0));
+}
+
 void Cookies::OnCookieChanged(const net::CookieChangeInfo& change) {
-  Emit("changed", gin::ConvertToV8(isolate(), change.cookie),
-       gin::ConvertToV8(isolate(), change.cause),
-       gin::ConvertToV8(isolate(),
-                        change.cause != net::CookieChangeCause::INSERTED));
+  if (change_batch_interval_.is_zero()) {
+    Emit("changed", gin::ConvertToV8(isolate(), change.cookie),
+         gin::ConvertToV8(isolate(), change.cause),
+         gin::ConvertToV8(isolate(),
+                          change.cause != net::CookieChangeCause::INSERTED));
+    return;
+  }
+
+  pending_changes_[change.cookie.Domain()].push_back(change);
+  if (!change_batch_timer_.IsRunning())
+    change_batch_timer_.Start(FROM_HERE, change_batch_interval_, this,
+                              &Cookies::FlushPendingChanges);
+}
+
+void Cookies::FlushPendingChanges() {
+  change_batch_timer_.Stop();
+  if (pending_changes_.empty())
+    return;
+
+  v8::HandleScope handle_scope(isolate());
+  std::map<std::string, std::vector<net::CookieChangeInfo>> changes;
+  changes.swap(pending_changes_);
+  for (const auto& it : changes) {
+    std::vector<v8::Local<v8::Value>> list;
+    list.reserve(it.second.size());
+    for (const net::CookieChangeInfo& change : it.second) {
+      gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate());
+      dict.Set("cookie", change.cookie);
+      dict.Set("cause", change.cause);
+      dict.Set("removed", change.cause != net::CookieChangeCause::INSERTED);
+      list.push_back(gin::ConvertToV8(isolate(), dict));
+    }
+    Emit("changed-batch", it.first, list);
+  }
 }
 
 // static
@@ -344,6 +568,10 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("getAllForUrls", &Cookies::GetAllForUrls)
+      .SetMethod("setChangeBatchInterval", &Cookies::SetChangeBatchInterval)
       .SetMethod("flushStore", &Cookies::FlushStore);
 }
 
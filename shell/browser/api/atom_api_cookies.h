@@ -5,18 +5,24 @@
 #ifndef SHELL_BROWSER_API_ATOM_API_COOKIES_H_
 #define SHELL_BROWSER_API_ATOM_API_COOKIES_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "gin/handle.h"
 #include "net/cookies/canonical_cookie.h"
 #include "net/cookies/cookie_change_dispatcher.h"
+#include "services/network/public/mojom/cookie_manager.mojom.h"
 #include "shell/common/gin_helper/promise.h"
 #include "shell/common/gin_helper/trackable_object.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace gin_helper {
@@ -51,15 +57,34 @@ class Cookies : public gin_helper::TrackableObject<Cookies> {
   v8::Local<v8::Promise> Remove(const GURL& url, const std::string& name);
   v8::Local<v8::Promise> FlushStore();
 
+  // Batched versions of set(), remove() and get(), which issue all their
+  // cookie manager calls at once and settle a single promise.
+  v8::Local<v8::Promise> SetMany(const base::ListValue& list);
+  v8::Local<v8::Promise> RemoveMany(const base::ListValue& list);
+  v8::Local<v8::Promise> GetAllForUrls(const std::vector<GURL>& urls);
+
+  // When |interval| is positive, changes are collected per domain and
+  // emitted as one "changed-batch" event each |interval| milliseconds,
+  // instead of one "changed" event per change.
+  void SetChangeBatchInterval(int interval);
+
   // CookieChangeNotifier subscription:
   void OnCookieChanged(const net::CookieChangeInfo& change);
 
  private:
+  network::mojom::CookieManager* GetCookieManager();
+  void FlushPendingChanges();
+
   std::unique_ptr<base::CallbackList<void(
       const net::CookieChangeInfo& change)>::Subscription>
       cookie_change_subscription_;
   scoped_refptr<AtomBrowserContext> browser_context_;
 
+  base::TimeDelta change_batch_interval_;
+  base::OneShotTimer change_batch_timer_;
+  // Domain => changes not emitted yet.
+  std::map<std::string, std::vector<net::CookieChangeInfo>> pending_changes_;
+
   DISALLOW_COPY_AND_ASSIGN(Cookies);
 };
 
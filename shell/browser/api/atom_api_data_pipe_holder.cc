@@ -4,6 +4,8 @@
 
 #include "shell/browser/api/atom_api_data_pipe_holder.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -33,9 +35,13 @@ KeyWeakMap<std::string> g_weak_map;
 class DataPipeReader {
  public:
   DataPipeReader(gin_helper::Promise<v8::Local<v8::Value>> promise,
-                 mojo::Remote<network::mojom::DataPipeGetter> data_pipe_getter)
+                 mojo::Remote<network::mojom::DataPipeGetter> data_pipe_getter,
+                 uint64_t offset,
+                 uint64_t length)
       : promise_(std::move(promise)),
         data_pipe_getter_(std::move(data_pipe_getter)),
+        offset_(offset),
+        length_(length),
         handle_watcher_(FROM_HERE,
                         mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                         base::SequencedTaskRunnerHandle::Get()) {
@@ -59,10 +65,15 @@ class DataPipeReader {
       OnFailure();
       return;
     }
-    buffer_.resize(size);
-    head_ = &buffer_.front();
-    remaining_size_ = size;
-    handle_watcher_.ArmOrNotify();
+    // Only keep the requested range, the bytes before it are discarded.
+    skip_size_ = std::min(offset_, size);
+    remaining_size_ = std::min(length_, size - skip_size_);
+    buffer_.resize(remaining_size_);
+    head_ = buffer_.data();
+    if (remaining_size_ == 0)
+      OnSuccess();
+    else
+      handle_watcher_.ArmOrNotify();
   }
 
   // Called by |handle_watcher_| when data is available or the pipe was closed,
@@ -74,13 +85,28 @@ class DataPipeReader {
     }
 
     // Read.
-    uint32_t length = remaining_size_;
-    result = data_pipe_->ReadData(head_, &length, MOJO_READ_DATA_FLAG_NONE);
+    uint32_t length;
+    if (skip_size_ > 0) {
+      length = std::min<uint64_t>(skip_size_,
+                                  std::numeric_limits<uint32_t>::max());
+      result =
+          data_pipe_->ReadData(nullptr, &length, MOJO_READ_DATA_FLAG_DISCARD);
+    } else {
+      length = std::min<uint64_t>(remaining_size_,
+                                  std::numeric_limits<uint32_t>::max());
+      result = data_pipe_->ReadData(head_, &length, MOJO_READ_DATA_FLAG_NONE);
+    }
     if (result == MOJO_RESULT_OK) {  // success
-      remaining_size_ -= length;
-      head_ += length;
+      if (skip_size_ > 0) {
+        skip_size_ -= length;
+      } else {
+        remaining_size_ -= length;
+        head_ += length;
+      }
       if (remaining_size_ == 0)
         OnSuccess();
+      else
+        handle_watcher_.ArmOrNotify();
     } else if (result == MOJO_RESULT_SHOULD_WAIT) {  // IO pending
       handle_watcher_.ArmOrNotify();
     } else {  // error
@@ -94,22 +120,29 @@ class DataPipeReader {
   }
 
   void OnSuccess() {
+    // Destroy data pipe, the unread rest of the data is not needed.
+    handle_watcher_.Cancel();
+    data_pipe_.reset();
+    data_pipe_getter_.reset();
+
     // Pass the buffer to JS.
     //
     // Note that the lifetime of the native buffer belongs to us, and we will
     // free memory when JS buffer gets garbage collected.
     v8::Locker locker(promise_.isolate());
     v8::HandleScope handle_scope(promise_.isolate());
+    if (buffer_.empty()) {
+      promise_.Resolve(
+          node::Buffer::New(promise_.isolate(), 0).ToLocalChecked());
+      delete this;
+      return;
+    }
+
     v8::Local<v8::Value> buffer =
-        node::Buffer::New(promise_.isolate(), &buffer_.front(), buffer_.size(),
+        node::Buffer::New(promise_.isolate(), buffer_.data(), buffer_.size(),
                           &DataPipeReader::FreeBuffer, this)
             .ToLocalChecked();
     promise_.Resolve(buffer);
-
-    // Destroy data pipe.
-    handle_watcher_.Cancel();
-    data_pipe_.reset();
-    data_pipe_getter_.reset();
   }
 
   static void FreeBuffer(char* data, void* self) {
@@ -125,9 +158,16 @@ class DataPipeReader {
   // Stores read data.
   std::vector<char> buffer_;
 
+  // The requested range.
+  uint64_t offset_;
+  uint64_t length_;
+
   // The head of buffer.
   char* head_ = nullptr;
 
+  // Data to discard before the requested range.
+  uint64_t skip_size_ = 0;
+
   // Remaining data to read.
   uint64_t remaining_size_ = 0;
 
@@ -155,7 +195,21 @@ v8::Local<v8::Promise> DataPipeHolder::ReadAll(v8::Isolate* isolate) {
     return handle;
   }
 
-  new DataPipeReader(std::move(promise), std::move(data_pipe_));
+  new DataPipeReader(std::move(promise), std::move(data_pipe_), 0,
+                     std::numeric_limits<uint64_t>::max());
+  return handle;
+}
+
+// static
+v8::Local<v8::Promise> DataPipeHolder::ReadRange(
+    v8::Isolate* isolate,
+    mojo::Remote<network::mojom::DataPipeGetter> data_pipe_getter,
+    uint64_t offset,
+    uint64_t length) {
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  new DataPipeReader(std::move(promise), std::move(data_pipe_getter), offset,
+                     length);
   return handle;
 }
 
@@ -34,6 +34,14 @@ class DataPipeHolder : public gin::Wrappable<DataPipeHolder> {
   // no one has complained about it yet.
   v8::Local<v8::Promise> ReadAll(v8::Isolate* isolate);
 
+  // Reads at most |length| bytes starting at |offset| from the data pipe
+  // returned by |data_pipe_getter|, without keeping the rest in memory.
+  static v8::Local<v8::Promise> ReadRange(
+      v8::Isolate* isolate,
+      mojo::Remote<network::mojom::DataPipeGetter> data_pipe_getter,
+      uint64_t offset,
+      uint64_t length);
+
   // The unique ID that can be used to receive the object.
   const std::string& id() const { return id_; }
 
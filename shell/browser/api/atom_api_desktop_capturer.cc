@@ -4,7 +4,9 @@
 
 #include "shell/browser/api/atom_api_desktop_capturer.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -12,10 +14,12 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_restrictions.h"
 #include "chrome/browser/media/webrtc/desktop_media_list.h"
+#include "chrome/browser/media/webrtc/desktop_media_list_base.h"
 #include "chrome/browser/media/webrtc/window_icon_util.h"
 #include "content/public/browser/desktop_capture.h"
 #include "shell/common/api/atom_api_native_image.h"
 #include "shell/common/gin_converters/gfx_converter.h"
+#include "shell/common/gin_converters/image_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
 #include "shell/common/node_includes.h"
@@ -59,6 +63,14 @@ namespace electron {
 
 namespace api {
 
+namespace {
+
+// Every refresh enumerates all sources and captures their thumbnails, so
+// shorter intervals would keep a core busy.
+constexpr int kMinWatchIntervalMs = 250;
+
+}  // namespace
+
 DesktopCapturer::DesktopCapturer(v8::Isolate* isolate) {
   Init(isolate);
 }
@@ -70,15 +82,7 @@ void DesktopCapturer::StartHandling(bool capture_window,
                                     const gfx::Size& thumbnail_size,
                                     bool fetch_window_icons) {
   fetch_window_icons_ = fetch_window_icons;
-#if defined(OS_WIN)
-  if (content::desktop_capture::CreateDesktopCaptureOptions()
-          .allow_directx_capturer()) {
-    // DxgiDuplicatorController should be alive in this scope according to
-    // screen_capturer_win.cc.
-    auto duplicator = webrtc::DxgiDuplicatorController::Instance();
-    using_directx_capturer_ = webrtc::ScreenCapturerWinDirectx::IsSupported();
-  }
-#endif  // defined(OS_WIN)
+  CheckDirectXCapturer();
 
   // clear any existing captured sources.
   captured_sources_.clear();
@@ -91,22 +95,16 @@ void DesktopCapturer::StartHandling(bool capture_window,
     // Initialize the source list.
     // Apply the new thumbnail size and restart capture.
     if (capture_window) {
-      window_capturer_ = std::make_unique<NativeDesktopMediaList>(
-          content::DesktopMediaID::TYPE_WINDOW,
-          content::desktop_capture::CreateWindowCapturer());
-      window_capturer_->SetThumbnailSize(thumbnail_size);
-      window_capturer_->AddObserver(this);
+      window_capturer_ =
+          CreateMediaList(content::DesktopMediaID::TYPE_WINDOW, thumbnail_size);
       window_capturer_->Update(base::BindOnce(
           &DesktopCapturer::UpdateSourcesList, weak_ptr_factory_.GetWeakPtr(),
           window_capturer_.get()));
     }
 
     if (capture_screen) {
-      screen_capturer_ = std::make_unique<NativeDesktopMediaList>(
-          content::DesktopMediaID::TYPE_SCREEN,
-          content::desktop_capture::CreateScreenCapturer());
-      screen_capturer_->SetThumbnailSize(thumbnail_size);
-      screen_capturer_->AddObserver(this);
+      screen_capturer_ =
+          CreateMediaList(content::DesktopMediaID::TYPE_SCREEN, thumbnail_size);
       screen_capturer_->Update(base::BindOnce(
           &DesktopCapturer::UpdateSourcesList, weak_ptr_factory_.GetWeakPtr(),
           screen_capturer_.get()));
@@ -114,10 +112,221 @@ void DesktopCapturer::StartHandling(bool capture_window,
   }
 }
 
+void DesktopCapturer::StartWatching(bool capture_window,
+                                    bool capture_screen,
+                                    const gfx::Size& thumbnail_size,
+                                    bool fetch_window_icons,
+                                    int interval_ms) {
+  StopWatching();
+  fetch_window_icons_ = fetch_window_icons;
+  CheckDirectXCapturer();
+
+  watching_ = true;
+  watch_window_ = capture_window;
+  watch_screen_ = capture_screen;
+  watch_thumbnail_size_ = thumbnail_size;
+  watch_interval_ = base::TimeDelta::FromMilliseconds(
+      std::max(interval_ms, kMinWatchIntervalMs));
+  RefreshWatchedSources();
+}
+
+void DesktopCapturer::StopWatching() {
+  watching_ = false;
+  refresh_timer_.Stop();
+  window_capturer_.reset();
+  screen_capturer_.reset();
+  pending_watched_lists_ = 0;
+  watch_ready_ = false;
+  watched_sources_.clear();
+}
+
+void DesktopCapturer::CheckDirectXCapturer() {
+#if defined(OS_WIN)
+  if (content::desktop_capture::CreateDesktopCaptureOptions()
+          .allow_directx_capturer()) {
+    // DxgiDuplicatorController should be alive in this scope according to
+    // screen_capturer_win.cc.
+    auto duplicator = webrtc::DxgiDuplicatorController::Instance();
+    using_directx_capturer_ = webrtc::ScreenCapturerWinDirectx::IsSupported();
+  }
+#endif  // defined(OS_WIN)
+}
+
+std::unique_ptr<DesktopMediaList> DesktopCapturer::CreateMediaList(
+    content::DesktopMediaID::Type type,
+    const gfx::Size& thumbnail_size) {
+  auto list = std::make_unique<NativeDesktopMediaList>(
+      type, type == content::DesktopMediaID::TYPE_WINDOW
+                ? content::desktop_capture::CreateWindowCapturer()
+                : content::desktop_capture::CreateScreenCapturer());
+  list->SetThumbnailSize(thumbnail_size);
+  list->AddObserver(this);
+  return list;
+}
+
+bool DesktopCapturer::GetDisplayIds(
+    const std::vector<DesktopMediaList::Source>& sources,
+    std::vector<std::string>* display_ids) {
+  display_ids->assign(sources.size(), std::string());
+#if defined(OS_WIN)
+  // Gather the same unique screen IDs used by the electron.screen API in
+  // order to provide an association between it and
+  // desktopCapturer/getUserMedia. This is only required when using the
+  // DirectX capturer, otherwise the IDs across the APIs already match.
+  if (using_directx_capturer_) {
+    std::vector<std::string> device_names;
+    // Crucially, this list of device names will be in the same order as
+    // |sources|.
+    if (!webrtc::DxgiDuplicatorController::Instance()->GetDeviceNames(
+            &device_names)) {
+      return false;
+    }
+
+    for (size_t i = 0; i < sources.size() && i < device_names.size(); ++i) {
+      const auto& device_name = device_names[i];
+      std::wstring wide_device_name;
+      base::UTF8ToWide(device_name.c_str(), device_name.size(),
+                       &wide_device_name);
+      const int64_t device_id =
+          display::win::DisplayInfo::DeviceIdFromDeviceName(
+              wide_device_name.c_str());
+      (*display_ids)[i] = base::NumberToString(device_id);
+    }
+  }
+#elif defined(OS_MACOSX)
+  // On Mac, the IDs across the APIs match.
+  for (size_t i = 0; i < sources.size(); ++i)
+    (*display_ids)[i] = base::NumberToString(sources[i].id.id);
+#endif  // defined(OS_WIN)
+  // TODO(ajmacd): Add Linux support. The IDs across APIs differ but Chrome
+  // only supports capturing the entire desktop on Linux. Revisit this if
+  // individual screen support is added.
+  return true;
+}
+
+void DesktopCapturer::OnSourceAdded(DesktopMediaList* list, int index) {
+  if (!watching_)
+    return;
+  // Every refresh uses a new list, so the sources that were already there
+  // are added again.
+  UpdateWatchedSource(list, index);
+}
+
+void DesktopCapturer::OnSourceNameChanged(DesktopMediaList* list, int index) {
+  if (!watching_)
+    return;
+  UpdateWatchedSource(list, index);
+}
+
+void DesktopCapturer::OnSourceThumbnailChanged(DesktopMediaList* list,
+                                               int index) {
+  if (!watching_)
+    return;
+  const DesktopMediaList::Source& source = list->GetSource(index);
+  auto it = watched_sources_.find(source.id);
+  if (it == watched_sources_.end())
+    return;
+  // The thumbnails of a new list are all new to it, only the ones that
+  // changed since they were last sent are.
+  uint32_t hash =
+      DesktopMediaListBase::GetImageHash(gfx::Image(source.thumbnail));
+  if (it->second.thumbnail_hash == hash)
+    return;
+  it->second.thumbnail_hash = hash;
+  Emit("thumbnail-changed", source.id.ToString(),
+       gfx::Image(source.thumbnail));
+}
+
 void DesktopCapturer::OnSourceUnchanged(DesktopMediaList* list) {
+  // The end of a watched refresh is handled by OnWatchedListUpdated.
+  if (watching_)
+    return;
   UpdateSourcesList(list);
 }
 
+void DesktopCapturer::RefreshWatchedSources() {
+  pending_watched_lists_ = 0;
+  if (watch_window_) {
+    window_capturer_ = CreateMediaList(content::DesktopMediaID::TYPE_WINDOW,
+                                       watch_thumbnail_size_);
+    ++pending_watched_lists_;
+    window_capturer_->Update(base::BindOnce(
+        &DesktopCapturer::OnWatchedListUpdated, weak_ptr_factory_.GetWeakPtr(),
+        window_capturer_.get()));
+  }
+  if (watch_screen_) {
+    screen_capturer_ = CreateMediaList(content::DesktopMediaID::TYPE_SCREEN,
+                                       watch_thumbnail_size_);
+    ++pending_watched_lists_;
+    screen_capturer_->Update(base::BindOnce(
+        &DesktopCapturer::OnWatchedListUpdated, weak_ptr_factory_.GetWeakPtr(),
+        screen_capturer_.get()));
+  }
+}
+
+void DesktopCapturer::OnWatchedListUpdated(DesktopMediaList* list) {
+  if (!watching_)
+    return;
+
+  // The sources of this type the refresh did not find are gone.
+  const content::DesktopMediaID::Type type = list->GetMediaListType();
+  std::set<content::DesktopMediaID> found;
+  for (const auto& source : list->GetSources())
+    found.insert(source.id);
+  for (auto it = watched_sources_.begin(); it != watched_sources_.end();) {
+    if (it->first.type == type && !found.count(it->first)) {
+      Emit("source-removed", it->first.ToString());
+      it = watched_sources_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (--pending_watched_lists_ > 0)
+    return;
+  if (!watch_ready_) {
+    watch_ready_ = true;
+    Emit("ready");
+  }
+  refresh_timer_.Start(FROM_HERE, watch_interval_,
+                       base::BindOnce(&DesktopCapturer::RefreshWatchedSources,
+                                      base::Unretained(this)));
+}
+
+void DesktopCapturer::UpdateWatchedSource(DesktopMediaList* list, int index) {
+  const DesktopMediaList::Source& media_list_source = list->GetSource(index);
+  auto it = watched_sources_.find(media_list_source.id);
+  if (it != watched_sources_.end()) {
+    if (it->second.name != media_list_source.name) {
+      it->second.name = media_list_source.name;
+      Emit("source-name-changed", media_list_source.id.ToString(),
+           base::UTF16ToUTF8(media_list_source.name));
+    }
+    return;
+  }
+
+  DesktopCapturer::Source source{media_list_source, std::string()};
+  if (list->GetMediaListType() == content::DesktopMediaID::TYPE_SCREEN) {
+    // A new list adds its sources in order, so the ones before |index| are
+    // already in it.
+    std::vector<std::string> display_ids;
+    if (GetDisplayIds(list->GetSources(), &display_ids) &&
+        static_cast<size_t>(index) < display_ids.size()) {
+      source.display_id = display_ids[index];
+    }
+  } else {
+    // The icon is only fetched once, when the window is first seen.
+    source.fetch_icon = fetch_window_icons_;
+  }
+
+  WatchedSource& watched = watched_sources_[media_list_source.id];
+  watched.name = media_list_source.name;
+  // The thumbnail is captured after the source is added, and sent with
+  // thumbnail-changed.
+  source.media_list_source.thumbnail = gfx::ImageSkia();
+  Emit("source-added", source);
+}
+
 void DesktopCapturer::UpdateSourcesList(DesktopMediaList* list) {
   if (capture_window_ &&
       list->GetMediaListType() == content::DesktopMediaID::TYPE_WINDOW) {
@@ -137,48 +346,17 @@ void DesktopCapturer::UpdateSourcesList(DesktopMediaList* list) {
       list->GetMediaListType() == content::DesktopMediaID::TYPE_SCREEN) {
     capture_screen_ = false;
     const auto& media_list_sources = list->GetSources();
+    std::vector<std::string> display_ids;
+    if (!GetDisplayIds(media_list_sources, &display_ids)) {
+      Emit("error", "Failed to get sources.");
+      return;
+    }
     std::vector<DesktopCapturer::Source> screen_sources;
     screen_sources.reserve(media_list_sources.size());
-    for (const auto& media_list_source : media_list_sources) {
+    for (size_t i = 0; i < media_list_sources.size(); ++i) {
       screen_sources.emplace_back(
-          DesktopCapturer::Source{media_list_source, std::string()});
+          DesktopCapturer::Source{media_list_sources[i], display_ids[i]});
     }
-#if defined(OS_WIN)
-    // Gather the same unique screen IDs used by the electron.screen API in
-    // order to provide an association between it and
-    // desktopCapturer/getUserMedia. This is only required when using the
-    // DirectX capturer, otherwise the IDs across the APIs already match.
-    if (using_directx_capturer_) {
-      std::vector<std::string> device_names;
-      // Crucially, this list of device names will be in the same order as
-      // |media_list_sources|.
-      if (!webrtc::DxgiDuplicatorController::Instance()->GetDeviceNames(
-              &device_names)) {
-        Emit("error", "Failed to get sources.");
-        return;
-      }
-
-      int device_name_index = 0;
-      for (auto& source : screen_sources) {
-        const auto& device_name = device_names[device_name_index++];
-        std::wstring wide_device_name;
-        base::UTF8ToWide(device_name.c_str(), device_name.size(),
-                         &wide_device_name);
-        const int64_t device_id =
-            display::win::DisplayInfo::DeviceIdFromDeviceName(
-                wide_device_name.c_str());
-        source.display_id = base::NumberToString(device_id);
-      }
-    }
-#elif defined(OS_MACOSX)
-    // On Mac, the IDs across the APIs match.
-    for (auto& source : screen_sources) {
-      source.display_id = base::NumberToString(source.media_list_source.id.id);
-    }
-#endif  // defined(OS_WIN)
-    // TODO(ajmacd): Add Linux support. The IDs across APIs differ but Chrome
-    // only supports capturing the entire desktop on Linux. Revisit this if
-    // individual screen support is added.
     std::move(screen_sources.begin(), screen_sources.end(),
               std::back_inserter(captured_sources_));
   }
@@ -198,7 +376,9 @@ void DesktopCapturer::BuildPrototype(
     v8::Local<v8::FunctionTemplate> prototype) {
   prototype->SetClassName(gin::StringToV8(isolate, "DesktopCapturer"));
   gin_helper::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
-      .SetMethod("startHandling", &DesktopCapturer::StartHandling);
+      .SetMethod("startHandling", &DesktopCapturer::StartHandling)
+      .SetMethod("startWatching", &DesktopCapturer::StartWatching)
+      .SetMethod("stopWatching", &DesktopCapturer::StopWatching);
 }
 
 }  // namespace api
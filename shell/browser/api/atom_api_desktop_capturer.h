@@ -5,10 +5,13 @@
 #ifndef SHELL_BROWSER_API_ATOM_API_DESKTOP_CAPTURER_H_
 #define SHELL_BROWSER_API_ATOM_API_DESKTOP_CAPTURER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "base/optional.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/media/webrtc/desktop_media_list_observer.h"
 #include "chrome/browser/media/webrtc/native_desktop_media_list.h"
 #include "gin/handle.h"
@@ -40,29 +43,73 @@ class DesktopCapturer : public gin_helper::TrackableObject<DesktopCapturer>,
                      const gfx::Size& thumbnail_size,
                      bool fetch_window_icons);
 
+  // Keeps the sources up to date, refreshing them every |interval_ms|, or
+  // every 250 ms if it is shorter.
+  //
+  // The sources are emitted one by one as they are found, and afterwards only
+  // the changes are: added and removed sources, new names and thumbnails that
+  // differ from the last ones sent.
+  void StartWatching(bool capture_window,
+                     bool capture_screen,
+                     const gfx::Size& thumbnail_size,
+                     bool fetch_window_icons,
+                     int interval_ms);
+  void StopWatching();
+
  protected:
   explicit DesktopCapturer(v8::Isolate* isolate);
   ~DesktopCapturer() override;
 
   // DesktopMediaListObserver:
-  void OnSourceAdded(DesktopMediaList* list, int index) override {}
+  void OnSourceAdded(DesktopMediaList* list, int index) override;
   void OnSourceRemoved(DesktopMediaList* list, int index) override {}
   void OnSourceMoved(DesktopMediaList* list,
                      int old_index,
                      int new_index) override {}
-  void OnSourceNameChanged(DesktopMediaList* list, int index) override {}
-  void OnSourceThumbnailChanged(DesktopMediaList* list, int index) override {}
+  void OnSourceNameChanged(DesktopMediaList* list, int index) override;
+  void OnSourceThumbnailChanged(DesktopMediaList* list, int index) override;
   void OnSourceUnchanged(DesktopMediaList* list) override;
 
  private:
+  // The last state of a watched source that was emitted.
+  struct WatchedSource {
+    base::string16 name;
+    // Not set until a thumbnail was sent.
+    base::Optional<uint32_t> thumbnail_hash;
+  };
+
+  void CheckDirectXCapturer();
+  std::unique_ptr<DesktopMediaList> CreateMediaList(
+      content::DesktopMediaID::Type type,
+      const gfx::Size& thumbnail_size);
+  // Fills |display_ids| with the ids the electron.screen API uses for the
+  // screens in |sources|, or empty strings where they are not known.
+  bool GetDisplayIds(const std::vector<DesktopMediaList::Source>& sources,
+                     std::vector<std::string>* display_ids);
   void UpdateSourcesList(DesktopMediaList* list);
 
+  void RefreshWatchedSources();
+  void OnWatchedListUpdated(DesktopMediaList* list);
+  void UpdateWatchedSource(DesktopMediaList* list, int index);
+
   std::unique_ptr<DesktopMediaList> window_capturer_;
   std::unique_ptr<DesktopMediaList> screen_capturer_;
   std::vector<DesktopCapturer::Source> captured_sources_;
   bool capture_window_ = false;
   bool capture_screen_ = false;
   bool fetch_window_icons_ = false;
+
+  // Set while watching. The lists are replaced on every refresh, the
+  // capturers they own are released once they have run.
+  bool watching_ = false;
+  bool watch_window_ = false;
+  bool watch_screen_ = false;
+  gfx::Size watch_thumbnail_size_;
+  base::TimeDelta watch_interval_;
+  int pending_watched_lists_ = 0;
+  bool watch_ready_ = false;
+  std::map<content::DesktopMediaID, WatchedSource> watched_sources_;
+  base::OneShotTimer refresh_timer_;
 #if defined(OS_WIN)
   bool using_directx_capturer_ = false;
 #endif  // defined(OS_WIN)
@@ -4,13 +4,16 @@
 
 #include "shell/browser/api/atom_api_net_log.h"
 
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "chrome/browser/browser_process.h"
 #include "components/net_log/chrome_net_log.h"
 #include "content/public/browser/storage_partition.h"
 #include "electron/electron_version.h"
+#include "extensions/common/url_pattern.h"
 #include "shell/browser/atom_browser_context.h"
 #include "shell/browser/net/system_network_context_manager.h"
 #include "shell/common/gin_converters/file_path_converter.h"
@@ -62,6 +65,14 @@ base::File OpenFileForWriting(base::FilePath path) {
                     base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
 }
 
+base::Value GetCustomConstants() {
+  auto command_line_string =
+      base::CommandLine::ForCurrentProcess()->GetCommandLineString();
+  auto channel_string = std::string("Electron " ELECTRON_VERSION);
+  return base::Value::FromUniquePtrValue(net_log::GetPlatformConstantsForNetLog(
+      command_line_string, channel_string));
+}
+
 void ResolvePromiseWithNetError(gin_helper::Promise<void> promise,
                                 int32_t error) {
   if (error == net::OK) {
@@ -122,12 +133,7 @@ v8::Local<v8::Promise> NetLog::StartLogging(base::FilePath log_path,
       base::make_optional<gin_helper::Promise<void>>(isolate());
   v8::Local<v8::Promise> handle = pending_start_promise_->GetHandle();
 
-  auto command_line_string =
-      base::CommandLine::ForCurrentProcess()->GetCommandLineString();
-  auto channel_string = std::string("Electron " ELECTRON_VERSION);
-  base::Value custom_constants =
-      base::Value::FromUniquePtrValue(net_log::GetPlatformConstantsForNetLog(
-          command_line_string, channel_string));
+  base::Value custom_constants = GetCustomConstants();
 
   auto* network_context =
       content::BrowserContext::GetDefaultStoragePartition(browser_context_)
@@ -211,6 +217,124 @@ v8::Local<v8::Promise> NetLog::StopLogging(gin_helper::Arguments* args) {
   return handle;
 }
 
+void NetLog::StartRingBuffer(gin_helper::Arguments* args) {
+  NetLogRingBuffer::Options options;
+  gin_helper::Dictionary dict;
+  if (args->GetNext(&dict)) {
+    v8::Local<v8::Value> capture_mode_v8;
+    if (dict.Get("captureMode", &capture_mode_v8) &&
+        !gin::ConvertFromV8(args->isolate(), capture_mode_v8,
+                            &options.capture_mode)) {
+      args->ThrowError("Invalid value for captureMode");
+      return;
+    }
+    double duration;
+    if (dict.Get("duration", &duration)) {
+      if (duration <= 0) {
+        args->ThrowError("duration must be positive");
+        return;
+      }
+      options.duration = base::TimeDelta::FromSecondsD(duration);
+    }
+    std::vector<std::string> event_types;
+    if (dict.Get("eventTypes", &event_types))
+      options.event_types.insert(event_types.begin(), event_types.end());
+    std::vector<std::string> urls;
+    if (dict.Get("urls", &urls)) {
+      for (const std::string& url : urls) {
+        URLPattern pattern(URLPattern::SCHEME_ALL);
+        if (pattern.Parse(url) != URLPattern::ParseResult::kSuccess) {
+          args->ThrowError("Invalid url pattern " + url);
+          return;
+        }
+        options.url_patterns.insert(pattern);
+      }
+    }
+  }
+
+  if (ring_buffer_) {
+    args->ThrowError("There is already a ring buffer running");
+    return;
+  }
+
+  ring_buffer_ = std::make_unique<NetLogRingBuffer>(
+      browser_context_, options, GetCustomConstants(), file_task_runner_);
+  ring_buffer_->Start();
+}
+
+v8::Local<v8::Promise> NetLog::StopRingBuffer() {
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  if (ring_buffer_) {
+    NetLogRingBuffer* ring_buffer = ring_buffer_.get();
+    // The ring buffer is kept alive until its log stops being written.
+    ring_buffer->Stop(base::BindOnce(
+        [](std::unique_ptr<NetLogRingBuffer>,
+           gin_helper::Promise<void> promise) { promise.Resolve(); },
+        std::move(ring_buffer_), std::move(promise)));
+  } else {
+    promise.RejectWithErrorMessage("No ring buffer in progress");
+  }
+
+  return handle;
+}
+
+v8::Local<v8::Promise> NetLog::Snapshot(base::FilePath path,
+                                        gin_helper::Arguments* args) {
+  if (path.empty()) {
+    args->ThrowError("The first parameter must be a valid string");
+    return v8::Local<v8::Promise>();
+  }
+
+  base::TimeDelta window = base::TimeDelta::Max();
+  auto format = NetLogRingBuffer::Format::kJson;
+  gin_helper::Dictionary dict;
+  if (args->GetNext(&dict)) {
+    double seconds;
+    if (dict.Get("seconds", &seconds)) {
+      if (seconds <= 0) {
+        args->ThrowError("seconds must be positive");
+        return v8::Local<v8::Promise>();
+      }
+      window = base::TimeDelta::FromSecondsD(seconds);
+    }
+    std::string format_string;
+    if (dict.Get("format", &format_string)) {
+      if (format_string == "binary") {
+        format = NetLogRingBuffer::Format::kBinary;
+      } else if (format_string != "json") {
+        args->ThrowError("Invalid value for format");
+        return v8::Local<v8::Promise>();
+      }
+    }
+  }
+
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  if (ring_buffer_) {
+    ring_buffer_->Snapshot(
+        path, window, format,
+        base::BindOnce(
+            [](gin_helper::Promise<void> promise, const std::string& error) {
+              if (error.empty())
+                promise.Resolve();
+              else
+                promise.RejectWithErrorMessage(error);
+            },
+            std::move(promise)));
+  } else {
+    promise.RejectWithErrorMessage("No ring buffer in progress");
+  }
+
+  return handle;
+}
+
+bool NetLog::IsCurrentlyBuffering() const {
+  return !!ring_buffer_;
+}
+
 // static
 gin::Handle<NetLog> NetLog::Create(v8::Isolate* isolate,
                                    AtomBrowserContext* browser_context) {
@@ -224,7 +348,11 @@ void NetLog::BuildPrototype(v8::Isolate* isolate,
   gin_helper::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetProperty("currentlyLogging", &NetLog::IsCurrentlyLogging)
       .SetMethod("startLogging", &NetLog::StartLogging)
-      .SetMethod("stopLogging", &NetLog::StopLogging);
+      .SetMethod("stopLogging", &NetLog::StopLogging)
+      .SetProperty("currentlyBuffering", &NetLog::IsCurrentlyBuffering)
+      .SetMethod("startRingBuffer", &NetLog::StartRingBuffer)
+      .SetMethod("stopRingBuffer", &NetLog::StopRingBuffer)
+      .SetMethod("snapshot", &NetLog::Snapshot);
 }
 
 }  // namespace api
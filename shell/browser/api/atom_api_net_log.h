@@ -14,6 +14,7 @@
 #include "base/values.h"
 #include "gin/handle.h"
 #include "services/network/public/mojom/net_log.mojom.h"
+#include "shell/browser/net/net_log_ring_buffer.h"
 #include "shell/common/gin_helper/promise.h"
 #include "shell/common/gin_helper/trackable_object.h"
 
@@ -35,6 +36,11 @@ class NetLog : public gin_helper::TrackableObject<NetLog> {
                                       gin_helper::Arguments* args);
   v8::Local<v8::Promise> StopLogging(gin_helper::Arguments* args);
   bool IsCurrentlyLogging() const;
+  void StartRingBuffer(gin_helper::Arguments* args);
+  v8::Local<v8::Promise> StopRingBuffer();
+  v8::Local<v8::Promise> Snapshot(base::FilePath path,
+                                  gin_helper::Arguments* args);
+  bool IsCurrentlyBuffering() const;
 
  protected:
   explicit NetLog(v8::Isolate* isolate, AtomBrowserContext* browser_context);
@@ -55,7 +61,9 @@ class NetLog : public gin_helper::TrackableObject<NetLog> {
 
   base::Optional<gin_helper::Promise<void>> pending_start_promise_;
 
-  scoped_refptr<base::TaskRunner> file_task_runner_;
+  std::unique_ptr<NetLogRingBuffer> ring_buffer_;
+
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
 
   base::WeakPtrFactory<NetLog> weak_ptr_factory_;
 
@@ -0,0 +1,117 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/atom_api_pdf_data.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/task/post_task.h"
+#include "gin/arguments.h"
+#include "gin/object_template_builder.h"
+#include "shell/common/gin_converters/file_path_converter.h"
+#include "shell/common/gin_helper/promise.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+// Large writes are split so a short write can be detected and retried.
+const size_t kWriteChunkSize = 1024 * 1024;
+
+std::string WriteDataToFile(scoped_refptr<base::RefCountedMemory> data,
+                            const base::FilePath& path) {
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return base::File::ErrorToString(file.error_details());
+  const char* bytes = reinterpret_cast<const char*>(data->front());
+  size_t offset = 0;
+  while (offset < data->size()) {
+    int size =
+        static_cast<int>(std::min(kWriteChunkSize, data->size() - offset));
+    int written = file.WriteAtCurrentPos(bytes + offset, size);
+    if (written <= 0)
+      return "Failed to write the PDF";
+    offset += written;
+  }
+  return std::string();
+}
+
+void OnWriteDone(gin_helper::Promise<void> promise, const std::string& error) {
+  if (error.empty())
+    promise.Resolve();
+  else
+    promise.RejectWithErrorMessage(error);
+}
+
+}  // namespace
+
+gin::WrapperInfo PdfData::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+PdfData::PdfData(scoped_refptr<base::RefCountedMemory> data)
+    : data_(std::move(data)) {}
+
+PdfData::~PdfData() = default;
+
+// static
+gin::Handle<PdfData> PdfData::Create(
+    v8::Isolate* isolate,
+    scoped_refptr<base::RefCountedMemory> data) {
+  return gin::CreateHandle(isolate, new PdfData(std::move(data)));
+}
+
+uint64_t PdfData::GetSize() const {
+  return data_->size();
+}
+
+v8::Local<v8::Value> PdfData::Read(gin::Arguments* args,
+                                   uint64_t offset,
+                                   uint64_t length) {
+  // The shared memory is read-only, so JS gets a copy of the slice.
+  offset = std::min<uint64_t>(offset, data_->size());
+  length = std::min<uint64_t>(length, data_->size() - offset);
+  return node::Buffer::Copy(args->isolate(),
+                            reinterpret_cast<const char*>(data_->front()) +
+                                offset,
+                            length)
+      .ToLocalChecked();
+}
+
+v8::Local<v8::Promise> PdfData::WriteToFile(v8::Isolate* isolate,
+                                            const base::FilePath& path) {
+  gin_helper::Promise<void> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // |data_| is kept alive by the task, even if this wrapper is collected.
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::ThreadPool(), base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&WriteDataToFile, data_, path),
+      base::BindOnce(&OnWriteDone, std::move(promise)));
+  return handle;
+}
+
+gin::ObjectTemplateBuilder PdfData::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<PdfData>::GetObjectTemplateBuilder(isolate)
+      .SetProperty("size", &PdfData::GetSize)
+      .SetMethod("read", &PdfData::Read)
+      .SetMethod("writeToFile", &PdfData::WriteToFile);
+}
+
+const char* PdfData::GetTypeName() {
+  return "PdfData";
+}
+
+}  // namespace api
+
+}  // namespace electron
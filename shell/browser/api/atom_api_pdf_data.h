@@ -0,0 +1,52 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ATOM_API_PDF_DATA_H_
+#define SHELL_BROWSER_API_ATOM_API_PDF_DATA_H_
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+
+namespace electron {
+
+namespace api {
+
+// Holds a generated PDF in the shared memory it was produced in, so it can be
+// read in slices or written to a file without copying it into the JS heap.
+class PdfData : public gin::Wrappable<PdfData> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<PdfData> Create(
+      v8::Isolate* isolate,
+      scoped_refptr<base::RefCountedMemory> data);
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  explicit PdfData(scoped_refptr<base::RefCountedMemory> data);
+  ~PdfData() override;
+
+  uint64_t GetSize() const;
+  v8::Local<v8::Value> Read(gin::Arguments* args,
+                            uint64_t offset,
+                            uint64_t length);
+  v8::Local<v8::Promise> WriteToFile(v8::Isolate* isolate,
+                                     const base::FilePath& path);
+
+  scoped_refptr<base::RefCountedMemory> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(PdfData);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ATOM_API_PDF_DATA_H_
@@ -4,6 +4,7 @@
 
 #include "shell/browser/api/atom_api_protocol.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -161,6 +162,9 @@ std::string ErrorCodeToString(ProtocolError error) {
 }  // namespace
 
 Protocol::Protocol(v8::Isolate* isolate, AtomBrowserContext* browser_context) {
+  if (!browser_context->IsOffTheRecord())
+    cache_path_ =
+        browser_context->GetPath().Append(FILE_PATH_LITERAL("Protocol Cache"));
   Init(isolate);
   AttachAsUserData(browser_context);
 }
@@ -170,6 +174,15 @@ Protocol::~Protocol() = default;
 void Protocol::RegisterURLLoaderFactories(
     content::ContentBrowserClient::NonNetworkURLLoaderFactoryMap* factories) {
   for (const auto& it : handlers_) {
+    factories->emplace(it.first, std::make_unique<AtomURLLoaderFactory>(
+                                     it.second.first, it.second.second,
+                                     GetResponseCache(it.first)));
+  }
+  for (const auto& it : asset_tables_) {
+    factories->emplace(it.first,
+                       std::make_unique<AtomURLLoaderFactory>(it.second));
+  }
+  for (const auto& it : static_roots_) {
     factories->emplace(it.first, std::make_unique<AtomURLLoaderFactory>(
                                      it.second.first, it.second.second));
   }
@@ -178,20 +191,131 @@ void Protocol::RegisterURLLoaderFactories(
 ProtocolError Protocol::RegisterProtocol(ProtocolType type,
                                          const std::string& scheme,
                                          const ProtocolHandler& handler) {
+  if (base::Contains(asset_tables_, scheme) ||
+      base::Contains(static_roots_, scheme))
+    return ProtocolError::REGISTERED;
   const bool added = base::TryEmplace(handlers_, scheme, type, handler).second;
   return added ? ProtocolError::OK : ProtocolError::REGISTERED;
 }
 
+void Protocol::RegisterBufferProtocol(const std::string& scheme,
+                                      v8::Local<v8::Value> handler,
+                                      gin::Arguments* args) {
+  if (handler->IsFunction()) {
+    ProtocolHandler callback;
+    gin::ConvertFromV8(args->isolate(), handler, &callback);
+    HandleOptionalCallback(
+        args, RegisterProtocol(ProtocolType::kBuffer, scheme, callback));
+    return;
+  }
+
+  gin_helper::Dictionary table;
+  if (!gin::ConvertFromV8(args->isolate(), handler, &table)) {
+    args->ThrowTypeError("Must pass a Function or an asset table");
+    return;
+  }
+  std::string error;
+  scoped_refptr<ProtocolAssetTable> assets =
+      ProtocolAssetTable::Create(table, &error);
+  if (!assets) {
+    args->ThrowTypeError(error);
+    return;
+  }
+
+  ProtocolError result = ProtocolError::REGISTERED;
+  if (!base::Contains(handlers_, scheme) &&
+      !base::Contains(static_roots_, scheme) &&
+      base::TryEmplace(asset_tables_, scheme, std::move(assets)).second)
+    result = ProtocolError::OK;
+  HandleOptionalCallback(args, result);
+}
+
+bool Protocol::RegisterStaticProtocol(const std::string& scheme,
+                                      const gin_helper::Dictionary& options,
+                                      gin::Arguments* args) {
+  ProtocolHandler miss_handler;
+  v8::Local<v8::Value> handler;
+  if (args->GetNext(&handler) && !handler->IsUndefined() &&
+      !gin::ConvertFromV8(args->isolate(), handler, &miss_handler)) {
+    args->ThrowTypeError("Handler must be a Function");
+    return false;
+  }
+
+  std::string error;
+  scoped_refptr<ProtocolStaticRoot> root =
+      ProtocolStaticRoot::Create(options, &error);
+  if (!root) {
+    args->ThrowTypeError(error);
+    return false;
+  }
+
+  if (IsProtocolRegistered(scheme))
+    return false;
+  static_roots_.emplace(scheme, std::make_pair(std::move(root), miss_handler));
+  return true;
+}
+
 void Protocol::UnregisterProtocol(const std::string& scheme,
                                   gin::Arguments* args) {
-  const bool removed = handlers_.erase(scheme) != 0;
+  const bool removed =
+      (handlers_.erase(scheme) + asset_tables_.erase(scheme) +
+       static_roots_.erase(scheme)) != 0;
   const auto error =
       removed ? ProtocolError::OK : ProtocolError::NOT_REGISTERED;
   HandleOptionalCallback(args, error);
 }
 
 bool Protocol::IsProtocolRegistered(const std::string& scheme) {
-  return base::Contains(handlers_, scheme);
+  return base::Contains(handlers_, scheme) ||
+         base::Contains(asset_tables_, scheme) ||
+         base::Contains(static_roots_, scheme);
+}
+
+void Protocol::SetResponseCache(const std::string& scheme,
+                                v8::Local<v8::Value> value,
+                                gin::Arguments* args) {
+  ProtocolResponseCache::Options options;
+  if (!value->IsNull()) {
+    gin_helper::Dictionary dict;
+    if (!gin::ConvertFromV8(args->isolate(), value, &dict)) {
+      args->ThrowTypeError("Options must be an object or null");
+      return;
+    }
+    int64_t max_size = options.max_size;
+    int64_t max_entry_size = options.max_entry_size;
+    if ((dict.Get("maxSize", &max_size) && max_size <= 0) ||
+        (dict.Get("maxEntrySize", &max_entry_size) && max_entry_size <= 0) ||
+        (dict.Get("maxDiskSize", &options.max_disk_size) &&
+         options.max_disk_size <= 0)) {
+      args->ThrowTypeError("Cache sizes must be positive integers");
+      return;
+    }
+    options.enabled = true;
+    options.max_size = static_cast<size_t>(max_size);
+    options.max_entry_size =
+        static_cast<size_t>(std::min(max_entry_size, max_size));
+    dict.Get("disk", &options.disk);
+  }
+  GetResponseCache(scheme)->Configure(options);
+}
+
+v8::Local<v8::Promise> Protocol::ClearResponseCache(
+    const std::string& scheme) {
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  GetResponseCache(scheme)->Clear(base::BindOnce(
+      gin_helper::Promise<void>::ResolvePromise, std::move(promise)));
+  return handle;
+}
+
+scoped_refptr<ProtocolResponseCache> Protocol::GetResponseCache(
+    const std::string& scheme) {
+  scoped_refptr<ProtocolResponseCache>& cache = response_caches_[scheme];
+  if (!cache)
+    cache = base::MakeRefCounted<ProtocolResponseCache>(
+        cache_path_.empty() ? base::FilePath()
+                            : cache_path_.AppendASCII(scheme));
+  return cache;
 }
 
 ProtocolError Protocol::InterceptProtocol(ProtocolType type,
@@ -266,8 +390,7 @@ void Protocol::BuildPrototype(v8::Isolate* isolate,
   gin_helper::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("registerStringProtocol",
                  &Protocol::RegisterProtocolFor<ProtocolType::kString>)
-      .SetMethod("registerBufferProtocol",
-                 &Protocol::RegisterProtocolFor<ProtocolType::kBuffer>)
+      .SetMethod("registerBufferProtocol", &Protocol::RegisterBufferProtocol)
       .SetMethod("registerFileProtocol",
                  &Protocol::RegisterProtocolFor<ProtocolType::kFile>)
       .SetMethod("registerHttpProtocol",
@@ -276,9 +399,12 @@ void Protocol::BuildPrototype(v8::Isolate* isolate,
                  &Protocol::RegisterProtocolFor<ProtocolType::kStream>)
       .SetMethod("registerProtocol",
                  &Protocol::RegisterProtocolFor<ProtocolType::kFree>)
+      .SetMethod("registerStaticProtocol", &Protocol::RegisterStaticProtocol)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolRegistered", &Protocol::IsProtocolRegistered)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
+      .SetMethod("setResponseCache", &Protocol::SetResponseCache)
+      .SetMethod("clearResponseCache", &Protocol::ClearResponseCache)
       .SetMethod("interceptStringProtocol",
                  &Protocol::InterceptProtocolFor<ProtocolType::kString>)
       .SetMethod("interceptBufferProtocol",
@@ -5,9 +5,12 @@
 #ifndef SHELL_BROWSER_API_ATOM_API_PROTOCOL_H_
 #define SHELL_BROWSER_API_ATOM_API_PROTOCOL_H_
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/files/file_path.h"
 #include "content/public/browser/content_browser_client.h"
 #include "gin/handle.h"
 #include "shell/browser/net/atom_url_loader_factory.h"
@@ -74,6 +77,29 @@ class Protocol : public gin_helper::TrackableObject<Protocol> {
   v8::Local<v8::Promise> IsProtocolHandled(const std::string& scheme,
                                            gin::Arguments* args);
 
+  // registerBufferProtocol also accepts a table of assets instead of a
+  // handler.
+  void RegisterBufferProtocol(const std::string& scheme,
+                              v8::Local<v8::Value> handler,
+                              gin::Arguments* args);
+
+  // Serves files from a directory or an asar archive without calling into
+  // JavaScript, except for the optional handler of missing files.
+  bool RegisterStaticProtocol(const std::string& scheme,
+                              const gin_helper::Dictionary& options,
+                              gin::Arguments* args);
+
+  // Enables, reconfigures or, with null options, disables the response cache
+  // of the stream and HTTP handlers of |scheme|.
+  void SetResponseCache(const std::string& scheme,
+                        v8::Local<v8::Value> options,
+                        gin::Arguments* args);
+  v8::Local<v8::Promise> ClearResponseCache(const std::string& scheme);
+
+  // Returns the cache of |scheme|, which is created disabled on first use.
+  scoped_refptr<ProtocolResponseCache> GetResponseCache(
+      const std::string& scheme);
+
   // Helper for converting old registration APIs to new RegisterProtocol API.
   template <ProtocolType type>
   void RegisterProtocolFor(const std::string& scheme,
@@ -93,6 +119,21 @@ class Protocol : public gin_helper::TrackableObject<Protocol> {
 
   HandlersMap handlers_;
   HandlersMap intercept_handlers_;
+
+  // scheme => assets, for buffer protocols registered with an asset table.
+  std::map<std::string, scoped_refptr<ProtocolAssetTable>> asset_tables_;
+
+  // scheme => (root, miss handler), for static protocols.
+  std::map<std::string,
+           std::pair<scoped_refptr<ProtocolStaticRoot>, ProtocolHandler>>
+      static_roots_;
+
+  // scheme => response cache, kept when the scheme is unregistered.
+  std::map<std::string, scoped_refptr<ProtocolResponseCache>>
+      response_caches_;
+
+  // Parent directory of the disk caches, empty for in-memory sessions.
+  base::FilePath cache_path_;
 };
 
 }  // namespace api
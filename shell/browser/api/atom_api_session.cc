@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +31,8 @@
 #include "content/public/browser/download_manager_delegate.h"
 #include "content/public/browser/network_service_instance.h"
 #include "content/public/browser/storage_partition.h"
+#include "content/public/common/resource_type.h"
+#include "extensions/common/url_pattern.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
 #include "net/base/completion_repeating_callback.h"
@@ -51,6 +54,8 @@
 #include "shell/browser/browser.h"
 #include "shell/browser/media/media_device_id_salt.h"
 #include "shell/browser/net/cert_verifier_client.h"
+#include "shell/browser/net/network_emulator.h"
+#include "shell/browser/net/network_warmup.h"
 #include "shell/browser/session_preferences.h"
 #include "shell/common/gin_converters/callback_converter.h"
 #include "shell/common/gin_converters/content_converter.h"
@@ -197,6 +202,54 @@ void DownloadIdCallback(content::DownloadManager* download_manager,
       false, std::vector<download::DownloadItem::ReceivedSlice>());
 }
 
+network::mojom::NetworkConditionsPtr ParseNetworkConditions(
+    const gin_helper::Dictionary& options) {
+  auto conditions = network::mojom::NetworkConditions::New();
+  options.Get("offline", &conditions->offline);
+  options.Get("downloadThroughput", &conditions->download_throughput);
+  options.Get("uploadThroughput", &conditions->upload_throughput);
+  double latency = 0.0;
+  if (options.Get("latency", &latency) && latency) {
+    conditions->latency = base::TimeDelta::FromMillisecondsD(latency);
+  }
+  return conditions;
+}
+
+// Adds the content types of a webRequest resourceType to |types|.
+bool AddResourceTypes(const std::string& name,
+                      std::set<content::ResourceType>* types) {
+  static constexpr struct {
+    const char* name;
+    content::ResourceType type;
+  } kNamedTypes[] = {
+      {"mainFrame", content::ResourceType::kMainFrame},
+      {"subFrame", content::ResourceType::kSubFrame},
+      {"stylesheet", content::ResourceType::kStylesheet},
+      {"script", content::ResourceType::kScript},
+      {"image", content::ResourceType::kImage},
+      {"object", content::ResourceType::kObject},
+      {"xhr", content::ResourceType::kXhr},
+  };
+  for (const auto& named : kNamedTypes) {
+    if (name == named.name) {
+      types->insert(named.type);
+      return true;
+    }
+  }
+  if (name != "other")
+    return false;
+  // Everything that has no name of its own.
+  for (int i = 0; i <= static_cast<int>(content::ResourceType::kMaxValue);
+       ++i) {
+    auto type = static_cast<content::ResourceType>(i);
+    if (std::none_of(
+            std::begin(kNamedTypes), std::end(kNamedTypes),
+            [type](const auto& named) { return named.type == type; }))
+      types->insert(type);
+  }
+  return true;
+}
+
 void DestroyGlobalHandle(v8::Isolate* isolate,
                          const v8::Global<v8::Value>& global_handle) {
   v8::Locker locker(isolate);
@@ -218,8 +271,7 @@ void DestroyGlobalHandle(v8::Isolate* isolate,
 }  // namespace
 
 Session::Session(v8::Isolate* isolate, AtomBrowserContext* browser_context)
-    : network_emulation_token_(base::UnguessableToken::Create()),
-      browser_context_(browser_context) {
+    : browser_context_(browser_context) {
   // Observe DownloadManager to get download notifications.
   content::BrowserContext::GetDownloadManager(browser_context)
       ->AddObserver(this);
@@ -228,6 +280,13 @@ Session::Session(v8::Isolate* isolate, AtomBrowserContext* browser_context)
 
   protocol_.Reset(isolate, Protocol::Create(isolate, browser_context).ToV8());
 
+  // Warm up the network stack with what was configured or learned in the
+  // previous runs, without delaying the creation of the session.
+  base::PostTask(
+      FROM_HERE, {content::BrowserThread::UI},
+      base::BindOnce(&NetworkWarmup::Start,
+                     browser_context->GetNetworkWarmup()->GetWeakPtr()));
+
   Init(isolate);
   AttachAsUserData(browser_context);
 }
@@ -393,29 +452,84 @@ void Session::SetDownloadPath(const base::FilePath& path) {
 }
 
 void Session::EnableNetworkEmulation(const gin_helper::Dictionary& options) {
-  auto conditions = network::mojom::NetworkConditions::New();
+  browser_context_->GetNetworkEmulator()->SetDefaultConditions(
+      ParseNetworkConditions(options));
+}
 
-  options.Get("offline", &conditions->offline);
-  options.Get("downloadThroughput", &conditions->download_throughput);
-  options.Get("uploadThroughput", &conditions->upload_throughput);
-  double latency = 0.0;
-  if (options.Get("latency", &latency) && latency) {
-    conditions->latency = base::TimeDelta::FromMillisecondsD(latency);
+void Session::DisableNetworkEmulation() {
+  browser_context_->GetNetworkEmulator()->SetDefaultConditions(nullptr);
+}
+
+void Session::SetNetworkEmulationProfile(v8::Local<v8::Value> val,
+                                         gin_helper::Arguments* args) {
+  NetworkEmulator* emulator = browser_context_->GetNetworkEmulator();
+  if (val->IsNull()) {
+    emulator->ClearProfile();
+    return;
   }
 
-  auto* network_context = content::BrowserContext::GetDefaultStoragePartition(
-                              browser_context_.get())
-                              ->GetNetworkContext();
-  network_context->SetNetworkConditions(network_emulation_token_,
-                                        std::move(conditions));
-}
+  gin_helper::Dictionary options;
+  std::vector<gin_helper::Dictionary> rules;
+  if (!gin::ConvertFromV8(args->isolate(), val, &options) ||
+      !options.Get("rules", &rules)) {
+    args->ThrowError("Must pass null or an object with rules");
+    return;
+  }
 
-void Session::DisableNetworkEmulation() {
-  auto* network_context = content::BrowserContext::GetDefaultStoragePartition(
-                              browser_context_.get())
-                              ->GetNetworkContext();
-  network_context->SetNetworkConditions(
-      network_emulation_token_, network::mojom::NetworkConditions::New());
+  NetworkEmulator::Profile profile;
+  options.Get("seed", &profile.seed);
+  for (const gin_helper::Dictionary& rule_options : rules) {
+    NetworkEmulator::Rule rule;
+    std::vector<std::string> values;
+    if (rule_options.Get("urls", &values)) {
+      for (const std::string& value : values) {
+        URLPattern pattern(URLPattern::SCHEME_ALL);
+        if (pattern.Parse(value) != URLPattern::ParseResult::kSuccess) {
+          args->ThrowError("Invalid url pattern " + value);
+          return;
+        }
+        rule.url_patterns.insert(pattern);
+      }
+    }
+    values.clear();
+    if (rule_options.Get("resourceTypes", &values)) {
+      for (const std::string& value : values) {
+        if (!AddResourceTypes(value, &rule.resource_types)) {
+          args->ThrowError("Invalid resource type " + value);
+          return;
+        }
+      }
+    }
+
+    gin_helper::Dictionary conditions;
+    std::vector<gin_helper::Dictionary> trace;
+    if (rule_options.Get("trace", &trace)) {
+      for (const gin_helper::Dictionary& step_options : trace) {
+        NetworkEmulator::Step step;
+        double duration = 0.0;
+        step_options.Get("duration", &duration);
+        if (duration < 0) {
+          args->ThrowError("duration must not be negative");
+          return;
+        }
+        step.duration = base::TimeDelta::FromMillisecondsD(duration);
+        step.conditions = ParseNetworkConditions(step_options);
+        rule.trace.push_back(std::move(step));
+      }
+    } else if (rule_options.Get("conditions", &conditions)) {
+      NetworkEmulator::Step step;
+      step.conditions = ParseNetworkConditions(conditions);
+      rule.trace.push_back(std::move(step));
+    }
+    rule_options.Get("loop", &rule.loop);
+    if (rule_options.Get("failureRate", &rule.failure_rate) &&
+        (rule.failure_rate < 0 || rule.failure_rate > 1)) {
+      args->ThrowError("failureRate must be between 0 and 1");
+      return;
+    }
+    profile.rules.push_back(std::move(rule));
+  }
+  emulator->SetProfile(std::move(profile));
 }
 
 void Session::SetCertVerifyProc(v8::Local<v8::Value> val,
@@ -666,6 +780,65 @@ void Session::Preconnect(const gin_helper::Dictionary& options,
                      url, num_sockets_to_preconnect));
 }
 
+void Session::SetWarmupConfig(const gin_helper::Dictionary& config,
+                              gin_helper::Arguments* args) {
+  NetworkWarmup::Config warmup_config;
+  std::vector<std::string> urls;
+  if (config.Get("preconnect", &urls)) {
+    for (const std::string& spec : urls) {
+      GURL url(spec);
+      if (!url.SchemeIsHTTPOrHTTPS()) {
+        args->ThrowError("Invalid preconnect origin: " + spec);
+        return;
+      }
+      warmup_config.preconnect.push_back(url.GetOrigin());
+    }
+  }
+  urls.clear();
+  if (config.Get("prefetch", &urls)) {
+    for (const std::string& spec : urls) {
+      GURL url(spec);
+      if (!url.SchemeIsHTTPOrHTTPS()) {
+        args->ThrowError("Invalid prefetch URL: " + spec);
+        return;
+      }
+      warmup_config.prefetch.push_back(url);
+    }
+  }
+  config.Get("dnsPrefetch", &warmup_config.dns_prefetch);
+  config.Get("learnOrigins", &warmup_config.learn_origins);
+  if (config.Get("maxLearnedOrigins", &warmup_config.max_learned_origins) &&
+      warmup_config.max_learned_origins < 0) {
+    args->ThrowError("maxLearnedOrigins must not be negative");
+    return;
+  }
+  browser_context_->GetNetworkWarmup()->SetConfig(warmup_config);
+}
+
+v8::Local<v8::Value> Session::GetWarmupConfig(v8::Isolate* isolate) {
+  const NetworkWarmup::Config& config =
+      browser_context_->GetNetworkWarmup()->config();
+  gin_helper::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("preconnect", config.preconnect);
+  dict.Set("dnsPrefetch", config.dns_prefetch);
+  dict.Set("prefetch", config.prefetch);
+  dict.Set("learnOrigins", config.learn_origins);
+  dict.Set("maxLearnedOrigins", config.max_learned_origins);
+  return dict.GetHandle();
+}
+
+void Session::WarmUp() {
+  browser_context_->GetNetworkWarmup()->Start();
+}
+
+std::vector<GURL> Session::GetLearnedOrigins() {
+  return browser_context_->GetNetworkWarmup()->GetLearnedOrigins();
+}
+
+void Session::ClearLearnedOrigins() {
+  browser_context_->GetNetworkWarmup()->ClearLearnedOrigins();
+}
+
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
 base::Value Session::GetSpellCheckerLanguages() {
   return browser_context_->prefs()
@@ -753,6 +926,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDownloadPath", &Session::SetDownloadPath)
       .SetMethod("enableNetworkEmulation", &Session::EnableNetworkEmulation)
       .SetMethod("disableNetworkEmulation", &Session::DisableNetworkEmulation)
+      .SetMethod("setNetworkEmulationProfile",
+                 &Session::SetNetworkEmulationProfile)
       .SetMethod("setCertificateVerifyProc", &Session::SetCertVerifyProc)
       .SetMethod("setPermissionRequestHandler",
                  &Session::SetPermissionRequestHandler)
@@ -782,6 +957,11 @@ void Session::BuildPrototype(v8::Isolate* isolate,
                  &SetSpellCheckerDictionaryDownloadURL)
 #endif
       .SetMethod("preconnect", &Session::Preconnect)
+      .SetMethod("setWarmupConfig", &Session::SetWarmupConfig)
+      .SetMethod("getWarmupConfig", &Session::GetWarmupConfig)
+      .SetMethod("warmUp", &Session::WarmUp)
+      .SetMethod("getLearnedOrigins", &Session::GetLearnedOrigins)
+      .SetMethod("clearLearnedOrigins", &Session::ClearLearnedOrigins)
       .SetProperty("cookies", &Session::Cookies)
       .SetProperty("netLog", &Session::NetLog)
       .SetProperty("protocol", &Session::Protocol)
@@ -65,6 +65,8 @@ class Session : public gin_helper::TrackableObject<Session>,
   void SetDownloadPath(const base::FilePath& path);
   void EnableNetworkEmulation(const gin_helper::Dictionary& options);
   void DisableNetworkEmulation();
+  void SetNetworkEmulationProfile(v8::Local<v8::Value> profile,
+                                  gin_helper::Arguments* args);
   void SetCertVerifyProc(v8::Local<v8::Value> proc,
                          gin_helper::Arguments* args);
   void SetPermissionRequestHandler(v8::Local<v8::Value> val,
@@ -88,6 +90,12 @@ class Session : public gin_helper::TrackableObject<Session>,
   v8::Local<v8::Value> NetLog(v8::Isolate* isolate);
   void Preconnect(const gin_helper::Dictionary& options,
                   gin_helper::Arguments* args);
+  void SetWarmupConfig(const gin_helper::Dictionary& config,
+                       gin_helper::Arguments* args);
+  v8::Local<v8::Value> GetWarmupConfig(v8::Isolate* isolate);
+  void WarmUp();
+  std::vector<GURL> GetLearnedOrigins();
+  void ClearLearnedOrigins();
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
   base::Value GetSpellCheckerLanguages();
   void SetSpellCheckerLanguages(gin_helper::ErrorThrower thrower,
@@ -115,9 +123,6 @@ class Session : public gin_helper::TrackableObject<Session>,
   // Cached object.
   v8::Global<v8::Value> web_request_;
 
-  // The client id to enable the network throttler.
-  base::UnguessableToken network_emulation_token_;
-
   scoped_refptr<AtomBrowserContext> browser_context_;
 
   DISALLOW_COPY_AND_ASSIGN(Session);
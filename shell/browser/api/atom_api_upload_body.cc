@@ -0,0 +1,188 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/atom_api_upload_body.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/optional.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "gin/dictionary.h"
+#include "gin/object_template_builder.h"
+#include "shell/browser/api/atom_api_data_pipe_holder.h"
+#include "shell/common/gin_converters/file_path_converter.h"
+#include "shell/common/gin_helper/promise.h"
+
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+// Reads at most |length| bytes of |path| starting at |offset|.
+base::Optional<std::vector<char>> ReadFileRange(const base::FilePath& path,
+                                                uint64_t offset,
+                                                uint64_t length) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return base::nullopt;
+  int64_t file_length = file.GetLength();
+  if (file_length < 0)
+    return base::nullopt;
+
+  uint64_t size = static_cast<uint64_t>(file_length);
+  offset = std::min(offset, size);
+  length = std::min({length, size - offset,
+                     static_cast<uint64_t>(std::numeric_limits<int>::max())});
+  std::vector<char> data(length);
+  if (length > 0 && file.Read(offset, data.data(), length) !=
+                        static_cast<int>(length))
+    return base::nullopt;
+  return data;
+}
+
+void OnFileRangeRead(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                     base::Optional<std::vector<char>> data) {
+  if (!data) {
+    promise.RejectWithErrorMessage("Could not read the uploaded file");
+    return;
+  }
+  v8::Isolate* isolate = promise.isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  promise.Resolve(
+      node::Buffer::Copy(isolate, data->data(), data->size()).ToLocalChecked());
+}
+
+}  // namespace
+
+gin::WrapperInfo UploadBody::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+UploadBody::UploadBody(scoped_refptr<network::ResourceRequestBody> body)
+    : body_(std::move(body)) {}
+
+UploadBody::~UploadBody() = default;
+
+v8::Local<v8::Value> UploadBody::GetElements(v8::Isolate* isolate) {
+  const auto& elements = *body_->elements();
+  v8::Local<v8::Array> result = v8::Array::New(isolate, elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    const auto& element = elements[i];
+    gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+    switch (element.type()) {
+      case network::mojom::DataElementType::kBytes:
+        dict.Set("type", "bytes");
+        dict.Set("length", static_cast<double>(element.length()));
+        break;
+      case network::mojom::DataElementType::kFile:
+        dict.Set("type", "file");
+        dict.Set("file", element.path());
+        // Files are uploaded to their end unless a length was given.
+        if (element.length() != std::numeric_limits<uint64_t>::max())
+          dict.Set("length", static_cast<double>(element.length()));
+        break;
+      case network::mojom::DataElementType::kDataPipe:
+        dict.Set("type", "dataPipe");
+        break;
+      default:
+        dict.Set("type", "other");
+    }
+    result
+        ->Set(isolate->GetCurrentContext(), static_cast<uint32_t>(i),
+              gin::ConvertToV8(isolate, dict))
+        .Check();
+  }
+  return result;
+}
+
+v8::Local<v8::Promise> UploadBody::Read(gin::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  uint32_t index;
+  if (!args->GetNext(&index)) {
+    args->ThrowTypeError("Must pass the index of an element");
+    return v8::Local<v8::Promise>();
+  }
+  int64_t offset = 0;
+  int64_t length = -1;
+  args->GetNext(&offset);
+  args->GetNext(&length);
+  if (offset < 0) {
+    args->ThrowTypeError("'offset' must not be negative");
+    return v8::Local<v8::Promise>();
+  }
+  // A negative length reads to the end of the element.
+  uint64_t count = length < 0 ? std::numeric_limits<uint64_t>::max()
+                              : static_cast<uint64_t>(length);
+
+  const auto& elements = *body_->elements();
+  // The length of a data pipe is only known once it is read.
+  if (index < elements.size() &&
+      elements[index].type() == network::mojom::DataElementType::kDataPipe) {
+    return DataPipeHolder::ReadRange(
+        isolate,
+        mojo::Remote<network::mojom::DataPipeGetter>(
+            elements[index].CloneDataPipeGetter()),
+        offset, count);
+  }
+
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (index >= elements.size()) {
+    promise.RejectWithErrorMessage("Invalid element index");
+    return handle;
+  }
+
+  const auto& element = elements[index];
+  uint64_t start = std::min<uint64_t>(offset, element.length());
+  count = std::min(count, element.length() - start);
+  switch (element.type()) {
+    case network::mojom::DataElementType::kBytes:
+      promise.Resolve(
+          node::Buffer::Copy(isolate, element.bytes() + start, count)
+              .ToLocalChecked());
+      break;
+    case network::mojom::DataElementType::kFile:
+      base::PostTaskAndReplyWithResult(
+          base::CreateTaskRunner({base::ThreadPool(), base::MayBlock(),
+                                  base::TaskPriority::USER_VISIBLE})
+              .get(),
+          FROM_HERE,
+          base::BindOnce(&ReadFileRange, element.path(),
+                         element.offset() + start, count),
+          base::BindOnce(&OnFileRangeRead, std::move(promise)));
+      break;
+    default:
+      promise.RejectWithErrorMessage("Unsupported element type");
+  }
+  return handle;
+}
+
+// static
+gin::Handle<UploadBody> UploadBody::Create(
+    v8::Isolate* isolate,
+    scoped_refptr<network::ResourceRequestBody> body) {
+  return gin::CreateHandle(isolate, new UploadBody(std::move(body)));
+}
+
+gin::ObjectTemplateBuilder UploadBody::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<UploadBody>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("getElements", &UploadBody::GetElements)
+      .SetMethod("read", &UploadBody::Read);
+}
+
+const char* UploadBody::GetTypeName() {
+  return "UploadBody";
+}
+
+}  // namespace api
+
+}  // namespace electron
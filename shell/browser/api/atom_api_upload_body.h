@@ -0,0 +1,51 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ATOM_API_UPLOAD_BODY_H_
+#define SHELL_BROWSER_API_ATOM_API_UPLOAD_BODY_H_
+
+#include "base/memory/scoped_refptr.h"
+#include "gin/arguments.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "services/network/public/cpp/resource_request_body.h"
+
+namespace electron {
+
+namespace api {
+
+// Gives access to the body of a request without copying it, ranges of the
+// elements are only read when asked for.
+class UploadBody : public gin::Wrappable<UploadBody> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<UploadBody> Create(
+      v8::Isolate* isolate,
+      scoped_refptr<network::ResourceRequestBody> body);
+
+  const network::ResourceRequestBody& body() const { return *body_; }
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  explicit UploadBody(scoped_refptr<network::ResourceRequestBody> body);
+  ~UploadBody() override;
+
+  v8::Local<v8::Value> GetElements(v8::Isolate* isolate);
+  v8::Local<v8::Promise> Read(gin::Arguments* args);
+
+  scoped_refptr<network::ResourceRequestBody> body_;
+
+  DISALLOW_COPY_AND_ASSIGN(UploadBody);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ATOM_API_UPLOAD_BODY_H_
@@ -4,8 +4,11 @@
 
 #include "shell/browser/api/atom_api_url_request.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
 #include "gin/handle.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
 #include "mojo/public/cpp/system/string_data_source.h"
@@ -13,6 +16,9 @@
 #include "services/network/public/mojom/chunked_data_pipe_getter.mojom.h"
 #include "shell/browser/api/atom_api_session.h"
 #include "shell/browser/atom_browser_context.h"
+#include "shell/browser/net/response_buffer_pool.h"
+#include "shell/browser/net/response_file_writer.h"
+#include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
@@ -79,6 +85,22 @@ const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
           setting: "This feature cannot be disabled."
         })");
 
+// Default size of the Buffers emitted for the response body.
+constexpr size_t kDefaultResponseChunkSize = 64 * 1024;
+
+// Partially filled chunks are emitted after this delay, so slow streams are
+// not held back until a whole chunk arrives.
+constexpr base::TimeDelta kResponseFlushDelay =
+    base::TimeDelta::FromMilliseconds(5);
+
+// Reading from the network pauses while this much data is waiting to be
+// written to the download file.
+constexpr size_t kMaxPendingFileBytes = 4 * 1024 * 1024;
+
+// Default interval between two "progress" events of a download.
+constexpr base::TimeDelta kDefaultProgressInterval =
+    base::TimeDelta::FromMilliseconds(100);
+
 }  // namespace
 
 // Common class for streaming data.
@@ -166,7 +188,10 @@ class ChunkedDataPipeGetter : public UploadDataPipeGetter,
   mojo::ReceiverSet<network::mojom::ChunkedDataPipeGetter> receiver_set_;
 };
 
-URLRequest::URLRequest(gin::Arguments* args) : weak_factory_(this) {
+URLRequest::URLRequest(gin::Arguments* args)
+    : response_chunk_size_(kDefaultResponseChunkSize),
+      progress_interval_(kDefaultProgressInterval),
+      weak_factory_(this) {
   request_ = std::make_unique<network::ResourceRequest>();
   gin_helper::Dictionary dict;
   if (args->GetNext(&dict)) {
@@ -174,6 +199,24 @@ URLRequest::URLRequest(gin::Arguments* args) : weak_factory_(this) {
     dict.Get("url", &request_->url);
     dict.Get("redirect", &redirect_mode_);
     request_->redirect_mode = redirect_mode_;
+    uint32_t high_water_mark;
+    if (dict.Get("highWaterMark", &high_water_mark) && high_water_mark > 0)
+      response_chunk_size_ = high_water_mark;
+
+    gin_helper::Dictionary destination;
+    if (dict.Get("destination", &destination)) {
+      base::FilePath path;
+      int fd;
+      if (destination.Get("path", &path))
+        file_writer_ = std::make_unique<ResponseFileWriter>(path);
+      else if (destination.Get("fd", &fd))
+        file_writer_ = std::make_unique<ResponseFileWriter>(fd);
+      destination.Get("resume", &resume_download_);
+      int progress_interval;
+      if (destination.Get("progressInterval", &progress_interval))
+        progress_interval_ =
+            base::TimeDelta::FromMilliseconds(progress_interval);
+    }
   }
 
   std::string partition;
@@ -190,7 +233,9 @@ URLRequest::URLRequest(gin::Arguments* args) : weak_factory_(this) {
   InitWithArgs(args);
 }
 
-URLRequest::~URLRequest() = default;
+URLRequest::~URLRequest() {
+  ReleaseResponseData();
+}
 
 bool URLRequest::NotStarted() const {
   return request_state_ == 0;
@@ -225,6 +270,8 @@ void URLRequest::Close() {
     EmitEvent(EventType::kRequest, true, "close");
   }
   Unpin();
+  ReleaseResponseData();
+  resume_.Reset();
   loader_.reset();
 }
 
@@ -234,34 +281,20 @@ bool URLRequest::Write(v8::Local<v8::Value> data, bool is_last) {
 
   size_t length = node::Buffer::Length(data);
 
-  if (!loader_) {
+  if (NotStarted()) {
     // Pin on first write.
     request_state_ = STATE_STARTED;
     Pin();
 
-    // Create the loader.
-    network::ResourceRequest* request_ref = request_.get();
-    loader_ = network::SimpleURLLoader::Create(std::move(request_),
-                                               kTrafficAnnotation);
-    loader_->SetOnResponseStartedCallback(
-        base::Bind(&URLRequest::OnResponseStarted, weak_factory_.GetWeakPtr()));
-    loader_->SetOnRedirectCallback(
-        base::Bind(&URLRequest::OnRedirect, weak_factory_.GetWeakPtr()));
-    loader_->SetOnUploadProgressCallback(
-        base::Bind(&URLRequest::OnUploadProgress, weak_factory_.GetWeakPtr()));
-
-    // Create upload data pipe if we have data to write.
-    if (length > 0) {
-      request_ref->request_body = new network::ResourceRequestBody();
-      if (is_chunked_upload_)
-        data_pipe_getter_ = std::make_unique<ChunkedDataPipeGetter>(this);
-      else
-        data_pipe_getter_ = std::make_unique<MultipartDataPipeGetter>(this);
-      data_pipe_getter_->AttachToRequestBody(request_ref->request_body.get());
+    // The download file is opened first, so a partial download can be
+    // resumed from its length.
+    if (file_writer_) {
+      file_writer_->Open(base::BindOnce(&URLRequest::OnFileOpened,
+                                        weak_factory_.GetWeakPtr(),
+                                        length > 0));
+    } else {
+      StartLoader(length > 0);
     }
-
-    // Start downloading.
-    loader_->DownloadAsStream(url_loader_factory_.get(), this);
   }
 
   if (length > 0)
@@ -286,6 +319,32 @@ bool URLRequest::Write(v8::Local<v8::Value> data, bool is_last) {
   return true;
 }
 
+void URLRequest::StartLoader(bool has_body) {
+  // Create the loader.
+  network::ResourceRequest* request_ref = request_.get();
+  loader_ = network::SimpleURLLoader::Create(std::move(request_),
+                                             kTrafficAnnotation);
+  loader_->SetOnResponseStartedCallback(
+      base::Bind(&URLRequest::OnResponseStarted, weak_factory_.GetWeakPtr()));
+  loader_->SetOnRedirectCallback(
+      base::Bind(&URLRequest::OnRedirect, weak_factory_.GetWeakPtr()));
+  loader_->SetOnUploadProgressCallback(
+      base::Bind(&URLRequest::OnUploadProgress, weak_factory_.GetWeakPtr()));
+
+  // Create upload data pipe if we have data to write.
+  if (has_body) {
+    request_ref->request_body = new network::ResourceRequestBody();
+    if (is_chunked_upload_)
+      data_pipe_getter_ = std::make_unique<ChunkedDataPipeGetter>(this);
+    else
+      data_pipe_getter_ = std::make_unique<MultipartDataPipeGetter>(this);
+    data_pipe_getter_->AttachToRequestBody(request_ref->request_body.get());
+  }
+
+  // Start downloading.
+  loader_->DownloadAsStream(url_loader_factory_.get(), this);
+}
+
 void URLRequest::FollowRedirect() {
   if (request_state_ & (STATE_CANCELED | STATE_CLOSED))
     return;
@@ -358,23 +417,78 @@ uint32_t URLRequest::ResponseHttpVersionMinor() const {
   return 0;
 }
 
+void URLRequest::PauseResponse() {
+  response_paused_ = true;
+}
+
+void URLRequest::ResumeResponse() {
+  // When downloading to a file the loader is resumed by the file writes.
+  if (file_writer_)
+    return;
+  response_paused_ = false;
+  if (resume_)
+    std::move(resume_).Run();
+}
+
 void URLRequest::OnDataReceived(base::StringPiece data,
                                 base::OnceClosure resume) {
+  if (file_writer_) {
+    if (writing_to_file_ && !(request_state_ & STATE_ERROR) &&
+        !(response_state_ & STATE_ERROR)) {
+      file_writer_->Write(data, base::BindOnce(&URLRequest::OnFileWritten,
+                                               weak_factory_.GetWeakPtr(),
+                                               data.size()));
+      if (file_writer_->pending_bytes() >= kMaxPendingFileBytes) {
+        resume_ = std::move(resume);
+        return;
+      }
+    }
+    std::move(resume).Run();
+    return;
+  }
+
+  auto* pool = ResponseBufferPool::GetInstance();
+  size_t offset = 0;
   // In case we received an unexpected event from Chromium net, don't emit any
   // data event after request cancel/error/close.
-  if (!(request_state_ & STATE_ERROR) && !(response_state_ & STATE_ERROR)) {
-    v8::HandleScope handle_scope(isolate());
-    v8::Local<v8::Value> buffer;
-    auto maybe = node::Buffer::Copy(isolate(), data.data(), data.size());
-    if (maybe.ToLocal(&buffer))
-      Emit("data", buffer);
+  while (offset < data.size() && !(request_state_ & STATE_ERROR) &&
+         !(response_state_ & STATE_ERROR)) {
+    if (!response_block_)
+      response_block_ = pool->Acquire(response_chunk_size_);
+    size_t size = std::min(response_chunk_size_ - response_block_size_,
+                           data.size() - offset);
+    memcpy(response_block_ + response_block_size_, data.data() + offset, size);
+    response_block_size_ += size;
+    offset += size;
+    if (response_block_size_ == response_chunk_size_)
+      FlushResponseData();
   }
-  std::move(resume).Run();
+
+  if (response_block_ && !flush_timer_.IsRunning()) {
+    flush_timer_.Start(FROM_HERE, kResponseFlushDelay,
+                       base::BindOnce(&URLRequest::FlushResponseData,
+                                      base::Unretained(this)));
+  }
+
+  // The loader stops reading until |resume| is called, which lets the data
+  // pipe fill up and eventually applies backpressure to the server.
+  if (response_paused_ && loader_)
+    resume_ = std::move(resume);
+  else
+    std::move(resume).Run();
 }
 
 void URLRequest::OnRetry(base::OnceClosure start_retry) {}
 
 void URLRequest::OnComplete(bool success) {
+  if (success && writing_to_file_) {
+    // The request is done once the file is complete.
+    file_writer_->Close(base::BindOnce(&URLRequest::OnFileClosed,
+                                       weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  FlushResponseData();
   if (success) {
     // In case we received an unexpected event from Chromium net, don't emit any
     // data event after request cancel/error/close.
@@ -409,6 +523,19 @@ void URLRequest::OnResponseStarted(
 
   response_headers_ = response_head.headers;
   response_state_ |= STATE_STARTED;
+
+  // Only the body of successful responses is written to the file, so a
+  // failed attempt to resume keeps the partial download.
+  int status_code = response_headers_ ? response_headers_->response_code() : 0;
+  if (file_writer_ && status_code >= 200 && status_code < 300) {
+    writing_to_file_ = true;
+    int64_t offset = status_code == 206 ? resume_offset_ : 0;
+    file_writer_->Truncate(offset);
+    bytes_downloaded_ = offset;
+    if (response_head.content_length >= 0)
+      download_total_ = offset + response_head.content_length;
+  }
+
   Emit("response");
 }
 
@@ -491,6 +618,103 @@ void URLRequest::StartWriting() {
   DoWrite();
 }
 
+void URLRequest::OnFileOpened(bool has_body,
+                              base::File::Error error,
+                              int64_t length) {
+  if (request_state_ & STATE_ERROR)
+    return;
+  if (error != base::File::FILE_OK) {
+    EmitError(EventType::kRequest, base::File::ErrorToString(error));
+    Close();
+    return;
+  }
+
+  if (resume_download_ && length > 0) {
+    resume_offset_ = length;
+    request_->headers.SetHeader(
+        net::HttpRequestHeaders::kRange,
+        base::StringPrintf("bytes=%" PRId64 "-", resume_offset_));
+  }
+  StartLoader(has_body);
+}
+
+void URLRequest::OnFileWritten(size_t size, base::File::Error error) {
+  if ((request_state_ & STATE_ERROR) || (response_state_ & STATE_ERROR))
+    return;
+  if (error != base::File::FILE_OK) {
+    EmitError(EventType::kResponse, base::File::ErrorToString(error));
+    Close();
+    return;
+  }
+
+  bytes_downloaded_ += size;
+  EmitDownloadProgress(false);
+  if (resume_ && file_writer_->pending_bytes() < kMaxPendingFileBytes)
+    std::move(resume_).Run();
+}
+
+void URLRequest::OnFileClosed(base::File::Error error) {
+  if ((request_state_ & STATE_ERROR) || (response_state_ & STATE_ERROR))
+    return;
+  if (error != base::File::FILE_OK) {
+    EmitError(EventType::kResponse, base::File::ErrorToString(error));
+  } else {
+    EmitDownloadProgress(true);
+    response_state_ |= STATE_FINISHED;
+    Emit("end");
+  }
+  Close();
+}
+
+void URLRequest::EmitDownloadProgress(bool force) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!force && now - last_progress_time_ < progress_interval_)
+    return;
+  last_progress_time_ = now;
+  EmitEvent(EventType::kResponse, false, "progress", bytes_downloaded_,
+            download_total_);
+}
+
+void URLRequest::FlushResponseData() {
+  flush_timer_.Stop();
+  if (!response_block_)
+    return;
+  if ((request_state_ & STATE_ERROR) || (response_state_ & STATE_ERROR)) {
+    ReleaseResponseData();
+    return;
+  }
+
+  auto* pool = ResponseBufferPool::GetInstance();
+  char* block = response_block_;
+  size_t size = response_block_size_;
+  response_block_ = nullptr;
+  response_block_size_ = 0;
+
+  v8::HandleScope handle_scope(isolate());
+  v8::MaybeLocal<v8::Object> maybe;
+  if (size < response_chunk_size_ / 4) {
+    // Small chunks are copied, so the block can be reused right away instead
+    // of being held by a mostly empty Buffer.
+    maybe = node::Buffer::Copy(isolate(), block, size);
+    pool->Release(block, response_chunk_size_);
+  } else {
+    maybe = pool->Wrap(isolate(), block, response_chunk_size_, size);
+  }
+  v8::Local<v8::Object> buffer;
+  if (maybe.ToLocal(&buffer))
+    Emit("data", buffer);
+}
+
+void URLRequest::ReleaseResponseData() {
+  flush_timer_.Stop();
+  if (response_block_) {
+    ResponseBufferPool::GetInstance()->Release(response_block_,
+                                               response_chunk_size_);
+    response_block_ = nullptr;
+    response_block_size_ = 0;
+  }
+}
+
 void URLRequest::Pin() {
   if (wrapper_.IsEmpty()) {
     wrapper_.Reset(isolate(), GetWrapper());
@@ -537,6 +761,8 @@ void URLRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setChunkedUpload", &URLRequest::SetChunkedUpload)
       .SetMethod("followRedirect", &URLRequest::FollowRedirect)
       .SetMethod("getUploadProgress", &URLRequest::GetUploadProgress)
+      .SetMethod("pauseResponse", &URLRequest::PauseResponse)
+      .SetMethod("resumeResponse", &URLRequest::ResumeResponse)
       .SetProperty("notStarted", &URLRequest::NotStarted)
       .SetProperty("finished", &URLRequest::Finished)
       .SetProperty("statusCode", &URLRequest::StatusCode)
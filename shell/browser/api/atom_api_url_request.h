@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 
+#include "base/files/file.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "gin/arguments.h"
 #include "gin/dictionary.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
@@ -21,6 +24,8 @@
 
 namespace electron {
 
+class ResponseFileWriter;
+
 namespace api {
 
 class UploadDataPipeGetter;
@@ -55,6 +60,11 @@ class URLRequest : public gin_helper::EventEmitter<URLRequest>,
   uint32_t ResponseHttpVersionMajor() const;
   uint32_t ResponseHttpVersionMinor() const;
 
+  // Flow control of the response body, used by IncomingMessage to stop
+  // reading from the network while its buffer is full.
+  void PauseResponse();
+  void ResumeResponse();
+
   // SimpleURLLoaderStreamConsumer:
   void OnDataReceived(base::StringPiece string_piece,
                       base::OnceClosure resume) override;
@@ -78,6 +88,19 @@ class URLRequest : public gin_helper::EventEmitter<URLRequest>,
   // Start streaming.
   void StartWriting();
 
+  // Create the loader and start the request.
+  void StartLoader(bool has_body);
+
+  // Streaming the response body to a file.
+  void OnFileOpened(bool has_body, base::File::Error error, int64_t length);
+  void OnFileWritten(size_t size, base::File::Error error);
+  void OnFileClosed(base::File::Error error);
+  void EmitDownloadProgress(bool force);
+
+  // Emit the coalesced response data as one Buffer.
+  void FlushResponseData();
+  void ReleaseResponseData();
+
   // Manage lifetime of wrapper.
   void Pin();
   void Unpin();
@@ -129,6 +152,31 @@ class URLRequest : public gin_helper::EventEmitter<URLRequest>,
   // Pending writes that not yet sent to NetworkService.
   std::list<std::string> pending_writes_;
 
+  // Response data is coalesced into blocks of |response_chunk_size_| bytes,
+  // which are flushed when full or after a short delay.
+  size_t response_chunk_size_;
+  char* response_block_ = nullptr;
+  size_t response_block_size_ = 0;
+  base::OneShotTimer flush_timer_;
+
+  // Set while JavaScript is not reading the response, |resume_| then holds
+  // the callback that makes the loader read more data.
+  bool response_paused_ = false;
+  base::OnceClosure resume_;
+
+  // Set when the response body is written to a file instead of being emitted.
+  std::unique_ptr<ResponseFileWriter> file_writer_;
+  bool resume_download_ = false;
+  // Length of the partial file when the download is resumed.
+  int64_t resume_offset_ = 0;
+  // Whether the body of the current response goes to the file, which is only
+  // the case for successful responses.
+  bool writing_to_file_ = false;
+  int64_t bytes_downloaded_ = 0;
+  int64_t download_total_ = -1;
+  base::TimeDelta progress_interval_;
+  base::TimeTicks last_progress_time_;
+
   // Used by pin/unpin to manage lifetime.
   v8::Global<v8::Object> wrapper_;
 
@@ -14,8 +14,10 @@
 #include "base/no_destructor.h"
 #include "base/optional.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/ssl/security_state_tab_helper.h"
@@ -45,9 +47,13 @@
 #include "electron/buildflags/buildflags.h"
 #include "electron/shell/common/api/api.mojom.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
+#include "mojo/public/cpp/system/data_pipe.h"
 #include "mojo/public/cpp/system/platform_handle.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
 #include "ppapi/buildflags/buildflags.h"
 #include "shell/browser/api/atom_api_browser_window.h"
+#include "shell/browser/api/atom_api_capture_session.h"
 #include "shell/browser/api/atom_api_debugger.h"
 #include "shell/browser/api/atom_api_session.h"
 #include "shell/browser/atom_autofill_driver_factory.h"
@@ -81,9 +87,12 @@
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
+#include "shell/common/heap_profiler.h"
+#include "shell/common/image_pipeline.h"
 #include "shell/common/mouse_util.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/options_switches.h"
+#include "shell/common/skia_util.h"
 #include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
 #include "third_party/blink/public/common/page/page_zoom.h"
 #include "third_party/blink/public/mojom/frame/find_in_page.mojom.h"
@@ -345,6 +354,97 @@ base::Optional<base::TimeDelta> GetCursorBlinkInterval() {
   return base::nullopt;
 }
 
+// Capacity of the data pipe used by createHeapSnapshotStream.
+constexpr uint32_t kHeapSnapshotPipeCapacity = 1024 * 1024;
+
+// Reads the "compression" option of the heap snapshot APIs.
+bool GetHeapSnapshotCompression(const gin_helper::Dictionary& options,
+                                bool* gzip) {
+  std::string compression = "none";
+  options.Get("compression", &compression);
+  if (compression != "none" && compression != "gzip")
+    return false;
+  *gzip = compression == "gzip";
+  return true;
+}
+
+// Forwards the heap snapshot a renderer writes into a data pipe to JS.
+class HeapSnapshotStreamReader {
+ public:
+  HeapSnapshotStreamReader(
+      v8::Isolate* isolate,
+      mojo::ScopedDataPipeConsumerHandle pipe,
+      base::RepeatingCallback<void(v8::Local<v8::Value>)> on_data,
+      base::OnceCallback<void(bool)> on_end)
+      : isolate_(isolate),
+        pipe_(std::move(pipe)),
+        watcher_(FROM_HERE,
+                 mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+                 base::SequencedTaskRunnerHandle::Get()),
+        on_data_(std::move(on_data)),
+        on_end_(std::move(on_end)) {
+    watcher_.Watch(pipe_.get(),
+                   MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
+                   base::BindRepeating(&HeapSnapshotStreamReader::OnReadable,
+                                       base::Unretained(this)));
+    watcher_.ArmOrNotify();
+  }
+
+  // Called with the result reported by the renderer.
+  void OnSnapshotDone(bool success) {
+    result_ = success;
+    MaybeFinish();
+  }
+
+ private:
+  ~HeapSnapshotStreamReader() = default;
+
+  void OnReadable(MojoResult result) {
+    while (true) {
+      const void* buffer = nullptr;
+      uint32_t num_bytes = 0;
+      result =
+          pipe_->BeginReadData(&buffer, &num_bytes, MOJO_READ_DATA_FLAG_NONE);
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        watcher_.ArmOrNotify();
+        return;
+      }
+      if (result != MOJO_RESULT_OK) {
+        // The renderer closed its end, everything has been read.
+        watcher_.Cancel();
+        pipe_.reset();
+        MaybeFinish();
+        return;
+      }
+      {
+        v8::Locker locker(isolate_);
+        v8::HandleScope handle_scope(isolate_);
+        on_data_.Run(node::Buffer::Copy(isolate_,
+                                        static_cast<const char*>(buffer),
+                                        num_bytes)
+                         .ToLocalChecked());
+      }
+      pipe_->EndReadData(num_bytes);
+    }
+  }
+
+  void MaybeFinish() {
+    if (pipe_.is_valid() || !result_)
+      return;
+    std::move(on_end_).Run(*result_);
+    delete this;
+  }
+
+  v8::Isolate* isolate_;
+  mojo::ScopedDataPipeConsumerHandle pipe_;
+  mojo::SimpleWatcher watcher_;
+  base::RepeatingCallback<void(v8::Local<v8::Value>)> on_data_;
+  base::OnceCallback<void(bool)> on_end_;
+  base::Optional<bool> result_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotStreamReader);
+};
+
 }  // namespace
 
 WebContents::WebContents(v8::Isolate* isolate,
@@ -1018,32 +1118,62 @@ void WebContents::OnElectronBrowserConnectionError() {
   base::Erase(frame_to_bindings_map_[frame_host], binding_id);
 }
 
+void WebContents::RecordIncomingIPC(const std::string& channel,
+                                    size_t bytes,
+                                    base::TimeTicks start) {
+  ipc_stats_.Record(IpcTrafficStats::Direction::kReceived, channel, bytes,
+                    base::TimeTicks::Now() - start);
+}
+
 void WebContents::Message(bool internal,
                           const std::string& channel,
                           blink::CloneableMessage arguments) {
+  TRACE_EVENT2("electron", "WebContents::Message", "channel", channel,
+               "bytes", arguments.encoded_message.size());
+  // The emit below can destroy |this|, so gather everything needed for the
+  // accounting beforehand.
+  auto weak_this = GetWeakPtr();
+  size_t bytes = arguments.encoded_message.size();
+  base::TimeTicks start = base::TimeTicks::Now();
   // webContents.emit('-ipc-message', new Event(), internal, channel,
   // arguments);
   EmitWithSender("-ipc-message", bindings_.dispatch_context(), InvokeCallback(),
                  internal, channel, std::move(arguments));
+  if (weak_this)
+    RecordIncomingIPC(channel, bytes, start);
 }
 
 void WebContents::Invoke(bool internal,
                          const std::string& channel,
                          blink::CloneableMessage arguments,
                          InvokeCallback callback) {
+  TRACE_EVENT2("electron", "WebContents::Invoke", "channel", channel, "bytes",
+               arguments.encoded_message.size());
+  auto weak_this = GetWeakPtr();
+  size_t bytes = arguments.encoded_message.size();
+  base::TimeTicks start = base::TimeTicks::Now();
   // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
   EmitWithSender("-ipc-invoke", bindings_.dispatch_context(),
                  std::move(callback), internal, channel, std::move(arguments));
+  if (weak_this)
+    RecordIncomingIPC(channel, bytes, start);
 }
 
 void WebContents::MessageSync(bool internal,
                               const std::string& channel,
                               blink::CloneableMessage arguments,
                               MessageSyncCallback callback) {
+  TRACE_EVENT2("electron", "WebContents::MessageSync", "channel", channel,
+               "bytes", arguments.encoded_message.size());
+  auto weak_this = GetWeakPtr();
+  size_t bytes = arguments.encoded_message.size();
+  base::TimeTicks start = base::TimeTicks::Now();
   // webContents.emit('-ipc-message-sync', new Event(sender, message), internal,
   // channel, arguments);
   EmitWithSender("-ipc-message-sync", bindings_.dispatch_context(),
                  std::move(callback), internal, channel, std::move(arguments));
+  if (weak_this)
+    RecordIncomingIPC(channel, bytes, start);
 }
 
 void WebContents::MessageTo(bool internal,
@@ -1051,6 +1181,10 @@ void WebContents::MessageTo(bool internal,
                             int32_t web_contents_id,
                             const std::string& channel,
                             blink::CloneableMessage arguments) {
+  TRACE_EVENT2("electron", "WebContents::MessageTo", "channel", channel,
+               "bytes", arguments.encoded_message.size());
+  base::TimeTicks start = base::TimeTicks::Now();
+  size_t bytes = arguments.encoded_message.size();
   auto* web_contents = gin_helper::TrackableObject<WebContents>::FromWeakMapID(
       isolate(), web_contents_id);
 
@@ -1058,13 +1192,21 @@ void WebContents::MessageTo(bool internal,
     web_contents->SendIPCMessageWithSender(internal, send_to_all, channel,
                                            std::move(arguments), ID());
   }
+  RecordIncomingIPC(channel, bytes, start);
 }
 
 void WebContents::MessageHost(const std::string& channel,
                               blink::CloneableMessage arguments) {
+  TRACE_EVENT2("electron", "WebContents::MessageHost", "channel", channel,
+               "bytes", arguments.encoded_message.size());
+  auto weak_this = GetWeakPtr();
+  size_t bytes = arguments.encoded_message.size();
+  base::TimeTicks start = base::TimeTicks::Now();
   // webContents.emit('ipc-message-host', new Event(), channel, args);
   EmitWithSender("ipc-message-host", bindings_.dispatch_context(),
                  InvokeCallback(), channel, std::move(arguments));
+  if (weak_this)
+    RecordIncomingIPC(channel, bytes, start);
 }
 
 #if BUILDFLAG(ENABLE_REMOTE_MODULE)
@@ -1860,11 +2002,12 @@ std::vector<printing::PrinterBasicInfo> WebContents::GetPrinterList() {
   return printers;
 }
 
-v8::Local<v8::Promise> WebContents::PrintToPDF(base::DictionaryValue settings) {
+v8::Local<v8::Promise> WebContents::PrintToPDF(base::DictionaryValue settings,
+                                               bool raw) {
   gin_helper::Promise<v8::Local<v8::Value>> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
   PrintPreviewMessageHandler::FromWebContents(web_contents())
-      ->PrintToPDF(std::move(settings), std::move(promise));
+      ->PrintToPDF(std::move(settings), raw, std::move(promise));
   return handle;
 }
 #endif
@@ -2022,7 +2165,11 @@ bool WebContents::SendIPCMessageWithSender(bool internal,
     target_hosts = web_contents()->GetAllFrames();
   }
 
+  size_t bytes = args.encoded_message.size();
+  TRACE_EVENT2("electron", "WebContents::SendIPCMessage", "channel", channel,
+               "bytes", bytes);
   for (auto* frame_host : target_hosts) {
+    ipc_stats_.Record(IpcTrafficStats::Direction::kSent, channel, bytes);
     mojo::AssociatedRemote<mojom::ElectronRenderer> electron_renderer;
     frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
         &electron_renderer);
@@ -2052,6 +2199,10 @@ bool WebContents::SendIPCMessageToFrame(bool internal,
   if (!(*iter)->IsRenderFrameLive())
     return false;
 
+  TRACE_EVENT2("electron", "WebContents::SendIPCMessageToFrame", "channel",
+               channel, "bytes", message.encoded_message.size());
+  ipc_stats_.Record(IpcTrafficStats::Direction::kSent, channel,
+                    message.encoded_message.size());
   mojo::AssociatedRemote<mojom::ElectronRenderer> electron_renderer;
   (*iter)->GetRemoteAssociatedInterfaces()->GetInterface(&electron_renderer);
   electron_renderer->Message(internal, send_to_all, channel, std::move(message),
@@ -2168,7 +2319,27 @@ v8::Local<v8::Promise> WebContents::CapturePage(gin_helper::Arguments* args) {
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
   // get rect arguments if they exist
-  args->GetNext(&rect);
+  if (!args->GetNext(&rect)) {
+    // Allow passing options without a rect.
+    v8::Local<v8::Value> next = args->PeekNext();
+    if (!next.IsEmpty() && next->IsNullOrUndefined())
+      args->Skip();
+  }
+
+  base::Optional<int> width;
+  base::Optional<int> height;
+  base::Optional<float> scale_factor;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    int size;
+    if (options.Get("width", &size))
+      width = size;
+    if (options.Get("height", &size))
+      height = size;
+    float scale;
+    if (options.Get("scaleFactor", &scale))
+      scale_factor = scale;
+  }
 
   auto* const view = web_contents()->GetRenderWidgetHostView();
   if (!view) {
@@ -2183,19 +2354,54 @@ v8::Local<v8::Promise> WebContents::CapturePage(gin_helper::Arguments* args) {
   // By default, the requested bitmap size is the view size in screen
   // coordinates.  However, if there's more pixel detail available on the
   // current system, increase the requested bitmap size to capture it all.
+  //
+  // An explicit size or scale is applied by the compositor when copying the
+  // surface, instead of reading back every pixel and resizing afterwards.
   gfx::Size bitmap_size = view_size;
-  const gfx::NativeView native_view = view->GetNativeView();
-  const float scale = display::Screen::GetScreen()
-                          ->GetDisplayNearestView(native_view)
-                          .device_scale_factor();
-  if (scale > 1.0f)
-    bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
+  if (width || height) {
+    bitmap_size = electron::util::GetResizedSize(view_size, width, height);
+  } else if (scale_factor) {
+    bitmap_size = gfx::ScaleToCeiledSize(view_size, *scale_factor);
+  } else {
+    const gfx::NativeView native_view = view->GetNativeView();
+    const float scale = display::Screen::GetScreen()
+                            ->GetDisplayNearestView(native_view)
+                            .device_scale_factor();
+    if (scale > 1.0f)
+      bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
+  }
 
   view->CopyFromSurface(gfx::Rect(rect.origin(), view_size), bitmap_size,
                         base::BindOnce(&OnCapturePageDone, std::move(promise)));
   return handle;
 }
 
+v8::Local<v8::Value> WebContents::CreateCaptureSession(
+    gin_helper::Arguments* args) {
+  CaptureSession::Options session_options;
+  std::string format = "png";
+  int quality = 90;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    int size;
+    if (options.Get("width", &size))
+      session_options.width = size;
+    if (options.Get("height", &size))
+      session_options.height = size;
+    options.Get("format", &format);
+    options.Get("quality", &quality);
+  }
+  ImagePipeline::Format pipeline_format;
+  if (!ImagePipeline::GetFormat(format, &pipeline_format)) {
+    args->ThrowError("Unknown format: " + format);
+    return v8::Undefined(isolate());
+  }
+  session_options.encoder = base::MakeRefCounted<ImagePipeline>(
+      std::vector<ImagePipeline::Operation>(), pipeline_format, quality);
+  return CaptureSession::Create(isolate(), web_contents(), session_options)
+      .ToV8();
+}
+
 void WebContents::OnCursorChange(const content::WebCursor& cursor) {
   const content::CursorInfo& info = cursor.info();
 
@@ -2260,6 +2466,12 @@ int WebContents::GetFrameRate() const {
   auto* osr_wcv = GetOffScreenWebContentsView();
   return osr_wcv ? osr_wcv->GetFrameRate() : 0;
 }
+
+void WebContents::SetOffscreenSize(const gfx::Size& size) {
+  auto* osr_wcv = GetOffScreenWebContentsView();
+  if (osr_wcv)
+    osr_wcv->SetSize(size);
+}
 #endif
 
 void WebContents::Invalidate() {
@@ -2283,6 +2495,11 @@ gfx::Size WebContents::GetSizeForNewRenderView(content::WebContents* wc) {
       auto* owner_window = relay->GetNativeWindow();
       return owner_window ? owner_window->GetSize() : gfx::Size();
     }
+#if BUILDFLAG(ENABLE_OSR)
+    auto* osr_wcv = GetOffScreenWebContentsView();
+    if (osr_wcv)
+      return osr_wcv->GetSize();
+#endif
   }
 
   return gfx::Size();
@@ -2429,10 +2646,18 @@ void WebContents::GrantOriginAccess(const GURL& url) {
 }
 
 v8::Local<v8::Promise> WebContents::TakeHeapSnapshot(
-    const base::FilePath& file_path) {
+    const base::FilePath& file_path,
+    gin_helper::Arguments* args) {
   gin_helper::Promise<void> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
+  bool gzip = false;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options) && !GetHeapSnapshotCompression(options, &gzip)) {
+    promise.RejectWithErrorMessage("Invalid compression");
+    return handle;
+  }
+
   base::ThreadRestrictions::ScopedAllowIO allow_io;
   base::File file(file_path,
                   base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
@@ -2456,7 +2681,7 @@ v8::Local<v8::Promise> WebContents::TakeHeapSnapshot(
       electron_renderer.get());
   auto* raw_ptr = electron_renderer.get();
   (*raw_ptr)->TakeHeapSnapshot(
-      mojo::WrapPlatformFile(file.TakePlatformFile()),
+      mojo::WrapPlatformFile(file.TakePlatformFile()), gzip,
       base::BindOnce(
           [](mojo::AssociatedRemote<mojom::ElectronRenderer>* ep,
              gin_helper::Promise<void> promise, bool success) {
@@ -2470,6 +2695,125 @@ v8::Local<v8::Promise> WebContents::TakeHeapSnapshot(
   return handle;
 }
 
+void WebContents::StreamHeapSnapshot(
+    const gin_helper::Dictionary& options,
+    base::RepeatingCallback<void(v8::Local<v8::Value>)> on_data,
+    base::OnceCallback<void(bool)> on_end) {
+  bool gzip = false;
+  auto* frame_host = web_contents()->GetMainFrame();
+  mojo::DataPipe data_pipe(kHeapSnapshotPipeCapacity);
+  if (!GetHeapSnapshotCompression(options, &gzip) || !frame_host ||
+      !data_pipe.producer_handle.is_valid()) {
+    std::move(on_end).Run(false);
+    return;
+  }
+
+  auto* reader = new HeapSnapshotStreamReader(
+      isolate(), std::move(data_pipe.consumer_handle), std::move(on_data),
+      std::move(on_end));
+
+  auto electron_renderer =
+      std::make_unique<mojo::AssociatedRemote<mojom::ElectronRenderer>>();
+  frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      electron_renderer.get());
+  auto* raw_ptr = electron_renderer.get();
+  // The reader deletes itself once both the pipe has been drained and the
+  // result arrived, so make sure a result is reported even if the renderer
+  // goes away.
+  (*raw_ptr)->StreamHeapSnapshot(
+      std::move(data_pipe.producer_handle), gzip,
+      mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+          base::BindOnce(
+              [](mojo::AssociatedRemote<mojom::ElectronRenderer>* ep,
+                 HeapSnapshotStreamReader* reader, bool success) {
+                reader->OnSnapshotDone(success);
+              },
+              base::Owned(std::move(electron_renderer)),
+              base::Unretained(reader)),
+          false));
+}
+
+v8::Local<v8::Promise> WebContents::StartSamplingHeapProfiler(
+    gin_helper::Arguments* args) {
+  gin_helper::Promise<void> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  int64_t sampling_interval = kDefaultHeapSamplingInterval;
+  int stack_depth = kDefaultHeapSamplingStackDepth;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("samplingInterval", &sampling_interval);
+    options.Get("stackDepth", &stack_depth);
+  }
+  if (sampling_interval <= 0 || stack_depth <= 0) {
+    promise.RejectWithErrorMessage(
+        "samplingInterval and stackDepth must be positive");
+    return handle;
+  }
+
+  auto* frame_host = web_contents()->GetMainFrame();
+  if (!frame_host) {
+    promise.RejectWithErrorMessage("startSamplingHeapProfiler failed");
+    return handle;
+  }
+
+  auto electron_renderer =
+      std::make_unique<mojo::AssociatedRemote<mojom::ElectronRenderer>>();
+  frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      electron_renderer.get());
+  auto* raw_ptr = electron_renderer.get();
+  (*raw_ptr)->StartSamplingHeapProfiler(
+      sampling_interval, stack_depth,
+      base::BindOnce(
+          [](mojo::AssociatedRemote<mojom::ElectronRenderer>* ep,
+             gin_helper::Promise<void> promise, bool success) {
+            if (success) {
+              promise.Resolve();
+            } else {
+              promise.RejectWithErrorMessage(
+                  "startSamplingHeapProfiler failed");
+            }
+          },
+          base::Owned(std::move(electron_renderer)), std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> WebContents::StopSamplingHeapProfiler() {
+  gin_helper::Promise<std::string> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  auto* frame_host = web_contents()->GetMainFrame();
+  if (!frame_host) {
+    promise.RejectWithErrorMessage("stopSamplingHeapProfiler failed");
+    return handle;
+  }
+
+  auto electron_renderer =
+      std::make_unique<mojo::AssociatedRemote<mojom::ElectronRenderer>>();
+  frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      electron_renderer.get());
+  auto* raw_ptr = electron_renderer.get();
+  (*raw_ptr)->StopSamplingHeapProfiler(base::BindOnce(
+      [](mojo::AssociatedRemote<mojom::ElectronRenderer>* ep,
+         gin_helper::Promise<std::string> promise, const std::string& profile) {
+        if (profile.empty()) {
+          promise.RejectWithErrorMessage("stopSamplingHeapProfiler failed");
+        } else {
+          promise.Resolve(profile);
+        }
+      },
+      base::Owned(std::move(electron_renderer)), std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Value> WebContents::GetIPCStats(v8::Isolate* isolate) const {
+  return gin::ConvertToV8(isolate, ipc_stats_.ToValue());
+}
+
+void WebContents::ResetIPCStats() {
+  ipc_stats_.Reset();
+}
+
 // static
 void WebContents::BuildPrototype(v8::Isolate* isolate,
                                  v8::Local<v8::FunctionTemplate> prototype) {
@@ -2545,6 +2889,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("_setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("_getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("_setOffscreenSize", &WebContents::SetOffscreenSize)
       .SetProperty("frameRate", &WebContents::GetFrameRate,
                    &WebContents::SetFrameRate)
 #endif
@@ -2578,6 +2923,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::ShowDefinitionForSelection)
       .SetMethod("copyImageAt", &WebContents::CopyImageAt)
       .SetMethod("capturePage", &WebContents::CapturePage)
+      .SetMethod("createCaptureSession", &WebContents::CreateCaptureSession)
       .SetMethod("setEmbedder", &WebContents::SetEmbedder)
       .SetMethod("setDevToolsWebContents", &WebContents::SetDevToolsWebContents)
       .SetMethod("getNativeView", &WebContents::GetNativeView)
@@ -2587,6 +2933,13 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::GetWebRTCIPHandlingPolicy)
       .SetMethod("_grantOriginAccess", &WebContents::GrantOriginAccess)
       .SetMethod("takeHeapSnapshot", &WebContents::TakeHeapSnapshot)
+      .SetMethod("_streamHeapSnapshot", &WebContents::StreamHeapSnapshot)
+      .SetMethod("startSamplingHeapProfiler",
+                 &WebContents::StartSamplingHeapProfiler)
+      .SetMethod("stopSamplingHeapProfiler",
+                 &WebContents::StopSamplingHeapProfiler)
+      .SetMethod("getIPCStats", &WebContents::GetIPCStats)
+      .SetMethod("resetIPCStats", &WebContents::ResetIPCStats)
       .SetProperty("id", &WebContents::ID)
       .SetProperty("session", &WebContents::Session)
       .SetProperty("hostWebContents", &WebContents::HostWebContents)
@@ -26,6 +26,7 @@
 #include "printing/buildflags/buildflags.h"
 #include "services/service_manager/public/cpp/binder_registry.h"
 #include "shell/browser/api/frame_subscriber.h"
+#include "shell/browser/api/ipc_traffic_stats.h"
 #include "shell/browser/api/save_page_handler.h"
 #include "shell/browser/common_web_contents_delegate.h"
 #include "shell/common/gin_helper/trackable_object.h"
@@ -185,8 +186,8 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
 #if BUILDFLAG(ENABLE_PRINTING)
   void Print(gin_helper::Arguments* args);
   std::vector<printing::PrinterBasicInfo> GetPrinterList();
-  // Print current page as PDF.
-  v8::Local<v8::Promise> PrintToPDF(base::DictionaryValue settings);
+  // Print current page as PDF, |raw| resolves with a PdfData.
+  v8::Local<v8::Promise> PrintToPDF(base::DictionaryValue settings, bool raw);
 #endif
 
   // DevTools workspace api.
@@ -247,6 +248,7 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
   // Captures the page with |rect|, |callback| would be called when capturing is
   // done.
   v8::Local<v8::Promise> CapturePage(gin_helper::Arguments* args);
+  v8::Local<v8::Value> CreateCaptureSession(gin_helper::Arguments* args);
 
   // Methods for creating <webview>.
   bool IsGuest() const;
@@ -263,6 +265,8 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  // The size of offscreen pages that are not in a window.
+  void SetOffscreenSize(const gfx::Size& size);
 #endif
   void Invalidate();
   gfx::Size GetSizeForNewRenderView(content::WebContents*) override;
@@ -303,7 +307,18 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
   // the specified URL.
   void GrantOriginAccess(const GURL& url);
 
-  v8::Local<v8::Promise> TakeHeapSnapshot(const base::FilePath& file_path);
+  v8::Local<v8::Promise> TakeHeapSnapshot(const base::FilePath& file_path,
+                                          gin_helper::Arguments* args);
+  void StreamHeapSnapshot(
+      const gin_helper::Dictionary& options,
+      base::RepeatingCallback<void(v8::Local<v8::Value>)> on_data,
+      base::OnceCallback<void(bool)> on_end);
+  v8::Local<v8::Promise> StartSamplingHeapProfiler(gin_helper::Arguments* args);
+  v8::Local<v8::Promise> StopSamplingHeapProfiler();
+
+  // IPC traffic accounting.
+  v8::Local<v8::Value> GetIPCStats(v8::Isolate* isolate) const;
+  void ResetIPCStats();
 
   // Properties.
   int32_t ID() const;
@@ -529,6 +544,12 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
   void InitZoomController(content::WebContents* web_contents,
                           const gin_helper::Dictionary& options);
 
+  // Records an incoming IPC message in |ipc_stats_|, |start| is the time the
+  // dispatch of the message began.
+  void RecordIncomingIPC(const std::string& channel,
+                         size_t bytes,
+                         base::TimeTicks start);
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -558,6 +579,9 @@ class WebContents : public gin_helper::TrackableObject<WebContents>,
   // Observers of this WebContents.
   base::ObserverList<ExtendedWebContentsObserver> observers_;
 
+  // Per-channel counters of the IPC messages exchanged with this WebContents.
+  IpcTrafficStats ipc_stats_;
+
   // The ID of the process of the currently committed RenderViewHost.
   // -1 means no speculative RVH has been committed yet.
   int currently_committed_process_id_ = -1;
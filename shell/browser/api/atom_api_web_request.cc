@@ -7,13 +7,16 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "base/containers/span.h"
 #include "base/stl_util.h"
 #include "base/values.h"
 #include "gin/converter.h"
 #include "gin/dictionary.h"
 #include "gin/object_template_builder.h"
 #include "shell/browser/api/atom_api_session.h"
+#include "shell/browser/api/atom_api_upload_body.h"
 #include "shell/browser/api/atom_api_web_contents.h"
 #include "shell/browser/atom_browser_context.h"
 #include "shell/common/gin_converters/callback_converter.h"
@@ -21,6 +24,33 @@
 #include "shell/common/gin_converters/net_converter.h"
 #include "shell/common/gin_converters/std_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
+#include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/gin_helper/promise.h"
+
+namespace {
+
+const char* ResourceTypeToString(content::ResourceType type) {
+  switch (type) {
+    case content::ResourceType::kMainFrame:
+      return "mainFrame";
+    case content::ResourceType::kSubFrame:
+      return "subFrame";
+    case content::ResourceType::kStylesheet:
+      return "stylesheet";
+    case content::ResourceType::kScript:
+      return "script";
+    case content::ResourceType::kImage:
+      return "image";
+    case content::ResourceType::kObject:
+      return "object";
+    case content::ResourceType::kXhr:
+      return "xhr";
+    default:
+      return "other";
+  }
+}
+
+}  // namespace
 
 namespace gin {
 
@@ -41,33 +71,7 @@ template <>
 struct Converter<content::ResourceType> {
   static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
                                    content::ResourceType type) {
-    const char* result;
-    switch (type) {
-      case content::ResourceType::kMainFrame:
-        result = "mainFrame";
-        break;
-      case content::ResourceType::kSubFrame:
-        result = "subFrame";
-        break;
-      case content::ResourceType::kStylesheet:
-        result = "stylesheet";
-        break;
-      case content::ResourceType::kScript:
-        result = "script";
-        break;
-      case content::ResourceType::kImage:
-        result = "image";
-        break;
-      case content::ResourceType::kObject:
-        result = "object";
-        break;
-      case content::ResourceType::kXhr:
-        result = "xhr";
-        break;
-      default:
-        result = "other";
-    }
-    return StringToV8(isolate, result);
+    return StringToV8(isolate, ResourceTypeToString(type));
   }
 };
 
@@ -81,6 +85,16 @@ namespace {
 
 const char* kUserDataKey = "WebRequest";
 
+// Names of the events as seen by the worker script, in the order of the
+// SimpleEvent and ResponseEvent enums.
+const char* const kSimpleEventNames[] = {
+    "onSendHeaders",     "onBeforeRedirect", "onResponseStarted",
+    "onCompleted",       "onErrorOccurred",
+};
+const char* const kResponseEventNames[] = {
+    "onBeforeRequest", "onBeforeSendHeaders", "onHeadersReceived",
+};
+
 // BrowserContext <=> WebRequest relationship.
 struct UserData : public base::SupportsUserData::Data {
   explicit UserData(WebRequest* data) : data(data) {}
@@ -89,15 +103,32 @@ struct UserData : public base::SupportsUserData::Data {
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(extensions::WebRequestInfo* info,
-                            const std::set<URLPattern>& patterns) {
-  if (patterns.empty())
-    return true;
+                            const URLPatternMatcher& patterns) {
+  return patterns.IsEmpty() || patterns.Matches(info->url);
+}
 
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(info->url))
-      return true;
+// Parses the url patterns in |dict|, throws and returns false on failure.
+bool GetURLPatterns(gin::Arguments* args,
+                    const gin::Dictionary& dict,
+                    std::set<URLPattern>* patterns) {
+  std::set<std::string> filter_patterns;
+  if (!dict.Get("urls", &filter_patterns)) {
+    args->ThrowTypeError("Parameter 'filter' must have property 'urls'.");
+    return false;
+  }
+
+  for (const std::string& filter_pattern : filter_patterns) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    const URLPattern::ParseResult result = pattern.Parse(filter_pattern);
+    if (result != URLPattern::ParseResult::kSuccess) {
+      const char* error_type = URLPattern::GetParseResultString(result);
+      args->ThrowTypeError("Invalid url pattern " + filter_pattern + ": " +
+                           error_type);
+      return false;
+    }
+    patterns->insert(pattern);
   }
-  return false;
+  return true;
 }
 
 // Convert HttpResponseHeaders to V8.
@@ -105,7 +136,7 @@ bool MatchesFilterCondition(extensions::WebRequestInfo* info,
 // Note that while we already have converters for HttpResponseHeaders, we can
 // not use it because it lowercases the header keys, while the webRequest has
 // to pass the original keys.
-v8::Local<v8::Value> HttpResponseHeadersToV8(
+base::DictionaryValue HttpResponseHeadersToValue(
     net::HttpResponseHeaders* headers) {
   base::DictionaryValue response_headers;
   if (headers) {
@@ -119,7 +150,20 @@ v8::Local<v8::Value> HttpResponseHeadersToV8(
       values->GetList().emplace_back(value);
     }
   }
-  return gin::ConvertToV8(v8::Isolate::GetCurrent(), response_headers);
+  return response_headers;
+}
+
+v8::Local<v8::Value> HttpResponseHeadersToV8(
+    net::HttpResponseHeaders* headers) {
+  return gin::ConvertToV8(v8::Isolate::GetCurrent(),
+                          HttpResponseHeadersToValue(headers));
+}
+
+int32_t GetWebContentsId(extensions::WebRequestInfo* info) {
+  auto* web_contents = content::WebContents::FromRenderFrameHost(
+      content::RenderFrameHost::FromID(info->render_process_id,
+                                       info->frame_id));
+  return api::WebContents::GetIDFromWrappedClass(web_contents);
 }
 
 // Overloaded by multiple types to fill the |details| object.
@@ -139,20 +183,36 @@ void ToDictionary(gin::Dictionary* details, extensions::WebRequestInfo* info) {
                  HttpResponseHeadersToV8(info->response_headers.get()));
   }
 
-  auto* web_contents = content::WebContents::FromRenderFrameHost(
-      content::RenderFrameHost::FromID(info->render_process_id,
-                                       info->frame_id));
-  int32_t id = api::WebContents::GetIDFromWrappedClass(web_contents);
+  int32_t id = GetWebContentsId(info);
   // id must be greater than zero.
   if (id > 0)
     details->Set("webContentsId", id);
 }
 
+// Getter of the lazy uploadData property, the body is only converted when a
+// listener reads it.
+void GetUploadData(v8::Local<v8::Name> name,
+                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+  v8::Isolate* isolate = info.GetIsolate();
+  gin::Handle<UploadBody> body;
+  if (gin::ConvertFromV8(isolate, info.Data(), &body))
+    info.GetReturnValue().Set(gin::ConvertToV8(isolate, body->body()));
+}
+
 void ToDictionary(gin::Dictionary* details,
                   const network::ResourceRequest& request) {
   details->Set("referrer", request.referrer);
-  if (request.request_body)
-    details->Set("uploadData", *request.request_body);
+  if (request.request_body) {
+    v8::Isolate* isolate = details->isolate();
+    gin::Handle<UploadBody> body =
+        UploadBody::Create(isolate, request.request_body);
+    details->Set("uploadBody", body);
+    details->GetHandle()
+        ->SetLazyDataProperty(isolate->GetCurrentContext(),
+                              gin::StringToSymbol(isolate, "uploadData"),
+                              &GetUploadData, body.ToV8())
+        .Check();
+  }
 }
 
 void ToDictionary(gin::Dictionary* details,
@@ -168,14 +228,81 @@ void ToDictionary(gin::Dictionary* details, int net_error) {
   details->Set("error", net::ErrorToString(net_error));
 }
 
+// The same for the details passed to the worker, which are copied across
+// threads and can not hold V8 objects.
+void ToDictionary(base::DictionaryValue* details,
+                  extensions::WebRequestInfo* info) {
+  details->SetDoubleKey("id", info->id);
+  details->SetStringKey("url", info->url.spec());
+  details->SetStringKey("method", info->method);
+  details->SetDoubleKey("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  details->SetStringKey("resourceType", ResourceTypeToString(info->type));
+  if (!info->response_ip.empty())
+    details->SetStringKey("ip", info->response_ip);
+  if (info->response_headers) {
+    details->SetBoolKey("fromCache", info->response_from_cache);
+    details->SetStringKey("statusLine",
+                          info->response_headers->GetStatusLine());
+    details->SetIntKey("statusCode", info->response_headers->response_code());
+    details->SetKey("responseHeaders",
+                    HttpResponseHeadersToValue(info->response_headers.get()));
+  }
+
+  int32_t id = GetWebContentsId(info);
+  if (id > 0)
+    details->SetIntKey("webContentsId", id);
+}
+
+void ToDictionary(base::DictionaryValue* details,
+                  const network::ResourceRequest& request) {
+  details->SetStringKey("referrer", request.referrer.spec());
+  if (!request.request_body)
+    return;
+  base::ListValue upload_data;
+  for (const auto& element : *request.request_body->elements()) {
+    base::DictionaryValue item;
+    switch (element.type()) {
+      case network::mojom::DataElementType::kFile:
+        item.SetStringKey("file", element.path().AsUTF8Unsafe());
+        break;
+      case network::mojom::DataElementType::kBytes:
+        item.SetKey("bytes", base::Value(base::as_bytes(base::make_span(
+                                 element.bytes(), element.length()))));
+        break;
+      default:
+        // Blobs are read through the main process only.
+        continue;
+    }
+    upload_data.Append(std::move(item));
+  }
+  details->SetKey("uploadData", std::move(upload_data));
+}
+
+void ToDictionary(base::DictionaryValue* details,
+                  const net::HttpRequestHeaders& headers) {
+  base::DictionaryValue request_headers;
+  net::HttpRequestHeaders::Iterator it(headers);
+  while (it.GetNext())
+    request_headers.SetStringKey(it.name(), it.value());
+  details->SetKey("requestHeaders", std::move(request_headers));
+}
+
+void ToDictionary(base::DictionaryValue* details, const GURL& location) {
+  details->SetStringKey("redirectURL", location.spec());
+}
+
+void ToDictionary(base::DictionaryValue* details, int net_error) {
+  details->SetStringKey("error", net::ErrorToString(net_error));
+}
+
 // Helper function to fill |details| with arbitrary |args|.
-template <typename Arg>
-void FillDetails(gin::Dictionary* details, Arg arg) {
+template <typename Details, typename Arg>
+void FillDetails(Details* details, Arg arg) {
   ToDictionary(details, arg);
 }
 
-template <typename Arg, typename... Args>
-void FillDetails(gin::Dictionary* details, Arg arg, Args... args) {
+template <typename Details, typename Arg, typename... Args>
+void FillDetails(Details* details, Arg arg, Args... args) {
   ToDictionary(details, arg);
   FillDetails(details, args...);
 }
@@ -210,23 +337,79 @@ void ReadFromResponse(v8::Isolate* isolate,
   }
 }
 
+// The same for the response of the worker.
+void ReadFromResponse(const base::Value& response, GURL* new_location) {
+  const std::string* url = response.FindStringKey("redirectURL");
+  if (url)
+    *new_location = GURL(*url);
+}
+
+void ReadFromResponse(const base::Value& response,
+                      net::HttpRequestHeaders* headers) {
+  headers->Clear();
+  const base::Value* request_headers = response.FindDictKey("requestHeaders");
+  if (!request_headers)
+    return;
+  for (const auto& item : request_headers->DictItems()) {
+    if (item.second.is_string())
+      headers->SetHeader(item.first, item.second.GetString());
+  }
+}
+
+void ReadFromResponse(const base::Value& response,
+                      const std::pair<scoped_refptr<net::HttpResponseHeaders>*,
+                                      const std::string>& headers) {
+  const std::string* status_line = response.FindStringKey("statusLine");
+  const base::Value* response_headers =
+      response.FindDictKey("responseHeaders");
+  if (!response_headers)
+    return;
+  *headers.first = new net::HttpResponseHeaders("");
+  (*headers.first)
+      ->ReplaceStatusLine(status_line ? *status_line : headers.second);
+  for (const auto& item : response_headers->DictItems()) {
+    if (item.second.is_string()) {
+      (*headers.first)->AddHeader(item.first + ": " + item.second.GetString());
+    } else if (item.second.is_list()) {
+      for (const base::Value& value : item.second.GetList()) {
+        if (value.is_string())
+          (*headers.first)->AddHeader(item.first + ": " + value.GetString());
+      }
+    }
+  }
+}
+
 }  // namespace
 
 gin::WrapperInfo WebRequest::kWrapperInfo = {gin::kEmbedderNativeGin};
 
 WebRequest::SimpleListenerInfo::SimpleListenerInfo(
-    std::set<URLPattern> patterns_,
+    const std::set<URLPattern>& patterns_,
     SimpleListener listener_)
-    : url_patterns(std::move(patterns_)), listener(listener_) {}
+    : listener(listener_) {
+  for (const URLPattern& pattern : patterns_)
+    url_patterns.AddPattern(pattern);
+}
 WebRequest::SimpleListenerInfo::SimpleListenerInfo() = default;
+WebRequest::SimpleListenerInfo::SimpleListenerInfo(
+    SimpleListenerInfo&&) = default;
 WebRequest::SimpleListenerInfo::~SimpleListenerInfo() = default;
+WebRequest::SimpleListenerInfo& WebRequest::SimpleListenerInfo::operator=(
+    SimpleListenerInfo&&) = default;
 
 WebRequest::ResponseListenerInfo::ResponseListenerInfo(
-    std::set<URLPattern> patterns_,
+    const std::set<URLPattern>& patterns_,
     ResponseListener listener_)
-    : url_patterns(std::move(patterns_)), listener(listener_) {}
+    : listener(listener_) {
+  for (const URLPattern& pattern : patterns_)
+    url_patterns.AddPattern(pattern);
+}
 WebRequest::ResponseListenerInfo::ResponseListenerInfo() = default;
+WebRequest::ResponseListenerInfo::ResponseListenerInfo(
+    ResponseListenerInfo&&) = default;
 WebRequest::ResponseListenerInfo::~ResponseListenerInfo() = default;
+WebRequest::ResponseListenerInfo& WebRequest::ResponseListenerInfo::operator=(
+    ResponseListenerInfo&&) = default;
 
 WebRequest::WebRequest(v8::Isolate* isolate,
                        content::BrowserContext* browser_context)
@@ -255,7 +438,10 @@ gin::ObjectTemplateBuilder WebRequest::GetObjectTemplateBuilder(
                  &WebRequest::SetSimpleListener<kOnResponseStarted>)
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<kOnErrorOccurred>)
-      .SetMethod("onCompleted", &WebRequest::SetSimpleListener<kOnCompleted>);
+      .SetMethod("onCompleted", &WebRequest::SetSimpleListener<kOnCompleted>)
+      .SetMethod("setRules", &WebRequest::SetRules)
+      .SetMethod("setWorker", &WebRequest::SetWorker)
+      .SetMethod("postMessageToWorker", &WebRequest::PostMessageToWorker);
 }
 
 const char* WebRequest::GetTypeName() {
@@ -263,13 +449,17 @@ const char* WebRequest::GetTypeName() {
 }
 
 bool WebRequest::HasListener() const {
-  return !(simple_listeners_.empty() && response_listeners_.empty());
+  return !(simple_listeners_.empty() && response_listeners_.empty() &&
+           rules_.IsEmpty() && !(worker_ && worker_->HasListener()));
 }
 
 int WebRequest::OnBeforeRequest(extensions::WebRequestInfo* info,
                                 const network::ResourceRequest& request,
                                 net::CompletionOnceCallback callback,
                                 GURL* new_url) {
+  int result = rules_.OnBeforeRequest(info->url, new_url);
+  if (result != net::OK || !new_url->is_empty())
+    return result;
   return HandleResponseEvent(kOnBeforeRequest, info, std::move(callback),
                              new_url, request);
 }
@@ -278,6 +468,7 @@ int WebRequest::OnBeforeSendHeaders(extensions::WebRequestInfo* info,
                                     const network::ResourceRequest& request,
                                     BeforeSendHeadersCallback callback,
                                     net::HttpRequestHeaders* headers) {
+  rules_.OnBeforeSendHeaders(info->url, headers);
   return HandleResponseEvent(
       kOnBeforeSendHeaders, info,
       base::BindOnce(std::move(callback), std::set<std::string>(),
@@ -292,6 +483,10 @@ int WebRequest::OnHeadersReceived(
     const net::HttpResponseHeaders* original_response_headers,
     scoped_refptr<net::HttpResponseHeaders>* override_response_headers,
     GURL* allowed_unsafe_redirect_url) {
+  scoped_refptr<net::HttpResponseHeaders> headers =
+      rules_.OnHeadersReceived(info->url, original_response_headers);
+  if (headers)
+    *override_response_headers = headers;
   return HandleResponseEvent(
       kOnHeadersReceived, info, std::move(callback),
       std::make_pair(override_response_headers,
@@ -349,35 +544,19 @@ void WebRequest::SetListener(Event event,
   v8::Local<v8::Value> arg;
 
   // { urls }.
-  std::set<std::string> filter_patterns;
+  std::set<URLPattern> patterns;
   gin::Dictionary dict(args->isolate());
   if (args->GetNext(&arg) && !arg->IsFunction()) {
     // Note that gin treats Function as Dictionary when doing convertions, so we
     // have to explicitly check if the argument is Function before trying to
     // convert it to Dictionary.
     if (gin::ConvertFromV8(args->isolate(), arg, &dict)) {
-      if (!dict.Get("urls", &filter_patterns)) {
-        args->ThrowTypeError("Parameter 'filter' must have property 'urls'.");
+      if (!GetURLPatterns(args, dict, &patterns))
         return;
-      }
       args->GetNext(&arg);
     }
   }
 
-  std::set<URLPattern> patterns;
-  for (const std::string& filter_pattern : filter_patterns) {
-    URLPattern pattern(URLPattern::SCHEME_ALL);
-    const URLPattern::ParseResult result = pattern.Parse(filter_pattern);
-    if (result == URLPattern::ParseResult::kSuccess) {
-      patterns.insert(pattern);
-    } else {
-      const char* error_type = URLPattern::GetParseResultString(result);
-      args->ThrowTypeError("Invalid url pattern " + filter_pattern + ": " +
-                           error_type);
-      return;
-    }
-  }
-
   // Function or null.
   Listener listener;
   if (arg.IsEmpty() ||
@@ -389,13 +568,130 @@ void WebRequest::SetListener(Event event,
   if (listener.is_null())
     listeners->erase(event);
   else
-    (*listeners)[event] = {std::move(patterns), std::move(listener)};
+    (*listeners)[event] = {patterns, std::move(listener)};
+}
+
+void WebRequest::SetRules(gin::Arguments* args) {
+  std::vector<v8::Local<v8::Value>> rules;
+  if (!args->GetNext(&rules)) {
+    args->ThrowTypeError("Must pass an Array of rules");
+    return;
+  }
+
+  WebRequestRules parsed_rules;
+  for (v8::Local<v8::Value> value : rules) {
+    gin::Dictionary dict(args->isolate());
+    if (value->IsFunction() ||
+        !gin::ConvertFromV8(args->isolate(), value, &dict)) {
+      args->ThrowTypeError("Each rule must be an Object");
+      return;
+    }
+
+    std::set<URLPattern> patterns;
+    if (!GetURLPatterns(args, dict, &patterns))
+      return;
+
+    WebRequestRule rule;
+    std::string action;
+    dict.Get("action", &action);
+    if (action == "block") {
+      rule.action = WebRequestRule::Action::kBlock;
+    } else if (action == "redirect") {
+      rule.action = WebRequestRule::Action::kRedirect;
+      if (!dict.Get("redirectURL", &rule.redirect_url) ||
+          !rule.redirect_url.is_valid()) {
+        args->ThrowTypeError("Redirect rules must have a valid 'redirectURL'");
+        return;
+      }
+    } else if (action == "modifyHeaders") {
+      rule.action = WebRequestRule::Action::kModifyHeaders;
+      dict.Get("requestHeaders", &rule.set_request_headers);
+      dict.Get("removeRequestHeaders", &rule.remove_request_headers);
+      dict.Get("responseHeaders", &rule.set_response_headers);
+      dict.Get("removeResponseHeaders", &rule.remove_response_headers);
+    } else {
+      args->ThrowTypeError("Invalid rule action: " + action);
+      return;
+    }
+    parsed_rules.AddRule(patterns, std::move(rule));
+  }
+
+  rules_ = std::move(parsed_rules);
+}
+
+v8::Local<v8::Promise> WebRequest::SetWorker(gin::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  v8::Local<v8::Value> arg;
+  std::string source;
+  if (!args->GetNext(&arg) ||
+      !(arg->IsNull() || gin::ConvertFromV8(isolate, arg, &source))) {
+    args->ThrowTypeError("Must pass null or the source of the worker");
+    return v8::Local<v8::Promise>();
+  }
+  bool stop = arg->IsNull();
+
+  WebRequestWorker::MessageCallback on_message;
+  if (args->GetNext(&arg) && !arg->IsUndefined() &&
+      !gin::ConvertFromV8(isolate, arg, &on_message)) {
+    args->ThrowTypeError("Parameter 'onMessage' must be a Function");
+    return v8::Local<v8::Promise>();
+  }
+
+  gin_helper::Promise<void> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // Requests waiting for the old worker continue unmodified.
+  worker_.reset();
+  if (stop) {
+    promise.Resolve();
+    return handle;
+  }
+
+  worker_ = std::make_unique<WebRequestWorker>(on_message);
+  worker_->Start(source, base::BindOnce(&WebRequest::OnWorkerStarted,
+                                        base::Unretained(this), worker_.get(),
+                                        std::move(promise)));
+  return handle;
+}
+
+void WebRequest::PostMessageToWorker(gin::Arguments* args) {
+  base::Value message;
+  if (!args->GetNext(&message)) {
+    args->ThrowTypeError("Must pass a serializable message");
+    return;
+  }
+  if (!worker_) {
+    gin_helper::ErrorThrower(args->isolate())
+        .ThrowError("No worker has been set");
+    return;
+  }
+  worker_->PostMessage(std::move(message));
+}
+
+void WebRequest::OnWorkerStarted(WebRequestWorker* worker,
+                                 gin_helper::Promise<void> promise,
+                                 const std::string& error) {
+  if (error.empty()) {
+    promise.Resolve();
+    return;
+  }
+  // Do not keep a worker whose script failed, unless it was replaced already.
+  if (worker_.get() == worker)
+    worker_.reset();
+  promise.RejectWithErrorMessage(error);
 }
 
 template <typename... Args>
 void WebRequest::HandleSimpleEvent(SimpleEvent event,
                                    extensions::WebRequestInfo* request_info,
                                    Args... args) {
+  if (worker_ &&
+      worker_->HasListener(kSimpleEventNames[event], request_info->url)) {
+    base::DictionaryValue details;
+    FillDetails(&details, request_info, args...);
+    worker_->DispatchEvent(kSimpleEventNames[event], std::move(details));
+  }
+
   const auto iter = simple_listeners_.find(event);
   if (iter == std::end(simple_listeners_))
     return;
@@ -417,6 +713,19 @@ int WebRequest::HandleResponseEvent(ResponseEvent event,
                                     net::CompletionOnceCallback callback,
                                     Out out,
                                     Args... args) {
+  if (worker_ &&
+      worker_->HasListener(kResponseEventNames[event], request_info->url)) {
+    callbacks_[request_info->id] = std::move(callback);
+
+    base::DictionaryValue details;
+    FillDetails(&details, request_info, args...);
+    worker_->DispatchEvent(
+        kResponseEventNames[event], std::move(details),
+        base::BindOnce(&WebRequest::OnWorkerListenerResult<Out>,
+                       base::Unretained(this), request_info->id, out));
+    return net::ERR_IO_PENDING;
+  }
+
   const auto iter = response_listeners_.find(event);
   if (iter == std::end(response_listeners_))
     return net::OK;
@@ -460,10 +769,33 @@ void WebRequest::OnListenerResult(uint64_t id,
       ReadFromResponse(isolate, &dict, out);
   }
 
+  ContinueRequest(id, result);
+}
+
+template <typename T>
+void WebRequest::OnWorkerListenerResult(uint64_t id,
+                                        T out,
+                                        base::Value response) {
+  if (!base::Contains(callbacks_, id))
+    return;
+
+  int result = net::OK;
+  if (response.is_dict()) {
+    if (response.FindBoolKey("cancel").value_or(false))
+      result = net::ERR_BLOCKED_BY_CLIENT;
+    else
+      ReadFromResponse(response, out);
+  }
+
+  ContinueRequest(id, result);
+}
+
+void WebRequest::ContinueRequest(uint64_t id, int result) {
+  const auto iter = callbacks_.find(id);
   // The ProxyingURLLoaderFactory expects the callback to be executed
   // asynchronously, because it used to work on IO thread before NetworkService.
   base::SequencedTaskRunnerHandle::Get()->PostTask(
-      FROM_HERE, base::BindOnce(std::move(callbacks_[id]), result));
+      FROM_HERE, base::BindOnce(std::move(iter->second), result));
   callbacks_.erase(iter);
 }
 
@@ -6,7 +6,9 @@
 #define SHELL_BROWSER_API_ATOM_API_WEB_REQUEST_H_
 
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
 
 #include "base/values.h"
 #include "extensions/common/url_pattern.h"
@@ -14,6 +16,10 @@
 #include "gin/handle.h"
 #include "gin/wrappable.h"
 #include "shell/browser/net/proxying_url_loader_factory.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+#include "shell/browser/net/web_request_rules.h"
+#include "shell/browser/net/web_request_worker.h"
+#include "shell/common/gin_helper/promise.h"
 
 namespace content {
 class BrowserContext;
@@ -110,6 +116,13 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   template <typename Listener, typename Listeners, typename Event>
   void SetListener(Event event, Listeners* listeners, gin::Arguments* args);
 
+  void SetRules(gin::Arguments* args);
+  v8::Local<v8::Promise> SetWorker(gin::Arguments* args);
+  void PostMessageToWorker(gin::Arguments* args);
+  void OnWorkerStarted(WebRequestWorker* worker,
+                       gin_helper::Promise<void> promise,
+                       const std::string& error);
+
   template <typename... Args>
   void HandleSimpleEvent(SimpleEvent event,
                          extensions::WebRequestInfo* info,
@@ -123,29 +136,46 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
 
   template <typename T>
   void OnListenerResult(uint64_t id, T out, v8::Local<v8::Value> response);
+  template <typename T>
+  void OnWorkerListenerResult(uint64_t id, T out, base::Value response);
+  void ContinueRequest(uint64_t id, int result);
 
   struct SimpleListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     SimpleListener listener;
 
-    SimpleListenerInfo(std::set<URLPattern>, SimpleListener);
+    SimpleListenerInfo(const std::set<URLPattern>&, SimpleListener);
     SimpleListenerInfo();
+    SimpleListenerInfo(SimpleListenerInfo&&);
     ~SimpleListenerInfo();
+
+    SimpleListenerInfo& operator=(SimpleListenerInfo&&);
   };
 
   struct ResponseListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     ResponseListener listener;
 
-    ResponseListenerInfo(std::set<URLPattern>, ResponseListener);
+    ResponseListenerInfo(const std::set<URLPattern>&, ResponseListener);
     ResponseListenerInfo();
+    ResponseListenerInfo(ResponseListenerInfo&&);
     ~ResponseListenerInfo();
+
+    ResponseListenerInfo& operator=(ResponseListenerInfo&&);
   };
 
   std::map<SimpleEvent, SimpleListenerInfo> simple_listeners_;
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
 
+  // Declarative rules, applied before the listeners are called.
+  WebRequestRules rules_;
+
+  // Runs the listeners set by the worker script. For the events that wait
+  // for a response, a matching worker listener takes precedence over the
+  // listener set in the main process.
+  std::unique_ptr<WebRequestWorker> worker_;
+
   // Weak-ref, it manages us.
   content::BrowserContext* browser_context_;
 };
@@ -0,0 +1,105 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/ipc_traffic_stats.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/bits.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+base::Value CounterToValue(uint64_t count, uint64_t bytes) {
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetKey("count", base::Value(static_cast<double>(count)));
+  value.SetKey("bytes", base::Value(static_cast<double>(bytes)));
+  return value;
+}
+
+}  // namespace
+
+IpcTrafficStats::IpcTrafficStats() = default;
+
+IpcTrafficStats::~IpcTrafficStats() = default;
+
+void IpcTrafficStats::Record(Direction direction,
+                             const std::string& channel,
+                             size_t bytes,
+                             base::TimeDelta dispatch_time) {
+  auto& stats = channels_[channel];
+  auto& counter =
+      direction == Direction::kReceived ? stats.received : stats.sent;
+  counter.count++;
+  counter.bytes += bytes;
+
+  // Only messages dispatched in this process carry a dispatch time.
+  if (direction != Direction::kReceived)
+    return;
+
+  int64_t micros = std::max<int64_t>(dispatch_time.InMicroseconds(), 0);
+  size_t bucket = 0;
+  if (micros > 0) {
+    uint32_t clamped = static_cast<uint32_t>(
+        std::min<int64_t>(micros, std::numeric_limits<uint32_t>::max()));
+    bucket = std::min<size_t>(base::bits::Log2Floor(clamped) + 1,
+                              kBucketCount - 1);
+  }
+  stats.buckets[bucket]++;
+  stats.samples++;
+  stats.max_dispatch_time = std::max(stats.max_dispatch_time, dispatch_time);
+}
+
+void IpcTrafficStats::Reset() {
+  channels_.clear();
+}
+
+// static
+double IpcTrafficStats::Percentile(const ChannelStats& stats,
+                                   double percentile) {
+  if (stats.samples == 0)
+    return 0;
+  uint64_t target = static_cast<uint64_t>(stats.samples * percentile);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += stats.buckets[i];
+    if (seen > target) {
+      // Report the upper bound of the bucket, but never more than the
+      // largest sample actually observed.
+      double upper_ms = i == 0 ? 0 : static_cast<double>(1ull << i) / 1000.0;
+      return std::min(upper_ms, stats.max_dispatch_time.InMillisecondsF());
+    }
+  }
+  return stats.max_dispatch_time.InMillisecondsF();
+}
+
+base::Value IpcTrafficStats::ToValue() const {
+  base::Value result(base::Value::Type::DICTIONARY);
+  for (const auto& it : channels_) {
+    const ChannelStats& stats = it.second;
+    base::Value dispatch_time(base::Value::Type::DICTIONARY);
+    dispatch_time.SetKey("p50", base::Value(Percentile(stats, 0.5)));
+    dispatch_time.SetKey("p90", base::Value(Percentile(stats, 0.9)));
+    dispatch_time.SetKey("p99", base::Value(Percentile(stats, 0.99)));
+    dispatch_time.SetKey(
+        "max", base::Value(stats.max_dispatch_time.InMillisecondsF()));
+
+    base::Value channel(base::Value::Type::DICTIONARY);
+    channel.SetKey("received",
+                   CounterToValue(stats.received.count, stats.received.bytes));
+    channel.SetKey("sent", CounterToValue(stats.sent.count, stats.sent.bytes));
+    channel.SetKey("dispatchTime", std::move(dispatch_time));
+    result.SetKey(it.first, std::move(channel));
+  }
+  return result;
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,79 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_IPC_TRAFFIC_STATS_H_
+#define SHELL_BROWSER_API_IPC_TRAFFIC_STATS_H_
+
+#include <array>
+#include <map>
+#include <string>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/values.h"
+
+namespace electron {
+
+namespace api {
+
+// Accumulates per-channel IPC counters for a single WebContents.
+//
+// Recording is meant to be cheap enough to stay always on: one map lookup
+// and a handful of integer updates per message. Dispatch times are kept in
+// a fixed power-of-two histogram so percentiles can be reported without
+// storing individual samples.
+class IpcTrafficStats {
+ public:
+  enum class Direction {
+    kReceived,  // renderer -> main
+    kSent,      // main -> renderer
+  };
+
+  IpcTrafficStats();
+  ~IpcTrafficStats();
+
+  // Records one message of |bytes| serialized size on |channel|.
+  void Record(Direction direction,
+              const std::string& channel,
+              size_t bytes,
+              base::TimeDelta dispatch_time = base::TimeDelta());
+
+  // Clears all counters.
+  void Reset();
+
+  // Returns a dictionary keyed by channel name, see the docs of
+  // webContents.getIPCStats() for the layout.
+  base::Value ToValue() const;
+
+ private:
+  // Bucket i holds dispatch times in [2^(i-1), 2^i) microseconds, the last
+  // bucket catches everything above.
+  static constexpr size_t kBucketCount = 32;
+
+  struct Counter {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+  };
+
+  struct ChannelStats {
+    Counter received;
+    Counter sent;
+    std::array<uint32_t, kBucketCount> buckets = {};
+    uint64_t samples = 0;
+    base::TimeDelta max_dispatch_time;
+  };
+
+  // Returns the approximate dispatch time at |percentile| in milliseconds.
+  static double Percentile(const ChannelStats& stats, double percentile);
+
+  std::map<std::string, ChannelStats> channels_;
+
+  DISALLOW_COPY_AND_ASSIGN(IpcTrafficStats);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_IPC_TRAFFIC_STATS_H_
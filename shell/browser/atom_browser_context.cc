@@ -38,6 +38,8 @@
 #include "shell/browser/atom_paths.h"
 #include "shell/browser/atom_permission_manager.h"
 #include "shell/browser/cookie_change_notifier.h"
+#include "shell/browser/net/network_emulator.h"
+#include "shell/browser/net/network_warmup.h"
 #include "shell/browser/net/resolve_proxy_helper.h"
 #include "shell/browser/pref_store_delegate.h"
 #include "shell/browser/special_storage_policy.h"
@@ -187,6 +189,7 @@ void AtomBrowserContext::InitPrefs() {
   InspectableWebContentsImpl::RegisterPrefs(registry.get());
   MediaDeviceIDSalt::RegisterPrefs(registry.get());
   ZoomLevelDelegate::RegisterPrefs(registry.get());
+  NetworkWarmup::RegisterPrefs(registry.get());
   PrefProxyConfigTrackerImpl::RegisterPrefs(registry.get());
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   extensions::ExtensionPrefs::RegisterProfilePrefs(registry.get());
@@ -304,6 +307,18 @@ predictors::PreconnectManager* AtomBrowserContext::GetPreconnectManager() {
   return preconnect_manager_.get();
 }
 
+NetworkWarmup* AtomBrowserContext::GetNetworkWarmup() {
+  if (!network_warmup_.get())
+    network_warmup_ = std::make_unique<NetworkWarmup>(this);
+  return network_warmup_.get();
+}
+
+NetworkEmulator* AtomBrowserContext::GetNetworkEmulator() {
+  if (!network_emulator_.get())
+    network_emulator_ = std::make_unique<NetworkEmulator>(this);
+  return network_emulator_.get();
+}
+
 scoped_refptr<network::SharedURLLoaderFactory>
 AtomBrowserContext::GetURLLoaderFactory() {
   if (url_loader_factory_)
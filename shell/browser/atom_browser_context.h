@@ -44,6 +44,8 @@ class AtomBrowserContext;
 class AtomDownloadManagerDelegate;
 class AtomPermissionManager;
 class CookieChangeNotifier;
+class NetworkEmulator;
+class NetworkWarmup;
 class ResolveProxyHelper;
 class SpecialStoragePolicy;
 class WebViewManager;
@@ -91,6 +93,8 @@ class AtomBrowserContext
   int GetMaxCacheSize() const;
   ResolveProxyHelper* GetResolveProxyHelper();
   predictors::PreconnectManager* GetPreconnectManager();
+  NetworkWarmup* GetNetworkWarmup();
+  NetworkEmulator* GetNetworkEmulator();
   scoped_refptr<network::SharedURLLoaderFactory> GetURLLoaderFactory();
 
   // content::BrowserContext:
@@ -171,6 +175,8 @@ class AtomBrowserContext
   std::unique_ptr<ProxyConfigMonitor> proxy_config_monitor_;
 
   std::unique_ptr<predictors::PreconnectManager> preconnect_manager_;
+  std::unique_ptr<NetworkWarmup> network_warmup_;
+  std::unique_ptr<NetworkEmulator> network_emulator_;
 
   std::string user_agent_;
   base::FilePath path_;
@@ -78,6 +78,7 @@ class AtomBrowserMainParts : public content::BrowserMainParts {
   IconManager* GetIconManager();
 
   Browser* browser() { return browser_.get(); }
+  JavascriptEnvironment* js_env() { return js_env_.get(); }
   BrowserProcessImpl* browser_process() { return fake_browser_process_.get(); }
 
  protected:
@@ -8,14 +8,27 @@
 #include <string>
 #include <utility>
 
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
 #include "base/guid.h"
+#include "base/i18n/time_formatting.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/post_task.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/storage_partition.h"
 #include "mojo/public/cpp/bindings/binding.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
 #include "mojo/public/cpp/system/string_data_source.h"
+#include "net/base/escape.h"
 #include "net/base/filename_util.h"
+#include "net/base/mime_util.h"
+#include "net/http/http_byte_range.h"
 #include "net/http/http_status_code.h"
+#include "net/http/http_util.h"
 #include "services/network/public/cpp/url_loader_completion_status.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "shell/browser/api/atom_api_session.h"
@@ -23,10 +36,13 @@
 #include "shell/browser/net/asar/asar_url_loader.h"
 #include "shell/browser/net/node_stream_loader.h"
 #include "shell/browser/net/url_pipe_loader.h"
+#include "shell/common/asar/archive.h"
+#include "shell/common/asar/asar_util.h"
 #include "shell/common/atom_constants.h"
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
+#include "shell/common/gin_converters/std_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 
 #include "shell/common/node_includes.h"
@@ -139,13 +155,53 @@ network::ResourceResponseHead ToResponseHead(
   return head;
 }
 
-// Helper to write string to pipe.
+// Guesses the mime type of an asset from the extension of its |key|.
+bool GetMimeTypeFromExtension(const std::string& key, std::string* mime_type) {
+  base::FilePath::StringType extension =
+      base::FilePath::FromUTF8Unsafe(key).Extension();
+  if (extension.empty())
+    return false;
+  return net::GetWellKnownMimeTypeFromExtension(extension.substr(1),
+                                                mime_type);
+}
+
+// Exposes the backing store of a Buffer as RefCountedMemory, so the response
+// can be written into the data pipe without copying the Buffer first.
+//
+// The backing store is shared with the Buffer, changing the Buffer while the
+// response is being sent also changes the response.
+class BufferMemory : public base::RefCountedMemory {
+ public:
+  explicit BufferMemory(v8::Local<v8::ArrayBufferView> view)
+      : backing_store_(view->Buffer()->GetBackingStore()),
+        offset_(view->ByteOffset()),
+        length_(view->ByteLength()) {}
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override {
+    return static_cast<const unsigned char*>(backing_store_->Data()) + offset_;
+  }
+  size_t size() const override { return length_; }
+
+ private:
+  ~BufferMemory() override = default;
+
+  std::shared_ptr<v8::BackingStore> backing_store_;
+  size_t offset_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferMemory);
+};
+
+// Helper to write memory to pipe.
 struct WriteData {
   network::mojom::URLLoaderClientPtr client;
-  std::string data;
+  scoped_refptr<base::RefCountedMemory> data;
   std::unique_ptr<mojo::DataPipeProducer> producer;
 };
 
+// Runs on the sequence that started the write, so |write_data| and with it
+// the Buffer backing store are released there.
 void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
   if (result != MOJO_RESULT_OK) {
     network::URLLoaderCompletionStatus status(net::ERR_FAILED);
@@ -153,18 +209,269 @@ void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
   }
 
   network::URLLoaderCompletionStatus status(net::OK);
-  status.encoded_data_length = write_data->data.size();
-  status.encoded_body_length = write_data->data.size();
-  status.decoded_body_length = write_data->data.size();
+  status.encoded_data_length = write_data->data->size();
+  status.encoded_body_length = write_data->data->size();
+  status.decoded_body_length = write_data->data->size();
   write_data->client->OnComplete(status);
 }
 
+// Returns the ETag and modification time of |path|, which may point into an
+// asar archive. Must be called on a sequence that allows blocking.
+bool GetStaticFileInfo(const base::FilePath& path,
+                       std::string* etag,
+                       base::Time* last_modified,
+                       int64_t* size) {
+  base::FilePath asar_path, relative_path;
+  if (!asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    base::File::Info info;
+    if (!base::GetFileInfo(path, &info) || info.is_directory)
+      return false;
+    *etag = base::StringPrintf(
+        "\"%" PRIx64 "-%" PRIx64 "\"", static_cast<uint64_t>(info.size),
+        static_cast<uint64_t>(
+            info.last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds()));
+    *last_modified = info.last_modified;
+    *size = info.size;
+    return true;
+  }
+
+  // Files in an archive change together with the archive, so its modification
+  // time plus the position of the file identify the contents.
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  asar::Archive::FileInfo file_info;
+  base::File::Info info;
+  if (!archive || !archive->GetFileInfo(relative_path, &file_info) ||
+      !base::GetFileInfo(asar_path, &info))
+    return false;
+  *etag = base::StringPrintf(
+      "\"%" PRIx64 "-%x-%" PRIx64 "\"", file_info.offset, file_info.size,
+      static_cast<uint64_t>(
+          info.last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds()));
+  *last_modified = info.last_modified;
+  *size = file_info.size;
+  return true;
+}
+
+// Whether the "If-None-Match" header of |request| matches |etag|.
+bool MatchesIfNoneMatch(const network::ResourceRequest& request,
+                        const std::string& etag) {
+  std::string if_none_match;
+  if (!request.headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                 &if_none_match))
+    return false;
+  for (const base::StringPiece& tag :
+       base::SplitStringPiece(if_none_match, ",", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    // Weak comparison, as specified for If-None-Match.
+    base::StringPiece value = tag;
+    if (value.starts_with("W/"))
+      value.remove_prefix(2);
+    if (value == "*" || value == etag)
+      return true;
+  }
+  return false;
+}
+
+// Sets "206 Partial Content" and "Content-Range" for a request of a single
+// byte range. Invalid ranges are rejected later by the asar loader.
+void AddContentRange(const network::ResourceRequest& request,
+                     int64_t size,
+                     net::HttpResponseHeaders* headers) {
+  std::string range_header;
+  std::vector<net::HttpByteRange> ranges;
+  if (!request.headers.GetHeader(net::HttpRequestHeaders::kRange,
+                                 &range_header) ||
+      !net::HttpUtil::ParseRangeHeader(range_header, &ranges) ||
+      ranges.size() != 1 || !ranges[0].ComputeBounds(size))
+    return;
+  headers->ReplaceStatusLine("HTTP/1.1 206 Partial Content");
+  headers->AddHeader(base::StringPrintf(
+      "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+      ranges[0].first_byte_position(), ranges[0].last_byte_position(), size));
+}
+
+// Completes |client| with an empty body.
+void SendEmptyResponse(network::mojom::URLLoaderClientPtr client,
+                       const network::ResourceResponseHead& head) {
+  client->OnReceiveResponse(head);
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (mojo::CreateDataPipe(nullptr, &producer, &consumer) != MOJO_RESULT_OK) {
+    client->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
+    return;
+  }
+  producer.reset();  // The data pipe is empty.
+  client->OnStartLoadingResponseBody(std::move(consumer));
+  client->OnComplete(network::URLLoaderCompletionStatus(net::OK));
+}
+
 }  // namespace
 
+ProtocolAssetTable::Asset::Asset() = default;
+ProtocolAssetTable::Asset::Asset(const Asset&) = default;
+ProtocolAssetTable::Asset::~Asset() = default;
+
+ProtocolAssetTable::ProtocolAssetTable() = default;
+
+ProtocolAssetTable::~ProtocolAssetTable() = default;
+
+// static
+scoped_refptr<ProtocolAssetTable> ProtocolAssetTable::Create(
+    const gin_helper::Dictionary& table,
+    std::string* error) {
+  v8::Isolate* isolate = table.isolate();
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Array> keys;
+  if (!table.GetHandle()->GetOwnPropertyNames(context).ToLocal(&keys)) {
+    *error = "Invalid asset table";
+    return nullptr;
+  }
+
+  scoped_refptr<ProtocolAssetTable> assets(new ProtocolAssetTable);
+  for (uint32_t i = 0; i < keys->Length(); ++i) {
+    v8::Local<v8::Value> key_value;
+    std::string key;
+    v8::Local<v8::Value> value;
+    if (!keys->Get(context, i).ToLocal(&key_value) ||
+        !gin::ConvertFromV8(isolate, key_value, &key) ||
+        !table.Get(key, &value)) {
+      *error = "Invalid asset table";
+      return nullptr;
+    }
+
+    // Either a Buffer, or a MimeTypedBuffer with |data| and response options.
+    gin_helper::Dictionary dict;
+    v8::Local<v8::Value> data = value;
+    if (!node::Buffer::HasInstance(value)) {
+      dict = ToDict(isolate, value);
+      if (dict.IsEmpty() || !dict.Get("data", &data)) {
+        *error = "Invalid asset for " + key;
+        return nullptr;
+      }
+    }
+
+    std::string contents;
+    if (node::Buffer::HasInstance(data)) {
+      contents.assign(node::Buffer::Data(data), node::Buffer::Length(data));
+    } else if (!gin::ConvertFromV8(isolate, data, &contents)) {
+      *error = "Invalid asset for " + key;
+      return nullptr;
+    }
+
+    Asset asset;
+    asset.head = ToResponseHead(dict);
+    std::string mime_type;
+    if ((dict.IsEmpty() || !dict.Get("mimeType", &mime_type)) &&
+        GetMimeTypeFromExtension(key, &mime_type)) {
+      asset.head.mime_type = mime_type;
+      asset.head.headers->AddHeader("content-type: " + mime_type);
+    }
+    asset.data = base::RefCountedString::TakeString(&contents);
+    assets->assets_[key] = std::move(asset);
+  }
+  return assets;
+}
+
+const ProtocolAssetTable::Asset* ProtocolAssetTable::Find(
+    const GURL& url) const {
+  GURL::Replacements replacements;
+  replacements.ClearQuery();
+  replacements.ClearRef();
+  auto it = assets_.find(url.ReplaceComponents(replacements).spec());
+  if (it == assets_.end()) {
+    // URLs of non-standard schemes have no host, so "scheme://host/path" has
+    // "//host/path" as its path. Parse them like http URLs to get the path.
+    GURL standard_url =
+        url.IsStandard() ? url : GURL("http:" + url.GetContent());
+    it = assets_.find(standard_url.path());
+  }
+  return it == assets_.end() ? nullptr : &it->second;
+}
+
+ProtocolStaticRoot::ProtocolStaticRoot() = default;
+
+ProtocolStaticRoot::~ProtocolStaticRoot() = default;
+
+// static
+scoped_refptr<ProtocolStaticRoot> ProtocolStaticRoot::Create(
+    const gin_helper::Dictionary& options,
+    std::string* error) {
+  scoped_refptr<ProtocolStaticRoot> root(new ProtocolStaticRoot);
+  options.Get("root", &root->root_);
+  options.Get("hosts", &root->hosts_);
+  if (root->root_.empty() && root->hosts_.empty()) {
+    *error = "Must pass a 'root' or 'hosts'";
+    return nullptr;
+  }
+  if (!root->root_.empty() && !root->root_.IsAbsolute()) {
+    *error = "'root' must be an absolute path";
+    return nullptr;
+  }
+  for (const auto& it : root->hosts_) {
+    if (!it.second.IsAbsolute()) {
+      *error = "Invalid root for host " + it.first;
+      return nullptr;
+    }
+  }
+
+  std::string index = "index.html";
+  options.Get("index", &index);
+  root->index_ = base::FilePath::FromUTF8Unsafe(index);
+  root->cache_control_ = "no-cache";
+  options.Get("cacheControl", &root->cache_control_);
+  return root;
+}
+
+bool ProtocolStaticRoot::ResolvePath(const GURL& url,
+                                     base::FilePath* path) const {
+  // See ProtocolAssetTable::Find for why non-standard URLs are reparsed.
+  GURL standard_url =
+      url.IsStandard() ? url : GURL("http:" + url.GetContent());
+  auto it = hosts_.find(standard_url.host());
+  const base::FilePath& root = it == hosts_.end() ? root_ : it->second;
+  if (root.empty())
+    return false;
+
+  // The path has been normalized by GURL already, but escaped separators and
+  // dots would still allow to leave the root after unescaping.
+  std::string url_path = net::UnescapeURLComponent(
+      standard_url.path(),
+      net::UnescapeRule::SPACES | net::UnescapeRule::PATH_SEPARATORS |
+          net::UnescapeRule::URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS);
+  base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(
+      base::TrimString(url_path, "/", base::TRIM_LEADING));
+  if (relative_path.IsAbsolute() || relative_path.ReferencesParent())
+    return false;
+
+  *path = root.Append(relative_path);
+  if (url_path.empty() || url_path.back() == '/')
+    *path = path->Append(index_);
+  return true;
+}
+
 AtomURLLoaderFactory::AtomURLLoaderFactory(ProtocolType type,
                                            const ProtocolHandler& handler)
     : type_(type), handler_(handler) {}
 
+AtomURLLoaderFactory::AtomURLLoaderFactory(
+    ProtocolType type,
+    const ProtocolHandler& handler,
+    scoped_refptr<ProtocolResponseCache> cache)
+    : type_(type), handler_(handler), cache_(std::move(cache)) {}
+
+AtomURLLoaderFactory::AtomURLLoaderFactory(
+    scoped_refptr<ProtocolAssetTable> assets)
+    : type_(ProtocolType::kBuffer), assets_(std::move(assets)) {}
+
+AtomURLLoaderFactory::AtomURLLoaderFactory(
+    scoped_refptr<ProtocolStaticRoot> root,
+    const ProtocolHandler& miss_handler)
+    : type_(ProtocolType::kFile),
+      handler_(miss_handler),
+      static_root_(std::move(root)) {}
+
 AtomURLLoaderFactory::~AtomURLLoaderFactory() = default;
 
 void AtomURLLoaderFactory::CreateLoaderAndStart(
@@ -176,11 +483,106 @@ void AtomURLLoaderFactory::CreateLoaderAndStart(
     network::mojom::URLLoaderClientPtr client,
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (assets_) {
+    StartLoadingAsset(std::move(client), *assets_, request.url);
+    return;
+  }
+  if (static_root_) {
+    // Only the optional miss handler needs the UI thread, everything else
+    // happens on the thread pool.
+    StaticMissCallback on_miss;
+    if (!handler_.is_null())
+      on_miss = base::BindOnce(&AtomURLLoaderFactory::OnStaticFileMissing,
+                               weak_factory_.GetWeakPtr(), routing_id,
+                               request_id, options, request,
+                               traffic_annotation);
+    base::FilePath path;
+    if (!static_root_->ResolvePath(request.url, &path)) {
+      if (on_miss) {
+        std::move(on_miss).Run(std::move(loader), client.PassInterface());
+      } else {
+        client->OnComplete(
+            network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+      }
+      return;
+    }
+    // The client is bound on the task runner, which needs a sequence.
+    auto task_runner = base::CreateSequencedTaskRunner(
+        {base::ThreadPool(), base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+    task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&AtomURLLoaderFactory::StartLoadingStatic,
+                       std::move(loader), request, client.PassInterface(),
+                       static_root_, path, std::move(on_miss)));
+    return;
+  }
+  if (cache_ && cache_->enabled()) {
+    cache_->Lookup(
+        request,
+        base::BindOnce(&AtomURLLoaderFactory::OnCacheLookup,
+                       weak_factory_.GetWeakPtr(), std::move(loader),
+                       routing_id, request_id, options, request,
+                       std::move(client), traffic_annotation));
+    return;
+  }
+  RunHandler(std::move(loader), routing_id, request_id, options, request,
+             std::move(client), traffic_annotation);
+}
+
+void AtomURLLoaderFactory::RunHandler(
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    int32_t routing_id,
+    int32_t request_id,
+    uint32_t options,
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderClientPtr client,
+    const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
   handler_.Run(
       request,
       base::BindOnce(&AtomURLLoaderFactory::StartLoading, std::move(loader),
                      routing_id, request_id, options, request,
-                     std::move(client), traffic_annotation, nullptr, type_));
+                     std::move(client), traffic_annotation, nullptr, type_,
+                     cache_));
+}
+
+void AtomURLLoaderFactory::OnCacheLookup(
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    int32_t routing_id,
+    int32_t request_id,
+    uint32_t options,
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderClientPtr client,
+    const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+    std::unique_ptr<ProtocolResponseCache::Entry> entry) {
+  if (!entry) {
+    RunHandler(std::move(loader), routing_id, request_id, options, request,
+               std::move(client), traffic_annotation);
+    return;
+  }
+
+  // The recorded headers are the ones the response was first sent with, so
+  // they are replayed verbatim. Every request gets its own copy of them.
+  network::ResourceResponseHead head = entry->head;
+  head.headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      entry->head.headers->raw_headers());
+  SendContents(std::move(client), std::move(head), entry->body,
+               false /* add_cors_header */);
+}
+
+void AtomURLLoaderFactory::OnStaticFileMissing(
+    int32_t routing_id,
+    int32_t request_id,
+    uint32_t options,
+    const network::ResourceRequest& request,
+    const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    network::mojom::URLLoaderClientPtrInfo client_info) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  network::mojom::URLLoaderClientPtr client;
+  client.Bind(std::move(client_info));
+  RunHandler(std::move(loader), routing_id, request_id, options, request,
+             std::move(client), traffic_annotation);
 }
 
 void AtomURLLoaderFactory::Clone(
@@ -199,6 +601,7 @@ void AtomURLLoaderFactory::StartLoading(
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
     network::mojom::URLLoaderFactory* proxy_factory,
     ProtocolType type,
+    scoped_refptr<ProtocolResponseCache> cache,
     gin::Arguments* args) {
   // Send network error when there is no argument passed.
   //
@@ -253,7 +656,7 @@ void AtomURLLoaderFactory::StartLoading(
     } else {
       StartLoadingHttp(std::move(loader), new_request, std::move(client),
                        traffic_annotation,
-                       gin::Dictionary::CreateEmpty(args->isolate()));
+                       gin::Dictionary::CreateEmpty(args->isolate()), nullptr);
     }
     return;
   }
@@ -279,11 +682,13 @@ void AtomURLLoaderFactory::StartLoading(
       break;
     case ProtocolType::kHttp:
       StartLoadingHttp(std::move(loader), request, std::move(client),
-                       traffic_annotation, dict);
+                       traffic_annotation, dict,
+                       cache ? cache->CreateRecorder(request) : nullptr);
       break;
     case ProtocolType::kStream:
       StartLoadingStream(std::move(loader), std::move(client), std::move(head),
-                         dict);
+                         dict,
+                         cache ? cache->CreateRecorder(request) : nullptr);
       break;
     case ProtocolType::kFree:
       ProtocolType type;
@@ -293,7 +698,7 @@ void AtomURLLoaderFactory::StartLoading(
       }
       StartLoading(std::move(loader), routing_id, request_id, options, request,
                    std::move(client), traffic_annotation, proxy_factory, type,
-                   args);
+                   std::move(cache), args);
       break;
   }
 }
@@ -310,9 +715,9 @@ void AtomURLLoaderFactory::StartLoadingBuffer(
     return;
   }
 
-  SendContents(
-      std::move(client), std::move(head),
-      std::string(node::Buffer::Data(buffer), node::Buffer::Length(buffer)));
+  SendContents(std::move(client), std::move(head),
+               base::MakeRefCounted<BufferMemory>(
+                   buffer.As<v8::ArrayBufferView>()));
 }
 
 // static
@@ -332,7 +737,8 @@ void AtomURLLoaderFactory::StartLoadingString(
     return;
   }
 
-  SendContents(std::move(client), std::move(head), std::move(contents));
+  SendContents(std::move(client), std::move(head),
+               base::RefCountedString::TakeString(&contents));
 }
 
 // static
@@ -368,7 +774,8 @@ void AtomURLLoaderFactory::StartLoadingHttp(
     const network::ResourceRequest& original_request,
     network::mojom::URLLoaderClientPtr client,
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
-    const gin_helper::Dictionary& dict) {
+    const gin_helper::Dictionary& dict,
+    std::unique_ptr<ProtocolResponseCache::Recorder> recorder) {
   auto request = std::make_unique<network::ResourceRequest>();
   request->headers = original_request.headers;
   request->cors_exempt_headers = original_request.cors_exempt_headers;
@@ -401,7 +808,7 @@ void AtomURLLoaderFactory::StartLoadingHttp(
       browser_context->GetURLLoaderFactory(), std::move(request),
       std::move(loader), std::move(client),
       static_cast<net::NetworkTrafficAnnotationTag>(traffic_annotation),
-      std::move(upload_data));
+      std::move(upload_data), std::move(recorder));
 }
 
 // static
@@ -409,7 +816,8 @@ void AtomURLLoaderFactory::StartLoadingStream(
     mojo::PendingReceiver<network::mojom::URLLoader> loader,
     network::mojom::URLLoaderClientPtr client,
     network::ResourceResponseHead head,
-    const gin_helper::Dictionary& dict) {
+    const gin_helper::Dictionary& dict,
+    std::unique_ptr<ProtocolResponseCache::Recorder> recorder) {
   v8::Local<v8::Value> stream;
   if (!dict.Get("data", &stream)) {
     // Assume the opts is already a stream.
@@ -446,15 +854,87 @@ void AtomURLLoaderFactory::StartLoadingStream(
   }
 
   new NodeStreamLoader(std::move(head), std::move(loader), std::move(client),
-                       data.isolate(), data.GetHandle());
+                       data.isolate(), data.GetHandle(), std::move(recorder));
+}
+
+// static
+void AtomURLLoaderFactory::StartLoadingAsset(
+    network::mojom::URLLoaderClientPtr client,
+    const ProtocolAssetTable& assets,
+    const GURL& url) {
+  const ProtocolAssetTable::Asset* asset = assets.Find(url);
+  if (!asset) {
+    client->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
+  // The headers are modified when sending the response, so every request gets
+  // its own copy.
+  network::ResourceResponseHead head = asset->head;
+  head.headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      asset->head.headers->raw_headers());
+  SendContents(std::move(client), std::move(head), asset->data);
+}
+
+// static
+void AtomURLLoaderFactory::StartLoadingStatic(
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    network::ResourceRequest request,
+    network::mojom::URLLoaderClientPtrInfo client_info,
+    scoped_refptr<ProtocolStaticRoot> root,
+    base::FilePath path,
+    StaticMissCallback on_miss) {
+  std::string etag;
+  base::Time last_modified;
+  int64_t size;
+  if (!GetStaticFileInfo(path, &etag, &last_modified, &size)) {
+    if (on_miss) {
+      base::PostTask(FROM_HERE, {BrowserThread::UI},
+                     base::BindOnce(std::move(on_miss), std::move(loader),
+                                    std::move(client_info)));
+    } else {
+      network::mojom::URLLoaderClientPtr client;
+      client.Bind(std::move(client_info));
+      client->OnComplete(
+          network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+    }
+    return;
+  }
+
+  network::mojom::URLLoaderClientPtr client;
+  client.Bind(std::move(client_info));
+
+  network::ResourceResponseHead head;
+  head.headers = new net::HttpResponseHeaders("HTTP/1.1 200 OK");
+  head.headers->AddHeader(kCORSHeader);
+  head.headers->AddHeader("Accept-Ranges: bytes");
+  head.headers->AddHeader("ETag: " + etag);
+  head.headers->AddHeader("Last-Modified: " +
+                          base::TimeFormatHTTP(last_modified));
+  if (!root->cache_control().empty())
+    head.headers->AddHeader("Cache-Control: " + root->cache_control());
+
+  if (MatchesIfNoneMatch(request, etag)) {
+    head.headers->ReplaceStatusLine("HTTP/1.1 304 Not Modified");
+    SendEmptyResponse(std::move(client), head);
+    return;
+  }
+
+  AddContentRange(request, size, head.headers.get());
+  request.url = net::FilePathToFileURL(path);
+  asar::CreateAsarURLLoader(request, std::move(loader), std::move(client),
+                            head.headers);
 }
 
 // static
 void AtomURLLoaderFactory::SendContents(
     network::mojom::URLLoaderClientPtr client,
     network::ResourceResponseHead head,
-    std::string data) {
-  head.headers->AddHeader(kCORSHeader);
+    scoped_refptr<base::RefCountedMemory> data,
+    bool add_cors_header) {
+  if (add_cors_header)
+    head.headers->AddHeader(kCORSHeader);
   client->OnReceiveResponse(head);
 
   // Code bellow follows the pattern of data_url_loader_factory.cc.
@@ -474,7 +954,9 @@ void AtomURLLoaderFactory::SendContents(
   write_data->producer =
       std::make_unique<mojo::DataPipeProducer>(std::move(producer));
 
-  base::StringPiece string_piece(write_data->data);
+  base::StringPiece string_piece(
+      reinterpret_cast<const char*>(write_data->data->front()),
+      write_data->data->size());
   write_data->producer->Write(
       std::make_unique<mojo::StringDataSource>(
           string_piece, mojo::StringDataSource::AsyncWritingMode::
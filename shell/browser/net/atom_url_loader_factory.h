@@ -9,11 +9,16 @@
 #include <string>
 #include <utility>
 
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
 #include "net/url_request/url_request_job_factory.h"
 #include "services/network/public/cpp/resource_response.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
+#include "shell/browser/net/protocol_response_cache.h"
 #include "shell/common/gin_helper/dictionary.h"
 
 namespace electron {
@@ -36,10 +41,88 @@ using ProtocolHandler =
 using HandlersMap =
     std::map<std::string, std::pair<ProtocolType, ProtocolHandler>>;
 
+// Immutable in-memory responses of a buffer protocol, which are served
+// without calling into JavaScript for each request.
+class ProtocolAssetTable
+    : public base::RefCountedThreadSafe<ProtocolAssetTable> {
+ public:
+  struct Asset {
+    Asset();
+    Asset(const Asset&);
+    ~Asset();
+
+    network::ResourceResponseHead head;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+
+  // Builds the table from an object mapping URLs or paths to Buffers or
+  // MimeTypedBuffers. The contents are copied once, so later changes to the
+  // Buffers do not affect the responses. Returns nullptr and sets |error| if
+  // |table| is malformed.
+  static scoped_refptr<ProtocolAssetTable> Create(
+      const gin_helper::Dictionary& table,
+      std::string* error);
+
+  // Returns the asset for |url|, looked up by the URL without query and
+  // fragment first, and then by its path.
+  const Asset* Find(const GURL& url) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ProtocolAssetTable>;
+
+  ProtocolAssetTable();
+  ~ProtocolAssetTable();
+
+  std::map<std::string, Asset> assets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolAssetTable);
+};
+
+// Maps the URLs of a static protocol to files in a directory or an asar
+// archive. Immutable once created, so it can be used from any thread.
+class ProtocolStaticRoot
+    : public base::RefCountedThreadSafe<ProtocolStaticRoot> {
+ public:
+  // Builds the mapping from the options of registerStaticProtocol. Returns
+  // nullptr and sets |error| if |options| is malformed.
+  static scoped_refptr<ProtocolStaticRoot> Create(
+      const gin_helper::Dictionary& options,
+      std::string* error);
+
+  // Returns the file that serves |url|, or false if the host of |url| is not
+  // mapped or its path escapes the root.
+  bool ResolvePath(const GURL& url, base::FilePath* path) const;
+
+  const std::string& cache_control() const { return cache_control_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ProtocolStaticRoot>;
+
+  ProtocolStaticRoot();
+  ~ProtocolStaticRoot();
+
+  base::FilePath root_;
+  std::map<std::string, base::FilePath> hosts_;
+  base::FilePath index_;
+  std::string cache_control_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolStaticRoot);
+};
+
 // Implementation of URLLoaderFactory.
 class AtomURLLoaderFactory : public network::mojom::URLLoaderFactory {
  public:
   AtomURLLoaderFactory(ProtocolType type, const ProtocolHandler& handler);
+  // Answers requests from |cache| when possible, and records the responses
+  // of stream and HTTP handlers into it.
+  AtomURLLoaderFactory(ProtocolType type,
+                       const ProtocolHandler& handler,
+                       scoped_refptr<ProtocolResponseCache> cache);
+  explicit AtomURLLoaderFactory(scoped_refptr<ProtocolAssetTable> assets);
+  // Serves files under |root|, |miss_handler| is an optional file protocol
+  // handler called for requests that match no file.
+  AtomURLLoaderFactory(scoped_refptr<ProtocolStaticRoot> root,
+                       const ProtocolHandler& miss_handler);
   ~AtomURLLoaderFactory() override;
 
   // network::mojom::URLLoaderFactory:
@@ -65,9 +148,40 @@ class AtomURLLoaderFactory : public network::mojom::URLLoaderFactory {
       const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
       network::mojom::URLLoaderFactory* proxy_factory,
       ProtocolType type,
+      scoped_refptr<ProtocolResponseCache> cache,
       gin::Arguments* args);
 
  private:
+  using StaticMissCallback = base::OnceCallback<void(
+      mojo::PendingReceiver<network::mojom::URLLoader>,
+      network::mojom::URLLoaderClientPtrInfo)>;
+
+  void RunHandler(
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      int32_t routing_id,
+      int32_t request_id,
+      uint32_t options,
+      const network::ResourceRequest& request,
+      network::mojom::URLLoaderClientPtr client,
+      const net::MutableNetworkTrafficAnnotationTag& traffic_annotation);
+  void OnCacheLookup(
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      int32_t routing_id,
+      int32_t request_id,
+      uint32_t options,
+      const network::ResourceRequest& request,
+      network::mojom::URLLoaderClientPtr client,
+      const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+      std::unique_ptr<ProtocolResponseCache::Entry> entry);
+  void OnStaticFileMissing(
+      int32_t routing_id,
+      int32_t request_id,
+      uint32_t options,
+      const network::ResourceRequest& request,
+      const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      network::mojom::URLLoaderClientPtrInfo client_info);
+
   static void StartLoadingBuffer(network::mojom::URLLoaderClientPtr client,
                                  network::ResourceResponseHead head,
                                  const gin_helper::Dictionary& dict);
@@ -89,17 +203,34 @@ class AtomURLLoaderFactory : public network::mojom::URLLoaderFactory {
       const network::ResourceRequest& original_request,
       network::mojom::URLLoaderClientPtr client,
       const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
-      const gin_helper::Dictionary& dict);
+      const gin_helper::Dictionary& dict,
+      std::unique_ptr<ProtocolResponseCache::Recorder> recorder);
   static void StartLoadingStream(
       mojo::PendingReceiver<network::mojom::URLLoader> loader,
       network::mojom::URLLoaderClientPtr client,
       network::ResourceResponseHead head,
-      const gin_helper::Dictionary& dict);
+      const gin_helper::Dictionary& dict,
+      std::unique_ptr<ProtocolResponseCache::Recorder> recorder);
+  static void StartLoadingAsset(network::mojom::URLLoaderClientPtr client,
+                                const ProtocolAssetTable& assets,
+                                const GURL& url);
+  // Runs on a thread pool sequence, |on_miss| is null when there is no miss
+  // handler.
+  static void StartLoadingStatic(
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      network::ResourceRequest request,
+      network::mojom::URLLoaderClientPtrInfo client_info,
+      scoped_refptr<ProtocolStaticRoot> root,
+      base::FilePath path,
+      StaticMissCallback on_miss);
 
-  // Helper to send string as response.
+  // Helper to send memory as response, |data| is written into the data pipe
+  // directly and kept alive until the write completes. The CORS header is
+  // added unless |head| is replayed as it was first sent.
   static void SendContents(network::mojom::URLLoaderClientPtr client,
                            network::ResourceResponseHead head,
-                           std::string data);
+                           scoped_refptr<base::RefCountedMemory> data,
+                           bool add_cors_header = true);
 
   // TODO(zcbenz): This comes from extensions/browser/extension_protocols.cc
   // but I don't know what it actually does, find out the meanings of |Clone|
@@ -109,6 +240,18 @@ class AtomURLLoaderFactory : public network::mojom::URLLoaderFactory {
   ProtocolType type_;
   ProtocolHandler handler_;
 
+  // Set when serving a pre-registered asset table instead of |handler_|.
+  scoped_refptr<ProtocolAssetTable> assets_;
+
+  // Set when serving files of a static protocol, |handler_| is then only
+  // called for missing files.
+  scoped_refptr<ProtocolStaticRoot> static_root_;
+
+  // Responses of |handler_| cached for the scheme, may be null.
+  scoped_refptr<ProtocolResponseCache> cache_;
+
+  base::WeakPtrFactory<AtomURLLoaderFactory> weak_factory_{this};
+
   DISALLOW_COPY_AND_ASSIGN(AtomURLLoaderFactory);
 };
 
@@ -0,0 +1,423 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/net_log_ring_buffer.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner_util.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/storage_partition.h"
+#include "shell/browser/atom_browser_context.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+
+namespace electron {
+
+namespace {
+
+// The buffer is made of this many segments, so at most a quarter of its
+// duration is still being written when a snapshot is taken.
+constexpr int kSegmentsPerBuffer = 4;
+constexpr base::TimeDelta kMinSegmentDuration = base::TimeDelta::FromSeconds(1);
+
+// Bounds the memory used by a busy session, the oldest events are dropped
+// first.
+constexpr size_t kMaxBufferedEvents = 100000;
+
+// Segments are truncated beyond this size.
+constexpr uint64_t kMaxSegmentSize = 50 * 1024 * 1024;
+
+// net::NetLogEventPhase::END.
+constexpr int kPhaseEnd = 2;
+
+// First bytes of a log in the binary format.
+const char kBinaryMagic[] = "ENLB";
+constexpr uint8_t kBinaryVersion = 1;
+
+// The time of net log events, in ms of base::TimeTicks.
+int64_t TicksNow() {
+  return (base::TimeTicks::Now() - base::TimeTicks()).InMilliseconds();
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendString(const std::string& value, std::string* out) {
+  AppendVarint(value.size(), out);
+  out->append(value);
+}
+
+}  // namespace
+
+class NetLogRingBuffer::Store {
+ public:
+  explicit Store(const Options& options) : options_(options) {
+    for (const URLPattern& pattern : options.url_patterns)
+      url_matcher_.AddPattern(pattern);
+  }
+
+  ~Store() {
+    if (!dir_.empty())
+      base::DeleteFileRecursively(dir_);
+  }
+
+  base::File OpenSegment(int id) {
+    if (dir_.empty() &&
+        !base::CreateNewTempDirectory(FILE_PATH_LITERAL("electron-net-log"),
+                                      &dir_))
+      return base::File();
+    return base::File(GetSegmentPath(id),
+                      base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  }
+
+  void AddSegment(int id) {
+    base::FilePath path = GetSegmentPath(id);
+    std::string contents;
+    bool success = base::ReadFileToString(path, &contents);
+    base::DeleteFile(path, false);
+    if (!success)
+      return;
+
+    // The exporter leaves a comma after the last event.
+    base::Optional<base::Value> log =
+        base::JSONReader::Read(contents, base::JSON_ALLOW_TRAILING_COMMAS);
+    if (!log || !log->is_dict())
+      return;
+    if (base::Value* constants = log->FindDictKey("constants"))
+      SetConstants(std::move(*constants));
+    if (base::Value* events = log->FindListKey("events"))
+      AddEvents(&events->GetList());
+    Trim(TicksNow() - options_.duration.InMilliseconds());
+  }
+
+  std::string WriteSnapshot(const base::FilePath& path,
+                            base::TimeDelta window,
+                            Format format) {
+    int64_t start = TicksNow() - window.InMilliseconds();
+    auto begin = std::find_if(
+        events_.begin(), events_.end(),
+        [start](const Event& event) { return event.time >= start; });
+    std::string data = format == Format::kBinary
+                           ? SerializeBinary(begin, events_.end())
+                           : SerializeJson(begin, events_.end());
+    base::File file(path,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+    if (!file.IsValid())
+      return base::File::ErrorToString(file.error_details());
+    if (file.WriteAtCurrentPos(data.data(), data.size()) !=
+        static_cast<int>(data.size()))
+      return "Failed to write the net log";
+    return std::string();
+  }
+
+ private:
+  struct Event {
+    int64_t time;
+    base::Value value;
+  };
+  // Source id, type and phase of an event.
+  using EventKey = std::tuple<int, int, int>;
+  using EventIterator = std::deque<Event>::const_iterator;
+
+  base::FilePath GetSegmentPath(int id) const {
+    return dir_.AppendASCII(base::StringPrintf("segment-%d.json", id));
+  }
+
+  void SetConstants(base::Value constants) {
+    event_types_.clear();
+    request_alive_type_ = -1;
+    if (const base::Value* types = constants.FindDictKey("logEventTypes")) {
+      for (const auto& it : types->DictItems()) {
+        if (!it.second.is_int())
+          continue;
+        if (options_.event_types.count(it.first))
+          event_types_.insert(it.second.GetInt());
+        if (it.first == "REQUEST_ALIVE")
+          request_alive_type_ = it.second.GetInt();
+      }
+    }
+    constants_ = std::move(constants);
+  }
+
+  void AddEvents(base::Value::ListStorage* events) {
+    // The URL of a request is only logged by some of its events, so find the
+    // requests first and then keep all of their events.
+    if (!url_matcher_.IsEmpty()) {
+      for (const base::Value& event : *events) {
+        const std::string* url = event.FindStringPath("params.url");
+        base::Optional<int> source = event.FindIntPath("source.id");
+        if (url && source && url_matcher_.Matches(GURL(*url)))
+          matched_sources_.insert(*source);
+      }
+    }
+
+    // Segments overlap a little, so that no event is missed between them.
+    // Events before the end of the previous segment are already buffered,
+    // and those in its last millisecond only if the previous segment saw
+    // them too.
+    int64_t previous_segment_end = segment_end_;
+    std::multiset<EventKey> previous_end_events = segment_end_events_;
+    for (base::Value& event : *events) {
+      if (!event.is_dict())
+        continue;
+      base::Optional<int> type = event.FindIntKey("type");
+      base::Optional<int> source = event.FindIntPath("source.id");
+      const std::string* time_string = event.FindStringKey("time");
+      int64_t time;
+      if (!type || !source || !time_string ||
+          !base::StringToInt64(*time_string, &time))
+        continue;
+      if (time < previous_segment_end)
+        continue;
+      EventKey key(*source, *type, event.FindIntKey("phase").value_or(0));
+      if (time == previous_segment_end) {
+        auto it = previous_end_events.find(key);
+        if (it != previous_end_events.end()) {
+          previous_end_events.erase(it);
+          continue;
+        }
+      }
+      if (time > segment_end_) {
+        segment_end_ = time;
+        segment_end_events_.clear();
+      }
+      if (time == segment_end_)
+        segment_end_events_.insert(key);
+
+      bool keep = (options_.event_types.empty() || event_types_.count(*type)) &&
+                  (url_matcher_.IsEmpty() || matched_sources_.count(*source));
+      if (*type == request_alive_type_ &&
+          event.FindIntKey("phase") == kPhaseEnd)
+        matched_sources_.erase(*source);
+      if (keep)
+        events_.push_back({time, std::move(event)});
+    }
+  }
+
+  void Trim(int64_t start) {
+    while (!events_.empty() && (events_.front().time < start ||
+                                events_.size() > kMaxBufferedEvents))
+      events_.pop_front();
+  }
+
+  // The format of the --log-net-log switch, which the net log viewer reads.
+  std::string SerializeJson(EventIterator begin, EventIterator end) const {
+    std::string data = "{\"constants\":";
+    std::string json;
+    base::JSONWriter::Write(constants_, &json);
+    data += json;
+    data += ",\n\"events\": [\n";
+    for (auto it = begin; it != end; ++it) {
+      base::JSONWriter::Write(it->value, &json);
+      data += json;
+      if (it + 1 != end)
+        data += ",";
+      data += "\n";
+    }
+    data += "]}\n";
+    return data;
+  }
+
+  // The magic bytes and a version byte, the constants as JSON, and then for
+  // each event: the time difference to the previous event, the type, the
+  // source id, the source type and the phase as varints, and the params as
+  // JSON. Strings are prefixed with their length, signed numbers are
+  // zigzag-encoded.
+  std::string SerializeBinary(EventIterator begin, EventIterator end) const {
+    std::string data(kBinaryMagic, sizeof(kBinaryMagic) - 1);
+    data.push_back(static_cast<char>(kBinaryVersion));
+    std::string json;
+    base::JSONWriter::Write(constants_, &json);
+    AppendString(json, &data);
+
+    int64_t previous_time = 0;
+    for (auto it = begin; it != end; ++it) {
+      const base::Value& event = it->value;
+      int64_t delta = it->time - previous_time;
+      previous_time = it->time;
+      AppendVarint(static_cast<uint64_t>((delta << 1) ^ (delta >> 63)), &data);
+      AppendVarint(event.FindIntKey("type").value_or(0), &data);
+      AppendVarint(event.FindIntPath("source.id").value_or(0), &data);
+      AppendVarint(event.FindIntPath("source.type").value_or(0), &data);
+      AppendVarint(event.FindIntKey("phase").value_or(0), &data);
+      json.clear();
+      if (const base::Value* params = event.FindDictKey("params"))
+        base::JSONWriter::Write(*params, &json);
+      AppendString(json, &data);
+    }
+    return data;
+  }
+
+  Options options_;
+  URLPatternMatcher url_matcher_;
+
+  base::FilePath dir_;
+
+  base::Value constants_{base::Value::Type::DICTIONARY};
+  // Ids of the event types to keep.
+  std::set<int> event_types_;
+  int request_alive_type_ = -1;
+
+  // Requests whose URL matched and that have not ended yet.
+  std::set<int> matched_sources_;
+  // Time of the last event read from the segments.
+  int64_t segment_end_ = 0;
+  // Keys of the events read in that millisecond.
+  std::multiset<EventKey> segment_end_events_;
+
+  std::deque<Event> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(Store);
+};
+
+NetLogRingBuffer::Options::Options() = default;
+NetLogRingBuffer::Options::Options(const Options&) = default;
+NetLogRingBuffer::Options::~Options() = default;
+
+NetLogRingBuffer::NetLogRingBuffer(
+    AtomBrowserContext* browser_context,
+    const Options& options,
+    base::Value constants,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner)
+    : browser_context_(browser_context),
+      options_(options),
+      constants_(std::move(constants)),
+      file_task_runner_(std::move(file_task_runner)),
+      store_(std::make_unique<Store>(options)) {}
+
+NetLogRingBuffer::~NetLogRingBuffer() {
+  file_task_runner_->DeleteSoon(FROM_HERE, std::move(store_));
+}
+
+void NetLogRingBuffer::Start() {
+  base::TimeDelta segment_duration =
+      std::max(options_.duration / kSegmentsPerBuffer, kMinSegmentDuration);
+  rotate_timer_.Start(FROM_HERE, segment_duration,
+                      base::BindRepeating(
+                          [](NetLogRingBuffer* self) {
+                            self->Rotate(base::OnceClosure());
+                          },
+                          base::Unretained(this)));
+  Rotate(base::OnceClosure());
+}
+
+void NetLogRingBuffer::Stop(base::OnceClosure callback) {
+  rotate_timer_.Stop();
+  // Drop the segments that are still being opened or closed.
+  weak_factory_.InvalidateWeakPtrs();
+  // Their snapshots would never be written.
+  std::map<int, SnapshotCallback> snapshots = std::move(pending_snapshots_);
+  pending_snapshots_.clear();
+  for (auto& it : snapshots)
+    std::move(it.second).Run("The ring buffer was stopped");
+  if (!exporter_) {
+    std::move(callback).Run();
+    return;
+  }
+  network::mojom::NetLogExporter* exporter = exporter_.get();
+  exporter->Stop(base::Value(base::Value::Type::DICTIONARY),
+                 base::BindOnce(
+                     [](network::mojom::NetLogExporterPtr,
+                        base::OnceClosure callback,
+                        int32_t error) { std::move(callback).Run(); },
+                     std::move(exporter_), std::move(callback)));
+}
+
+void NetLogRingBuffer::Snapshot(const base::FilePath& path,
+                                base::TimeDelta window,
+                                Format format,
+                                SnapshotCallback callback) {
+  // The callback is kept here rather than bound to the rotation, so Stop()
+  // can still run it after dropping the rotation.
+  int snapshot_id = next_snapshot_id_++;
+  pending_snapshots_[snapshot_id] = std::move(callback);
+  // Close the current segment, so the snapshot includes the latest events.
+  // The closure is only run by our weak-bound methods.
+  Rotate(base::BindOnce(&NetLogRingBuffer::WriteSnapshot,
+                        base::Unretained(this), snapshot_id, path, window,
+                        format));
+}
+
+void NetLogRingBuffer::Rotate(base::OnceClosure callback) {
+  int id = next_segment_id_++;
+  // |store_| is deleted on the same sequence after this task.
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&Store::OpenSegment, base::Unretained(store_.get()), id),
+      base::BindOnce(&NetLogRingBuffer::OnSegmentFileOpened,
+                     weak_factory_.GetWeakPtr(), id, std::move(callback)));
+}
+
+void NetLogRingBuffer::OnSegmentFileOpened(int id,
+                                           base::OnceClosure callback,
+                                           base::File file) {
+  network::mojom::NetLogExporterPtr previous = std::move(exporter_);
+  int previous_id = segment_id_;
+  if (file.IsValid()) {
+    content::BrowserContext::GetDefaultStoragePartition(browser_context_)
+        ->GetNetworkContext()
+        ->CreateNetLogExporter(mojo::MakeRequest(&exporter_));
+    exporter_->Start(std::move(file), constants_.Clone(),
+                     options_.capture_mode, kMaxSegmentSize,
+                     base::DoNothing());
+    segment_id_ = id;
+  }
+
+  // The new segment is started before the current one is stopped, so no
+  // events are lost in between.
+  if (!previous) {
+    if (callback)
+      std::move(callback).Run();
+    return;
+  }
+  network::mojom::NetLogExporter* exporter = previous.get();
+  exporter->Stop(base::Value(base::Value::Type::DICTIONARY),
+                 base::BindOnce(&NetLogRingBuffer::OnSegmentClosed,
+                                weak_factory_.GetWeakPtr(), std::move(previous),
+                                previous_id, std::move(callback)));
+}
+
+void NetLogRingBuffer::OnSegmentClosed(
+    network::mojom::NetLogExporterPtr exporter,
+    int id,
+    base::OnceClosure callback,
+    int32_t error) {
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Store::AddSegment,
+                                base::Unretained(store_.get()), id));
+  if (callback)
+    std::move(callback).Run();
+}
+
+void NetLogRingBuffer::WriteSnapshot(int snapshot_id,
+                                     const base::FilePath& path,
+                                     base::TimeDelta window,
+                                     Format format) {
+  auto it = pending_snapshots_.find(snapshot_id);
+  SnapshotCallback callback = std::move(it->second);
+  pending_snapshots_.erase(it);
+  // |store_| is deleted on the same sequence after this task.
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&Store::WriteSnapshot, base::Unretained(store_.get()),
+                     path, window, format),
+      std::move(callback));
+}
+
+}  // namespace electron
@@ -0,0 +1,121 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_NET_LOG_RING_BUFFER_H_
+#define SHELL_BROWSER_NET_NET_LOG_RING_BUFFER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "extensions/common/url_pattern.h"
+#include "net/log/net_log_capture_mode.h"
+#include "services/network/public/mojom/net_log.mojom.h"
+
+namespace electron {
+
+class AtomBrowserContext;
+
+// Keeps the most recent net log events of a session in memory, so they can
+// be written to disk after something went wrong without logging everything
+// to a file all the time.
+//
+// The network service only exports its net log to files, so the log is
+// recorded in short segments to a temporary directory. Each finished segment
+// is filtered, added to the in-memory buffer and deleted, and events older
+// than the buffer's duration are dropped.
+class NetLogRingBuffer {
+ public:
+  struct Options {
+    Options();
+    Options(const Options&);
+    ~Options();
+
+    net::NetLogCaptureMode capture_mode = net::NetLogCaptureMode::kDefault;
+    // How far back the buffer goes.
+    base::TimeDelta duration = base::TimeDelta::FromSeconds(60);
+    // Only keep events of these types, e.g. "URL_REQUEST_START_JOB".
+    std::set<std::string> event_types;
+    // Only keep events of the requests whose URL matches.
+    std::set<URLPattern> url_patterns;
+  };
+
+  enum class Format {
+    kJson,
+    kBinary,
+  };
+
+  // |error| is empty on success.
+  using SnapshotCallback = base::OnceCallback<void(const std::string& error)>;
+
+  NetLogRingBuffer(AtomBrowserContext* browser_context,
+                   const Options& options,
+                   base::Value constants,
+                   scoped_refptr<base::SequencedTaskRunner> file_task_runner);
+  ~NetLogRingBuffer();
+
+  void Start();
+
+  // Stops recording, the buffered events are dropped once |callback| runs.
+  // Snapshots that have not been written yet fail.
+  void Stop(base::OnceClosure callback);
+
+  // Writes the events of the last |window| to |path|.
+  void Snapshot(const base::FilePath& path,
+                base::TimeDelta window,
+                Format format,
+                SnapshotCallback callback);
+
+ private:
+  class Store;
+
+  // Starts a new segment, and adds the current one to the buffer. |callback|
+  // runs once the events of the current segment can be read from the store.
+  void Rotate(base::OnceClosure callback);
+  void OnSegmentFileOpened(int id, base::OnceClosure callback, base::File file);
+  void OnSegmentClosed(network::mojom::NetLogExporterPtr exporter,
+                       int id,
+                       base::OnceClosure callback,
+                       int32_t error);
+  void WriteSnapshot(int snapshot_id,
+                     const base::FilePath& path,
+                     base::TimeDelta window,
+                     Format format);
+
+  AtomBrowserContext* browser_context_;
+  Options options_;
+  base::Value constants_;
+
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  // Lives on |file_task_runner_|.
+  std::unique_ptr<Store> store_;
+
+  // Exports the current segment.
+  network::mojom::NetLogExporterPtr exporter_;
+  int segment_id_ = 0;
+  int next_segment_id_ = 0;
+  base::RepeatingTimer rotate_timer_;
+
+  // Snapshots waiting for the current segment to be added to the store.
+  std::map<int, SnapshotCallback> pending_snapshots_;
+  int next_snapshot_id_ = 0;
+
+  base::WeakPtrFactory<NetLogRingBuffer> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogRingBuffer);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_NET_LOG_RING_BUFFER_H_
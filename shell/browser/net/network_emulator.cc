@@ -0,0 +1,139 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/network_emulator.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/hash/hash.h"
+#include "base/strings/stringprintf.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/storage_partition.h"
+#include "net/base/net_errors.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "shell/browser/atom_browser_context.h"
+
+namespace electron {
+
+NetworkEmulator::Step::Step() = default;
+NetworkEmulator::Step::Step(Step&&) = default;
+NetworkEmulator::Step::~Step() = default;
+NetworkEmulator::Step& NetworkEmulator::Step::operator=(Step&&) = default;
+
+NetworkEmulator::Rule::Rule() = default;
+NetworkEmulator::Rule::Rule(Rule&&) = default;
+NetworkEmulator::Rule::~Rule() = default;
+NetworkEmulator::Rule& NetworkEmulator::Rule::operator=(Rule&&) = default;
+
+NetworkEmulator::Profile::Profile() = default;
+NetworkEmulator::Profile::Profile(Profile&&) = default;
+NetworkEmulator::Profile::~Profile() = default;
+NetworkEmulator::Profile& NetworkEmulator::Profile::operator=(Profile&&) =
+    default;
+
+NetworkEmulator::ActiveRule::ActiveRule()
+    : token(base::UnguessableToken::Create()) {}
+NetworkEmulator::ActiveRule::~ActiveRule() = default;
+
+NetworkEmulator::NetworkEmulator(AtomBrowserContext* browser_context)
+    : browser_context_(browser_context),
+      default_token_(base::UnguessableToken::Create()) {}
+
+NetworkEmulator::~NetworkEmulator() = default;
+
+void NetworkEmulator::SetDefaultConditions(
+    network::mojom::NetworkConditionsPtr conditions) {
+  // Null conditions also drop the throttling state of the network service.
+  has_default_conditions_ = !conditions.is_null();
+  SetConditions(default_token_, std::move(conditions));
+}
+
+void NetworkEmulator::SetProfile(Profile profile) {
+  ClearProfile();
+  seed_ = profile.seed;
+  for (size_t i = 0; i < profile.rules.size(); ++i) {
+    auto active_rule = std::make_unique<ActiveRule>();
+    active_rule->rule = std::move(profile.rules[i]);
+    active_rule->index = i;
+    for (const URLPattern& pattern : active_rule->rule.url_patterns)
+      active_rule->matcher.AddPattern(pattern);
+    ApplyStep(active_rule.get());
+    rules_.push_back(std::move(active_rule));
+  }
+}
+
+void NetworkEmulator::ClearProfile() {
+  for (const auto& active_rule : rules_)
+    SetConditions(active_rule->token, nullptr);
+  rules_.clear();
+}
+
+int NetworkEmulator::OnBeforeRequest(network::ResourceRequest* request) {
+  for (const auto& active_rule : rules_) {
+    if (!Matches(*active_rule, *request))
+      continue;
+    request->throttling_profile_id = active_rule->token;
+    return ShouldFail(active_rule.get()) ? net::ERR_CONNECTION_RESET
+                                         : net::OK;
+  }
+  if (has_default_conditions_)
+    request->throttling_profile_id = default_token_;
+  return net::OK;
+}
+
+bool NetworkEmulator::Matches(const ActiveRule& active_rule,
+                              const network::ResourceRequest& request) const {
+  const auto& types = active_rule.rule.resource_types;
+  if (!types.empty() &&
+      !types.count(static_cast<content::ResourceType>(request.resource_type)))
+    return false;
+  return active_rule.matcher.IsEmpty() ||
+         active_rule.matcher.Matches(request.url);
+}
+
+bool NetworkEmulator::ShouldFail(ActiveRule* active_rule) {
+  uint64_t sequence = active_rule->sequence++;
+  if (active_rule->rule.failure_rate <= 0)
+    return false;
+  // Hash the position of the request instead of drawing a random number, so
+  // the same seed fails the same requests.
+  uint32_t hash = base::PersistentHash(base::StringPrintf(
+      "%u:%zu:%llu", seed_, active_rule->index,
+      static_cast<unsigned long long>(sequence)));  // NOLINT(runtime/int)
+  return hash < active_rule->rule.failure_rate * 4294967296.0;
+}
+
+void NetworkEmulator::ApplyStep(ActiveRule* active_rule) {
+  const auto& trace = active_rule->rule.trace;
+  if (trace.empty())
+    return;
+
+  const Step& step = trace[active_rule->step];
+  SetConditions(active_rule->token, step.conditions.Clone());
+
+  bool is_last = active_rule->step + 1 == trace.size();
+  if (step.duration.is_zero() || (is_last && !active_rule->rule.loop))
+    return;
+  active_rule->timer.Start(
+      FROM_HERE, step.duration,
+      base::BindOnce(
+          [](NetworkEmulator* self, ActiveRule* active_rule) {
+            active_rule->step =
+                (active_rule->step + 1) % active_rule->rule.trace.size();
+            self->ApplyStep(active_rule);
+          },
+          // The timer is owned by |active_rule|, which we own.
+          base::Unretained(this), base::Unretained(active_rule)));
+}
+
+void NetworkEmulator::SetConditions(
+    const base::UnguessableToken& token,
+    network::mojom::NetworkConditionsPtr conditions) {
+  content::BrowserContext::GetDefaultStoragePartition(browser_context_)
+      ->GetNetworkContext()
+      ->SetNetworkConditions(token, std::move(conditions));
+}
+
+}  // namespace electron
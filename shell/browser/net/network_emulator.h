@@ -0,0 +1,132 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_NETWORK_EMULATOR_H_
+#define SHELL_BROWSER_NET_NETWORK_EMULATOR_H_
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/unguessable_token.h"
+#include "content/public/common/resource_type.h"
+#include "extensions/common/url_pattern.h"
+#include "services/network/public/mojom/network_context.mojom.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+
+namespace network {
+struct ResourceRequest;
+}
+
+namespace electron {
+
+class AtomBrowserContext;
+
+// Emulates network conditions for the requests of a session, whether they
+// come from renderers or from the net module.
+//
+// Requests are tagged with the throttling profile of the first rule they
+// match, or of the default conditions, and the network service throttles
+// each profile separately. A rule can replay a trace of conditions that
+// change over time, and fail a share of its requests to emulate a lossy
+// link; which requests fail only depends on the seed and the order of the
+// requests, so runs can be replayed.
+class NetworkEmulator {
+ public:
+  struct Step {
+    Step();
+    Step(Step&&);
+    ~Step();
+    Step& operator=(Step&&);
+
+    // How long the conditions apply, zero for the last step of a trace.
+    base::TimeDelta duration;
+    network::mojom::NetworkConditionsPtr conditions;
+  };
+
+  struct Rule {
+    Rule();
+    Rule(Rule&&);
+    ~Rule();
+    Rule& operator=(Rule&&);
+
+    // Empty sets match all requests.
+    std::set<URLPattern> url_patterns;
+    std::set<content::ResourceType> resource_types;
+
+    // The conditions of the rule, in the order they are applied.
+    std::vector<Step> trace;
+    bool loop = false;
+
+    // Share of the requests that fail with a connection reset, in [0, 1].
+    double failure_rate = 0;
+  };
+
+  struct Profile {
+    Profile();
+    Profile(Profile&&);
+    ~Profile();
+    Profile& operator=(Profile&&);
+
+    std::vector<Rule> rules;
+    uint32_t seed = 0;
+  };
+
+  explicit NetworkEmulator(AtomBrowserContext* browser_context);
+  ~NetworkEmulator();
+
+  // Conditions of the requests that match no rule, null to disable them.
+  void SetDefaultConditions(network::mojom::NetworkConditionsPtr conditions);
+
+  // Replaces the current profile and restarts its traces.
+  void SetProfile(Profile profile);
+  void ClearProfile();
+
+  bool IsActive() const { return has_default_conditions_ || !rules_.empty(); }
+
+  // Tags |request| with its throttling profile. Returns the error the
+  // request should fail with, or net::OK.
+  int OnBeforeRequest(network::ResourceRequest* request);
+
+ private:
+  struct ActiveRule {
+    ActiveRule();
+    ~ActiveRule();
+
+    Rule rule;
+    // Position of the rule in the profile.
+    size_t index = 0;
+    URLPatternMatcher matcher;
+    base::UnguessableToken token;
+    size_t step = 0;
+    // Number of requests that matched the rule so far.
+    uint64_t sequence = 0;
+    base::OneShotTimer timer;
+  };
+
+  bool Matches(const ActiveRule& rule,
+               const network::ResourceRequest& request) const;
+  bool ShouldFail(ActiveRule* rule);
+  void ApplyStep(ActiveRule* rule);
+  void SetConditions(const base::UnguessableToken& token,
+                     network::mojom::NetworkConditionsPtr conditions);
+
+  // Weak-ref, it manages us.
+  AtomBrowserContext* browser_context_;
+
+  base::UnguessableToken default_token_;
+  bool has_default_conditions_ = false;
+
+  std::vector<std::unique_ptr<ActiveRule>> rules_;
+  uint32_t seed_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkEmulator);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_NETWORK_EMULATOR_H_
@@ -0,0 +1,296 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/network_warmup.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/optional.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/browser/predictors/preconnect_manager.h"
+#include "components/prefs/pref_registry_simple.h"
+#include "components/prefs/pref_service.h"
+#include "components/prefs/scoped_user_pref_update.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/load_flags.h"
+#include "net/base/network_isolation_key.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/shared_url_loader_factory.h"
+#include "services/network/public/cpp/simple_url_loader.h"
+#include "shell/browser/atom_browser_context.h"
+
+namespace electron {
+
+namespace {
+
+// Dictionary holding the warm-up config, see session.setWarmupConfig().
+const char kNetworkWarmupConfig[] = "electron.network_warmup.config";
+
+// Dictionary that maps origins to {count, lastUsed}.
+const char kNetworkWarmupLearnedOrigins[] =
+    "electron.network_warmup.learned_origins";
+
+// Upper bound of the learned origins kept in prefs, the least recently used
+// ones are dropped first.
+constexpr size_t kMaxStoredOrigins = 100;
+
+// Origins that have not been used for this long are forgotten.
+constexpr base::TimeDelta kLearnedOriginExpiry = base::TimeDelta::FromDays(30);
+
+// Prefetched responses larger than this are not read completely.
+constexpr size_t kMaxPrefetchSize = 10 * 1024 * 1024;
+
+const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
+    net::DefineNetworkTrafficAnnotation("electron_network_warmup", R"(
+        semantics {
+          sender: "Electron Session network warm-up"
+          description:
+            "Fetches the URLs configured by the app ahead of time, so that "
+            "later requests for them can be served from the HTTP cache."
+          trigger: "Creating a session whose warm-up config lists URLs to "
+            "prefetch."
+          data: "None, the requests are plain GET requests."
+          destination: OTHER
+        }
+        policy {
+          cookies_allowed: YES
+          cookies_store: "user"
+          setting: "This feature cannot be disabled."
+        })");
+
+struct LearnedOrigin {
+  GURL origin;
+  int count;
+  double last_used;
+};
+
+std::vector<LearnedOrigin> ReadLearnedOrigins(const base::Value& dict) {
+  std::vector<LearnedOrigin> origins;
+  for (const auto& it : dict.DictItems()) {
+    GURL origin(it.first);
+    if (!origin.is_valid() || !it.second.is_dict())
+      continue;
+    const base::Value* count =
+        it.second.FindKeyOfType("count", base::Value::Type::INTEGER);
+    const base::Value* last_used =
+        it.second.FindKeyOfType("lastUsed", base::Value::Type::DOUBLE);
+    origins.push_back({origin, count ? count->GetInt() : 0,
+                       last_used ? last_used->GetDouble() : 0});
+  }
+  return origins;
+}
+
+base::Value UrlsToValue(const std::vector<GURL>& urls) {
+  base::Value list(base::Value::Type::LIST);
+  for (const GURL& url : urls)
+    list.GetList().push_back(base::Value(url.spec()));
+  return list;
+}
+
+std::vector<GURL> ValueToUrls(const base::Value* list) {
+  std::vector<GURL> urls;
+  if (!list || !list->is_list())
+    return urls;
+  for (const auto& item : list->GetList()) {
+    GURL url(item.is_string() ? item.GetString() : std::string());
+    if (url.is_valid())
+      urls.push_back(url);
+  }
+  return urls;
+}
+
+base::Value ConfigToValue(const NetworkWarmup::Config& config) {
+  base::Value hosts(base::Value::Type::LIST);
+  for (const std::string& host : config.dns_prefetch)
+    hosts.GetList().push_back(base::Value(host));
+
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetKey("preconnect", UrlsToValue(config.preconnect));
+  value.SetKey("dnsPrefetch", std::move(hosts));
+  value.SetKey("prefetch", UrlsToValue(config.prefetch));
+  value.SetKey("learnOrigins", base::Value(config.learn_origins));
+  value.SetKey("maxLearnedOrigins", base::Value(config.max_learned_origins));
+  return value;
+}
+
+NetworkWarmup::Config ValueToConfig(const base::Value& value) {
+  NetworkWarmup::Config config;
+  config.preconnect = ValueToUrls(value.FindKey("preconnect"));
+  config.prefetch = ValueToUrls(value.FindKey("prefetch"));
+  const base::Value* hosts =
+      value.FindKeyOfType("dnsPrefetch", base::Value::Type::LIST);
+  if (hosts) {
+    for (const auto& host : hosts->GetList()) {
+      if (host.is_string())
+        config.dns_prefetch.push_back(host.GetString());
+    }
+  }
+  base::Optional<bool> learn_origins = value.FindBoolKey("learnOrigins");
+  if (learn_origins)
+    config.learn_origins = *learn_origins;
+  base::Optional<int> max_learned = value.FindIntKey("maxLearnedOrigins");
+  if (max_learned)
+    config.max_learned_origins = *max_learned;
+  return config;
+}
+
+void StartPreconnect(predictors::PreconnectManager* manager,
+                     const GURL& url) {
+  std::vector<predictors::PreconnectRequest> requests = {
+      {url.GetOrigin(), 1, net::NetworkIsolationKey()}};
+  manager->Start(url.GetOrigin(), requests);
+}
+
+}  // namespace
+
+NetworkWarmup::Config::Config() = default;
+NetworkWarmup::Config::Config(const Config&) = default;
+NetworkWarmup::Config::~Config() = default;
+
+// static
+void NetworkWarmup::RegisterPrefs(PrefRegistrySimple* registry) {
+  registry->RegisterDictionaryPref(kNetworkWarmupConfig);
+  registry->RegisterDictionaryPref(kNetworkWarmupLearnedOrigins);
+}
+
+NetworkWarmup::NetworkWarmup(AtomBrowserContext* browser_context)
+    : browser_context_(browser_context),
+      persistent_(!browser_context->IsOffTheRecord()),
+      weak_factory_(this) {
+  if (persistent_)
+    config_ =
+        ValueToConfig(*browser_context_->prefs()->Get(kNetworkWarmupConfig));
+}
+
+NetworkWarmup::~NetworkWarmup() = default;
+
+void NetworkWarmup::SetConfig(const Config& config) {
+  config_ = config;
+  if (persistent_)
+    browser_context_->prefs()->Set(kNetworkWarmupConfig,
+                                   ConfigToValue(config_));
+}
+
+void NetworkWarmup::Start() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  auto* preconnect_manager = browser_context_->GetPreconnectManager();
+
+  if (!config_.dns_prefetch.empty())
+    preconnect_manager->StartPreresolveHosts(config_.dns_prefetch);
+
+  std::set<GURL> origins;
+  for (const GURL& url : config_.preconnect) {
+    if (origins.insert(url.GetOrigin()).second)
+      StartPreconnect(preconnect_manager, url);
+  }
+  if (config_.learn_origins) {
+    int learned = 0;
+    for (const GURL& origin : GetLearnedOrigins()) {
+      if (learned >= config_.max_learned_origins)
+        break;
+      if (origins.insert(origin).second) {
+        StartPreconnect(preconnect_manager, origin);
+        ++learned;
+      }
+    }
+  }
+
+  for (const GURL& url : config_.prefetch) {
+    auto request = std::make_unique<network::ResourceRequest>();
+    request->url = url;
+    // Only the side effect of filling the HTTP cache is wanted.
+    request->load_flags = net::LOAD_PREFETCH;
+    auto loader = network::SimpleURLLoader::Create(std::move(request),
+                                                   kTrafficAnnotation);
+    auto* raw_loader = loader.get();
+    auto it = prefetch_loaders_.insert(prefetch_loaders_.end(),
+                                       std::move(loader));
+    raw_loader->DownloadToString(
+        browser_context_->GetURLLoaderFactory().get(),
+        base::BindOnce(&NetworkWarmup::OnPrefetchComplete,
+                       weak_factory_.GetWeakPtr(), it),
+        kMaxPrefetchSize);
+  }
+}
+
+void NetworkWarmup::RecordRequest(const GURL& url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (!persistent_ || !config_.learn_origins || !url.SchemeIsHTTPOrHTTPS())
+    return;
+  GURL origin = url.GetOrigin();
+  if (!seen_origins_.insert(origin).second)
+    return;
+
+  DictionaryPrefUpdate update(browser_context_->prefs(),
+                              kNetworkWarmupLearnedOrigins);
+  base::Value* entry = update->FindKeyOfType(origin.spec(),
+                                             base::Value::Type::DICTIONARY);
+  int count = 0;
+  if (entry) {
+    base::Optional<int> previous = entry->FindIntKey("count");
+    count = previous.value_or(0);
+  } else {
+    entry = update->SetKey(origin.spec(),
+                           base::Value(base::Value::Type::DICTIONARY));
+  }
+  entry->SetKey("count", base::Value(count + 1));
+  entry->SetKey("lastUsed", base::Value(base::Time::Now().ToDoubleT()));
+
+  if (update->DictSize() <= kMaxStoredOrigins)
+    return;
+
+  // Drop expired entries, and if that is not enough the least recently used.
+  std::vector<LearnedOrigin> origins = ReadLearnedOrigins(*update.Get());
+  std::sort(origins.begin(), origins.end(),
+            [](const LearnedOrigin& a, const LearnedOrigin& b) {
+              return a.last_used > b.last_used;
+            });
+  double expiry = (base::Time::Now() - kLearnedOriginExpiry).ToDoubleT();
+  for (size_t i = 0; i < origins.size(); ++i) {
+    if (i >= kMaxStoredOrigins || origins[i].last_used < expiry)
+      update->RemoveKey(origins[i].origin.spec());
+  }
+}
+
+std::vector<GURL> NetworkWarmup::GetLearnedOrigins() const {
+  std::vector<GURL> result;
+  if (!persistent_)
+    return result;
+
+  std::vector<LearnedOrigin> origins = ReadLearnedOrigins(
+      *browser_context_->prefs()->Get(kNetworkWarmupLearnedOrigins));
+  double expiry = (base::Time::Now() - kLearnedOriginExpiry).ToDoubleT();
+  std::sort(origins.begin(), origins.end(),
+            [](const LearnedOrigin& a, const LearnedOrigin& b) {
+              if (a.count != b.count)
+                return a.count > b.count;
+              return a.last_used > b.last_used;
+            });
+  for (const LearnedOrigin& origin : origins) {
+    if (origin.last_used >= expiry)
+      result.push_back(origin.origin);
+  }
+  return result;
+}
+
+void NetworkWarmup::ClearLearnedOrigins() {
+  seen_origins_.clear();
+  if (persistent_)
+    browser_context_->prefs()->ClearPref(kNetworkWarmupLearnedOrigins);
+}
+
+void NetworkWarmup::OnPrefetchComplete(LoaderList::iterator it,
+                                       std::unique_ptr<std::string> body) {
+  // The response body is thrown away, it has already been written to the
+  // HTTP cache by the network service.
+  prefetch_loaders_.erase(it);
+}
+
+}  // namespace electron
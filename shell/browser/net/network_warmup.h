@@ -0,0 +1,97 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_NETWORK_WARMUP_H_
+#define SHELL_BROWSER_NET_NETWORK_WARMUP_H_
+
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "url/gurl.h"
+
+class PrefRegistrySimple;
+
+namespace network {
+class SimpleURLLoader;
+}
+
+namespace electron {
+
+class AtomBrowserContext;
+
+// Warms up the network stack of a session: preconnects to configured and
+// previously used origins, resolves hostnames ahead of time and fetches
+// resources into the HTTP cache.
+//
+// The configuration and the learned origins are kept in the pref store of the
+// browser context, so the warm-up of the next run can start as soon as the
+// session is created. In-memory sessions keep the configuration for the
+// current run only and never learn origins.
+class NetworkWarmup {
+ public:
+  struct Config {
+    Config();
+    Config(const Config&);
+    ~Config();
+
+    std::vector<GURL> preconnect;
+    std::vector<std::string> dns_prefetch;
+    std::vector<GURL> prefetch;
+    bool learn_origins = false;
+    int max_learned_origins = 10;
+  };
+
+  static void RegisterPrefs(PrefRegistrySimple* registry);
+
+  explicit NetworkWarmup(AtomBrowserContext* browser_context);
+  ~NetworkWarmup();
+
+  void SetConfig(const Config& config);
+  const Config& config() const { return config_; }
+
+  // Starts preconnecting, resolving and prefetching according to the current
+  // config. Must be called on the UI thread.
+  void Start();
+
+  // Remembers the origin of |url| when learning is enabled. Called for every
+  // request of the session, so it only touches prefs the first time an origin
+  // is seen in this run.
+  void RecordRequest(const GURL& url);
+
+  // Returns the learned origins, most used first.
+  std::vector<GURL> GetLearnedOrigins() const;
+  void ClearLearnedOrigins();
+
+  base::WeakPtr<NetworkWarmup> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  using LoaderList = std::list<std::unique_ptr<network::SimpleURLLoader>>;
+
+  void OnPrefetchComplete(LoaderList::iterator it,
+                          std::unique_ptr<std::string> body);
+
+  AtomBrowserContext* browser_context_;
+  bool persistent_;
+  Config config_;
+
+  // Origins recorded during this run.
+  std::set<GURL> seen_origins_;
+
+  LoaderList prefetch_loaders_;
+
+  base::WeakPtrFactory<NetworkWarmup> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkWarmup);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_NETWORK_WARMUP_H_
@@ -12,15 +12,18 @@
 
 namespace electron {
 
-NodeStreamLoader::NodeStreamLoader(network::ResourceResponseHead head,
-                                   network::mojom::URLLoaderRequest loader,
-                                   network::mojom::URLLoaderClientPtr client,
-                                   v8::Isolate* isolate,
-                                   v8::Local<v8::Object> emitter)
+NodeStreamLoader::NodeStreamLoader(
+    network::ResourceResponseHead head,
+    network::mojom::URLLoaderRequest loader,
+    network::mojom::URLLoaderClientPtr client,
+    v8::Isolate* isolate,
+    v8::Local<v8::Object> emitter,
+    std::unique_ptr<ProtocolResponseCache::Recorder> recorder)
     : binding_(this, std::move(loader)),
       client_(std::move(client)),
       isolate_(isolate),
       emitter_(isolate, emitter),
+      recorder_(std::move(recorder)),
       weak_factory_(this) {
   binding_.set_connection_error_handler(
       base::BindOnce(&NodeStreamLoader::NotifyComplete,
@@ -61,6 +64,8 @@ void NodeStreamLoader::Start(network::ResourceResponseHead head) {
 
   producer_ = std::make_unique<mojo::DataPipeProducer>(std::move(producer));
 
+  if (recorder_)
+    recorder_->OnResponseStarted(head);
   client_->OnReceiveResponse(head);
   client_->OnStartLoadingResponseBody(std::move(consumer));
 
@@ -86,6 +91,8 @@ void NodeStreamLoader::NotifyComplete(int result) {
     return;
   }
 
+  if (recorder_)
+    recorder_->OnComplete(result);
   client_->OnComplete(network::URLLoaderCompletionStatus(result));
   delete this;
 }
@@ -114,6 +121,9 @@ void NodeStreamLoader::ReadMore() {
 
   // Hold the buffer until the write is done.
   buffer_.Reset(isolate_, buffer);
+  if (recorder_)
+    recorder_->OnData(base::StringPiece(node::Buffer::Data(buffer),
+                                        node::Buffer::Length(buffer)));
 
   // Write buffer to mojo pipe asyncronously.
   is_reading_ = false;
@@ -14,6 +14,7 @@
 #include "mojo/public/cpp/system/data_pipe_producer.h"
 #include "services/network/public/cpp/resource_response.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
+#include "shell/browser/net/protocol_response_cache.h"
 #include "v8/include/v8.h"
 
 namespace electron {
@@ -26,13 +27,17 @@ namespace electron {
 // We use |paused mode| to read data from |Readable| stream, so we don't need to
 // copy data from buffer and hold it in memory, and we only need to make sure
 // the passed |Buffer| is alive while writing data to pipe.
+//
+// When |recorder| is passed, the data is also copied into it so the response
+// can be cached.
 class NodeStreamLoader : public network::mojom::URLLoader {
  public:
   NodeStreamLoader(network::ResourceResponseHead head,
                    network::mojom::URLLoaderRequest loader,
                    network::mojom::URLLoaderClientPtr client,
                    v8::Isolate* isolate,
-                   v8::Local<v8::Object> emitter);
+                   v8::Local<v8::Object> emitter,
+                   std::unique_ptr<ProtocolResponseCache::Recorder> recorder);
 
  private:
   ~NodeStreamLoader() override;
@@ -83,6 +88,8 @@ class NodeStreamLoader : public network::mojom::URLLoader {
   // flag.
   bool readable_ = false;
 
+  std::unique_ptr<ProtocolResponseCache::Recorder> recorder_;
+
   // Store the V8 callbacks to unsubscribe them later.
   std::map<std::string, v8::Global<v8::Value>> handlers_;
 
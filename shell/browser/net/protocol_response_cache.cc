@@ -0,0 +1,429 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/protocol_response_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash/sha1.h"
+#include "base/pickle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/cpp/resource_request.h"
+
+namespace electron {
+
+namespace {
+
+// Bumped whenever the format of the entries on disk changes, entries of other
+// versions are treated as misses.
+constexpr int kDiskFormatVersion = 1;
+
+// Upper bound of the variants of one URL kept in memory, only the most recent
+// variant is kept on disk.
+constexpr size_t kMaxVariants = 4;
+
+// Upper bound of the headers listed in Vary, to reject corrupted entries.
+constexpr uint32_t kMaxVaryHeaders = 64;
+
+std::string GetCacheKey(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return url.ReplaceComponents(replacements).spec();
+}
+
+bool MatchesVary(const ProtocolResponseCache::Entry& entry,
+                 const net::HttpRequestHeaders& headers) {
+  for (const auto& it : entry.vary) {
+    std::string value;
+    headers.GetHeader(it.first, &value);
+    if (value != it.second)
+      return false;
+  }
+  return true;
+}
+
+size_t GetEntrySize(const ProtocolResponseCache::Entry& entry) {
+  return entry.body->size() + entry.head.headers->raw_headers().size();
+}
+
+std::string SerializeEntry(const std::string& key,
+                           const ProtocolResponseCache::Entry& entry) {
+  base::Pickle pickle;
+  pickle.WriteInt(kDiskFormatVersion);
+  pickle.WriteString(key);
+  pickle.WriteInt64(entry.expires.ToDeltaSinceWindowsEpoch().InMicroseconds());
+  pickle.WriteUInt32(static_cast<uint32_t>(entry.vary.size()));
+  for (const auto& it : entry.vary) {
+    pickle.WriteString(it.first);
+    pickle.WriteString(it.second);
+  }
+  pickle.WriteString(entry.head.headers->raw_headers());
+  pickle.WriteString(entry.head.mime_type);
+  pickle.WriteString(entry.head.charset);
+  pickle.WriteData(reinterpret_cast<const char*>(entry.body->front()),
+                   static_cast<int>(entry.body->size()));
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+std::unique_ptr<ProtocolResponseCache::Entry> DeserializeEntry(
+    const std::string& key,
+    const std::string& data) {
+  base::Pickle pickle(data.data(), static_cast<int>(data.size()));
+  base::PickleIterator iter(pickle);
+  int version;
+  std::string stored_key;
+  int64_t expires;
+  uint32_t vary_count;
+  if (!iter.ReadInt(&version) || version != kDiskFormatVersion ||
+      !iter.ReadString(&stored_key) || stored_key != key ||
+      !iter.ReadInt64(&expires) || !iter.ReadUInt32(&vary_count) ||
+      vary_count > kMaxVaryHeaders)
+    return nullptr;
+
+  auto entry = std::make_unique<ProtocolResponseCache::Entry>();
+  entry->expires = base::Time::FromDeltaSinceWindowsEpoch(
+      base::TimeDelta::FromMicroseconds(expires));
+  for (uint32_t i = 0; i < vary_count; ++i) {
+    std::string name, value;
+    if (!iter.ReadString(&name) || !iter.ReadString(&value))
+      return nullptr;
+    entry->vary.emplace_back(std::move(name), std::move(value));
+  }
+
+  std::string raw_headers;
+  const char* body;
+  int body_size;
+  if (!iter.ReadString(&raw_headers) ||
+      !iter.ReadString(&entry->head.mime_type) ||
+      !iter.ReadString(&entry->head.charset) ||
+      !iter.ReadData(&body, &body_size))
+    return nullptr;
+  entry->head.headers =
+      base::MakeRefCounted<net::HttpResponseHeaders>(raw_headers);
+  std::string contents(body, body_size);
+  entry->body = base::RefCountedString::TakeString(&contents);
+  return entry;
+}
+
+}  // namespace
+
+// Keeps one file per URL in a directory, and trims the least recently used
+// files when the directory grows over its size limit. Lives on the disk
+// sequence.
+class ProtocolResponseCache::DiskStore {
+ public:
+  explicit DiskStore(const base::FilePath& dir) : dir_(dir) {}
+
+  void set_max_size(int64_t max_size) { max_size_ = max_size; }
+
+  std::unique_ptr<Entry> Load(const std::string& key,
+                              const net::HttpRequestHeaders& headers) {
+    base::FilePath path = GetEntryPath(key);
+    std::string data;
+    if (!base::ReadFileToString(path, &data))
+      return nullptr;
+
+    std::unique_ptr<Entry> entry = DeserializeEntry(key, data);
+    base::Time now = base::Time::Now();
+    if (!entry || entry->expires <= now) {
+      if (base::DeleteFile(path, false) && total_size_ >= 0)
+        total_size_ -= data.size();
+      return nullptr;
+    }
+    if (!MatchesVary(*entry, headers))
+      return nullptr;
+
+    // The modification time decides which entries are trimmed first.
+    base::TouchFile(path, now, now);
+    return entry;
+  }
+
+  void Store(const std::string& key, const Entry& entry) {
+    if (!base::CreateDirectory(dir_))
+      return;
+    if (total_size_ < 0)
+      total_size_ = base::ComputeDirectorySize(dir_);
+
+    base::FilePath path = GetEntryPath(key);
+    int64_t old_size;
+    if (base::GetFileSize(path, &old_size))
+      total_size_ -= old_size;
+
+    std::string data = SerializeEntry(key, entry);
+    if (!base::ImportantFileWriter::WriteFileAtomically(path, data))
+      return;
+    total_size_ += data.size();
+    if (total_size_ > max_size_)
+      Trim();
+  }
+
+  void Clear() {
+    base::DeleteFile(dir_, true);
+    total_size_ = 0;
+  }
+
+ private:
+  struct FileInfo {
+    base::FilePath path;
+    base::Time last_used;
+    int64_t size;
+  };
+
+  base::FilePath GetEntryPath(const std::string& key) const {
+    std::string hash = base::SHA1HashString(key);
+    return dir_.AppendASCII(base::HexEncode(hash.data(), hash.size()));
+  }
+
+  // Deletes the least recently used files until the directory is 10% below
+  // its limit, so not every store has to trim.
+  void Trim() {
+    std::vector<FileInfo> files;
+    total_size_ = 0;
+    base::FileEnumerator enumerator(dir_, false, base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      base::FileEnumerator::FileInfo info = enumerator.GetInfo();
+      files.push_back({path, info.GetLastModifiedTime(), info.GetSize()});
+      total_size_ += info.GetSize();
+    }
+    std::sort(files.begin(), files.end(),
+              [](const FileInfo& a, const FileInfo& b) {
+                return a.last_used < b.last_used;
+              });
+
+    int64_t target = max_size_ - max_size_ / 10;
+    for (const FileInfo& file : files) {
+      if (total_size_ <= target)
+        break;
+      if (base::DeleteFile(file.path, false))
+        total_size_ -= file.size;
+    }
+  }
+
+  base::FilePath dir_;
+  int64_t max_size_ = 0;
+  // Computed when the first entry is stored.
+  int64_t total_size_ = -1;
+
+  DISALLOW_COPY_AND_ASSIGN(DiskStore);
+};
+
+ProtocolResponseCache::Entry::Entry() = default;
+ProtocolResponseCache::Entry::Entry(const Entry&) = default;
+ProtocolResponseCache::Entry::~Entry() = default;
+
+ProtocolResponseCache::Recorder::Recorder(
+    scoped_refptr<ProtocolResponseCache> cache,
+    const network::ResourceRequest& request)
+    : cache_(std::move(cache)),
+      url_(request.url),
+      request_headers_(request.headers) {}
+
+ProtocolResponseCache::Recorder::~Recorder() = default;
+
+void ProtocolResponseCache::Recorder::OnResponseStarted(
+    const network::ResourceResponseHead& head) {
+  head_ = head;
+  storable_ = cache_->IsStorable(head);
+}
+
+void ProtocolResponseCache::Recorder::OnData(base::StringPiece data) {
+  if (!storable_)
+    return;
+  if (body_.size() + data.size() > cache_->options_.max_entry_size) {
+    // Too large to be cached, stop holding the data.
+    storable_ = false;
+    std::string().swap(body_);
+    return;
+  }
+  data.AppendToString(&body_);
+}
+
+void ProtocolResponseCache::Recorder::OnComplete(int net_error) {
+  if (net_error == net::OK && storable_)
+    cache_->Store(url_, request_headers_, head_, std::move(body_));
+  storable_ = false;
+}
+
+ProtocolResponseCache::ProtocolResponseCache(const base::FilePath& disk_path)
+    : memory_(base::MRUCache<std::string, EntryList>::NO_AUTO_EVICT),
+      disk_task_runner_(disk_path.empty()
+                            ? nullptr
+                            : base::CreateSequencedTaskRunner(
+                                  {base::ThreadPool(), base::MayBlock(),
+                                   base::TaskPriority::USER_VISIBLE,
+                                   base::TaskShutdownBehavior::
+                                       SKIP_ON_SHUTDOWN})),
+      disk_(disk_path.empty() ? nullptr : new DiskStore(disk_path),
+            base::OnTaskRunnerDeleter(disk_task_runner_)) {}
+
+ProtocolResponseCache::~ProtocolResponseCache() = default;
+
+void ProtocolResponseCache::Configure(const Options& options) {
+  options_ = options;
+  EvictMemory(options_.enabled ? options_.max_size : 0);
+  if (disk_)
+    disk_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&DiskStore::set_max_size,
+                                  base::Unretained(disk_.get()),
+                                  options_.max_disk_size));
+}
+
+void ProtocolResponseCache::Lookup(const network::ResourceRequest& request,
+                                   LookupCallback callback) {
+  const int kBypassFlags = net::LOAD_BYPASS_CACHE | net::LOAD_DISABLE_CACHE |
+                           net::LOAD_VALIDATE_CACHE;
+  if (!enabled() || request.method != "GET" ||
+      (request.load_flags & kBypassFlags)) {
+    std::move(callback).Run(nullptr);
+    return;
+  }
+
+  std::string key = GetCacheKey(request.url);
+  auto it = memory_.Get(key);
+  if (it != memory_.end()) {
+    for (const Entry& entry : it->second) {
+      if (MatchesVary(entry, request.headers)) {
+        if (entry.expires > base::Time::Now()) {
+          std::move(callback).Run(std::make_unique<Entry>(entry));
+          return;
+        }
+        break;
+      }
+    }
+  }
+
+  if (!options_.disk || !disk_) {
+    std::move(callback).Run(nullptr);
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      disk_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&DiskStore::Load, base::Unretained(disk_.get()), key,
+                     request.headers),
+      base::BindOnce(&ProtocolResponseCache::OnDiskLookup,
+                     weak_factory_.GetWeakPtr(), key, std::move(callback)));
+}
+
+std::unique_ptr<ProtocolResponseCache::Recorder>
+ProtocolResponseCache::CreateRecorder(const network::ResourceRequest& request) {
+  if (!enabled() || request.method != "GET" ||
+      (request.load_flags & net::LOAD_DISABLE_CACHE))
+    return nullptr;
+  return std::make_unique<Recorder>(this, request);
+}
+
+void ProtocolResponseCache::Clear(base::OnceClosure callback) {
+  memory_.Clear();
+  memory_size_ = 0;
+  if (disk_) {
+    disk_task_runner_->PostTaskAndReply(
+        FROM_HERE,
+        base::BindOnce(&DiskStore::Clear, base::Unretained(disk_.get())),
+        std::move(callback));
+  } else {
+    std::move(callback).Run();
+  }
+}
+
+bool ProtocolResponseCache::IsStorable(
+    const network::ResourceResponseHead& head) const {
+  if (!enabled() || !head.headers ||
+      head.headers->response_code() != net::HTTP_OK)
+    return false;
+  if (head.headers->HasHeaderValue("cache-control", "no-store") ||
+      head.headers->HasHeaderValue("vary", "*"))
+    return false;
+  // Zero for "no-cache" and responses without freshness information, there
+  // is no way to revalidate them against a protocol handler.
+  return !head.headers->GetFreshnessLifetimes(base::Time::Now())
+              .freshness.is_zero();
+}
+
+void ProtocolResponseCache::Store(
+    const GURL& url,
+    const net::HttpRequestHeaders& request_headers,
+    const network::ResourceResponseHead& head,
+    std::string body) {
+  if (!IsStorable(head))
+    return;
+
+  Entry entry;
+  size_t iter = 0;
+  std::string name;
+  while (head.headers->EnumerateHeader(&iter, "vary", &name)) {
+    name = base::ToLowerASCII(name);
+    std::string value;
+    request_headers.GetHeader(name, &value);
+    entry.vary.emplace_back(name, value);
+  }
+  entry.head = head;
+  entry.body = base::RefCountedString::TakeString(&body);
+  base::Time now = base::Time::Now();
+  entry.expires = now + head.headers->GetFreshnessLifetimes(now).freshness;
+
+  std::string key = GetCacheKey(url);
+  if (options_.disk && disk_)
+    disk_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&DiskStore::Store,
+                                  base::Unretained(disk_.get()), key, entry));
+  StoreInMemory(key, std::move(entry));
+}
+
+void ProtocolResponseCache::StoreInMemory(const std::string& key,
+                                          Entry entry) {
+  size_t size = GetEntrySize(entry);
+  if (size > options_.max_entry_size)
+    return;
+
+  auto it = memory_.Get(key);
+  if (it == memory_.end())
+    it = memory_.Put(key, EntryList());
+  EntryList& variants = it->second;
+  for (auto variant = variants.begin(); variant != variants.end(); ++variant) {
+    if (variant->vary == entry.vary) {
+      memory_size_ -= GetEntrySize(*variant);
+      variants.erase(variant);
+      break;
+    }
+  }
+  variants.insert(variants.begin(), std::move(entry));
+  memory_size_ += size;
+  if (variants.size() > kMaxVariants) {
+    memory_size_ -= GetEntrySize(variants.back());
+    variants.pop_back();
+  }
+  EvictMemory(options_.max_size);
+}
+
+void ProtocolResponseCache::EvictMemory(size_t max_size) {
+  while (memory_size_ > max_size && !memory_.empty()) {
+    auto it = memory_.rbegin();
+    for (const Entry& entry : it->second)
+      memory_size_ -= GetEntrySize(entry);
+    memory_.Erase(it);
+  }
+}
+
+void ProtocolResponseCache::OnDiskLookup(const std::string& key,
+                                         LookupCallback callback,
+                                         std::unique_ptr<Entry> entry) {
+  if (entry && enabled())
+    StoreInMemory(key, *entry);
+  std::move(callback).Run(std::move(entry));
+}
+
+}  // namespace electron
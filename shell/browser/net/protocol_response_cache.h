@@ -0,0 +1,148 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "net/http/http_request_headers.h"
+#include "services/network/public/cpp/resource_response.h"
+#include "url/gurl.h"
+
+namespace network {
+struct ResourceRequest;
+}
+
+namespace electron {
+
+// Caches the responses of stream and HTTP protocol handlers, so repeated
+// requests to a custom scheme do not have to run the JavaScript handler and
+// refetch or re-stream the content.
+//
+// Responses are keyed by their URL and the request headers named in their
+// Vary header, and are only stored when the Cache-Control or Expires header
+// returned by the handler marks them as fresh. Entries are kept in a memory
+// LRU and, optionally, in a directory on disk that survives restarts.
+//
+// Used on the UI thread only, the disk is accessed on a background sequence.
+class ProtocolResponseCache : public base::RefCounted<ProtocolResponseCache> {
+ public:
+  struct Options {
+    bool enabled = false;
+    size_t max_size = 32 * 1024 * 1024;
+    size_t max_entry_size = 4 * 1024 * 1024;
+    bool disk = false;
+    int64_t max_disk_size = 256 * 1024 * 1024;
+  };
+
+  struct Entry {
+    Entry();
+    Entry(const Entry&);
+    ~Entry();
+
+    // Lower-cased names of the headers listed in Vary, and the values they
+    // had in the request that produced the response.
+    std::vector<std::pair<std::string, std::string>> vary;
+    network::ResourceResponseHead head;
+    scoped_refptr<base::RefCountedMemory> body;
+    base::Time expires;
+  };
+
+  // Collects a response while it is being sent to the client, and stores it
+  // when the response completes successfully.
+  class Recorder {
+   public:
+    Recorder(scoped_refptr<ProtocolResponseCache> cache,
+             const network::ResourceRequest& request);
+    ~Recorder();
+
+    void OnResponseStarted(const network::ResourceResponseHead& head);
+    void OnData(base::StringPiece data);
+    void OnComplete(int net_error);
+
+   private:
+    scoped_refptr<ProtocolResponseCache> cache_;
+    GURL url_;
+    net::HttpRequestHeaders request_headers_;
+    network::ResourceResponseHead head_;
+    std::string body_;
+    bool storable_ = false;
+
+    DISALLOW_COPY_AND_ASSIGN(Recorder);
+  };
+
+  using LookupCallback = base::OnceCallback<void(std::unique_ptr<Entry>)>;
+
+  // |disk_path| is the directory of the disk tier, it is empty for in-memory
+  // sessions, which never write to disk.
+  explicit ProtocolResponseCache(const base::FilePath& disk_path);
+
+  void Configure(const Options& options);
+  bool enabled() const { return options_.enabled; }
+
+  // Calls |callback| with a copy of the fresh cached response to |request|,
+  // or with nullptr on a miss. Memory hits and requests that bypass the cache
+  // are answered synchronously.
+  void Lookup(const network::ResourceRequest& request,
+              LookupCallback callback);
+
+  // Returns a recorder for the response to |request|, or nullptr when the
+  // response would not be stored anyway.
+  std::unique_ptr<Recorder> CreateRecorder(
+      const network::ResourceRequest& request);
+
+  // Drops all entries from memory and disk, including the ones written in
+  // previous runs.
+  void Clear(base::OnceClosure callback);
+
+ private:
+  friend class base::RefCounted<ProtocolResponseCache>;
+
+  class DiskStore;
+  using EntryList = std::vector<Entry>;
+
+  ~ProtocolResponseCache();
+
+  bool IsStorable(const network::ResourceResponseHead& head) const;
+  void Store(const GURL& url,
+             const net::HttpRequestHeaders& request_headers,
+             const network::ResourceResponseHead& head,
+             std::string body);
+  void StoreInMemory(const std::string& key, Entry entry);
+  void EvictMemory(size_t max_size);
+  void OnDiskLookup(const std::string& key,
+                    LookupCallback callback,
+                    std::unique_ptr<Entry> entry);
+
+  Options options_;
+
+  // Key => variants of the response, most recently stored first.
+  base::MRUCache<std::string, EntryList> memory_;
+  size_t memory_size_ = 0;
+
+  scoped_refptr<base::SequencedTaskRunner> disk_task_runner_;
+  std::unique_ptr<DiskStore, base::OnTaskRunnerDeleter> disk_;
+
+  base::WeakPtrFactory<ProtocolResponseCache> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
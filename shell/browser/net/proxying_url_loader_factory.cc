@@ -12,7 +12,10 @@
 #include "net/base/completion_repeating_callback.h"
 #include "net/http/http_util.h"
 #include "services/network/public/cpp/features.h"
+#include "shell/browser/atom_browser_context.h"
 #include "shell/browser/net/asar/asar_url_loader.h"
+#include "shell/browser/net/network_emulator.h"
+#include "shell/browser/net/network_warmup.h"
 
 namespace electron {
 
@@ -689,6 +692,11 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
     const network::ResourceRequest& request,
     network::mojom::URLLoaderClientPtr client,
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
+  // Remember the origins used by this session for the next warm-up.
+  static_cast<AtomBrowserContext*>(browser_context_)
+      ->GetNetworkWarmup()
+      ->RecordRequest(request.url);
+
   // Check if user has intercepted this scheme.
   auto it = intercepted_handlers_.find(request.url.scheme());
   if (it != intercepted_handlers_.end()) {
@@ -697,7 +705,8 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
         request, base::BindOnce(&AtomURLLoaderFactory::StartLoading,
                                 std::move(loader), routing_id, request_id,
                                 options, request, std::move(client),
-                                traffic_annotation, this, it->second.first));
+                                traffic_annotation, this, it->second.first,
+                                scoped_refptr<ProtocolResponseCache>()));
     return;
   }
 
@@ -708,10 +717,25 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
     return;
   }
 
+  // Tag the request with the throttling profile of the emulated network.
+  base::Optional<network::ResourceRequest> emulated_request;
+  NetworkEmulator* emulator =
+      static_cast<AtomBrowserContext*>(browser_context_)->GetNetworkEmulator();
+  if (emulator->IsActive()) {
+    emulated_request.emplace(request);
+    int error = emulator->OnBeforeRequest(&*emulated_request);
+    if (error != net::OK) {
+      client->OnComplete(network::URLLoaderCompletionStatus(error));
+      return;
+    }
+  }
+  const network::ResourceRequest& outgoing_request =
+      emulated_request ? *emulated_request : request;
+
   if (!web_request_api()->HasListener()) {
     // Pass-through to the original factory.
     target_factory_->CreateLoaderAndStart(
-        std::move(loader), routing_id, request_id, options, request,
+        std::move(loader), routing_id, request_id, options, outgoing_request,
         std::move(client), traffic_annotation);
     return;
   }
@@ -728,8 +752,9 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
   auto result = requests_.emplace(
       web_request_id,
       std::make_unique<InProgressRequest>(
-          this, web_request_id, routing_id, request_id, options, request,
-          traffic_annotation, std::move(loader), std::move(client)));
+          this, web_request_id, routing_id, request_id, options,
+          outgoing_request, traffic_annotation, std::move(loader),
+          std::move(client)));
   result.first->second->Restart();
 }
 
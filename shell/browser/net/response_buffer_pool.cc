@@ -0,0 +1,83 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/response_buffer_pool.h"
+
+#include <utility>
+
+#include "content/public/browser/browser_thread.h"
+
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace {
+
+// Free blocks beyond this size are given back to the system.
+constexpr size_t kMaxPooledBytes = 8 * 1024 * 1024;
+
+}  // namespace
+
+// static
+ResponseBufferPool* ResponseBufferPool::GetInstance() {
+  static base::NoDestructor<ResponseBufferPool> instance;
+  return instance.get();
+}
+
+ResponseBufferPool::ResponseBufferPool() = default;
+
+ResponseBufferPool::~ResponseBufferPool() = default;
+
+char* ResponseBufferPool::Acquire(size_t capacity) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto it = free_blocks_.find(capacity);
+  if (it == free_blocks_.end() || it->second.empty())
+    return new char[capacity];
+  char* block = it->second.back();
+  it->second.pop_back();
+  pooled_bytes_ -= capacity;
+  return block;
+}
+
+void ResponseBufferPool::Release(char* block, size_t capacity) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (pooled_bytes_ + capacity > kMaxPooledBytes) {
+    delete[] block;
+    return;
+  }
+  free_blocks_[capacity].push_back(block);
+  pooled_bytes_ += capacity;
+}
+
+v8::MaybeLocal<v8::Object> ResponseBufferPool::Wrap(v8::Isolate* isolate,
+                                                    char* block,
+                                                    size_t capacity,
+                                                    size_t length) {
+  DCHECK_LE(length, capacity);
+  // The capacity is passed as hint so the block can be put back into the
+  // right bucket.
+  auto buffer = node::Buffer::New(isolate, block, length, &OnBufferFreed,
+                                  reinterpret_cast<void*>(capacity));
+  if (buffer.IsEmpty()) {
+    Release(block, capacity);
+    return buffer;
+  }
+  // Let V8 know about the memory, so it collects the Buffers in time.
+  isolate_ = isolate;
+  isolate_->AdjustAmountOfExternalAllocatedMemory(capacity);
+  return buffer;
+}
+
+// static
+void ResponseBufferPool::OnBufferFreed(char* data, void* hint) {
+  size_t capacity = reinterpret_cast<size_t>(hint);
+  ResponseBufferPool* self = GetInstance();
+  if (self->isolate_) {
+    self->isolate_->AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<int64_t>(capacity));
+  }
+  self->Release(data, capacity);
+}
+
+}  // namespace electron
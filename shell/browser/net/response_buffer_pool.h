@@ -0,0 +1,60 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_RESPONSE_BUFFER_POOL_H_
+#define SHELL_BROWSER_NET_RESPONSE_BUFFER_POOL_H_
+
+#include <map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Recycles the memory of the Buffers that carry response data to JavaScript.
+//
+// The memory of a Buffer created by Wrap() is returned to the pool when the
+// Buffer is garbage collected, so streaming a large response reuses a few
+// blocks instead of allocating a new one for every chunk. Must only be used
+// on the UI thread.
+class ResponseBufferPool {
+ public:
+  static ResponseBufferPool* GetInstance();
+
+  // Returns a block of |capacity| bytes.
+  char* Acquire(size_t capacity);
+
+  // Gives back a block that has not been wrapped into a Buffer.
+  void Release(char* block, size_t capacity);
+
+  // Creates a Buffer of the first |length| bytes of |block|, which is owned
+  // by the Buffer afterwards.
+  v8::MaybeLocal<v8::Object> Wrap(v8::Isolate* isolate,
+                                  char* block,
+                                  size_t capacity,
+                                  size_t length);
+
+ private:
+  friend class base::NoDestructor<ResponseBufferPool>;
+
+  ResponseBufferPool();
+  ~ResponseBufferPool();
+
+  static void OnBufferFreed(char* data, void* hint);
+
+  // capacity => free blocks.
+  std::map<size_t, std::vector<char*>> free_blocks_;
+  size_t pooled_bytes_ = 0;
+
+  // The isolate whose external memory accounts for the wrapped blocks.
+  v8::Isolate* isolate_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseBufferPool);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_RESPONSE_BUFFER_POOL_H_
@@ -0,0 +1,161 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/response_file_writer.h"
+
+#include "base/bind.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "build/build_config.h"
+
+#if defined(OS_WIN)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
+namespace electron {
+
+namespace {
+
+base::File DuplicateFileDescriptor(int fd) {
+#if defined(OS_WIN)
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  HANDLE duplicate = INVALID_HANDLE_VALUE;
+  if (handle == INVALID_HANDLE_VALUE ||
+      !::DuplicateHandle(::GetCurrentProcess(), handle, ::GetCurrentProcess(),
+                         &duplicate, 0, FALSE, DUPLICATE_SAME_ACCESS))
+    return base::File(base::File::FILE_ERROR_INVALID_OPERATION);
+  return base::File(duplicate);
+#else
+  int duplicate = HANDLE_EINTR(dup(fd));
+  if (duplicate < 0)
+    return base::File(base::File::FILE_ERROR_INVALID_OPERATION);
+  return base::File(duplicate);
+#endif
+}
+
+}  // namespace
+
+struct ResponseFileWriter::Core {
+  base::FilePath path;
+  base::File file;
+  // The first error, which fails all following operations.
+  base::File::Error error = base::File::FILE_OK;
+};
+
+ResponseFileWriter::ResponseFileWriter(const base::FilePath& path)
+    : task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::MayBlock(),
+           base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      core_(new Core, base::OnTaskRunnerDeleter(task_runner_)) {
+  core_->path = path;
+}
+
+ResponseFileWriter::ResponseFileWriter(int fd)
+    : task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::MayBlock(),
+           base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      core_(new Core, base::OnTaskRunnerDeleter(task_runner_)) {
+  core_->file = DuplicateFileDescriptor(fd);
+}
+
+ResponseFileWriter::~ResponseFileWriter() = default;
+
+void ResponseFileWriter::Open(OpenCallback callback) {
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ResponseFileWriter::OpenOnSequence,
+                     base::Unretained(core_.get())),
+      base::BindOnce(
+          [](OpenCallback callback,
+             std::pair<base::File::Error, int64_t> result) {
+            std::move(callback).Run(result.first, result.second);
+          },
+          std::move(callback)));
+}
+
+void ResponseFileWriter::Truncate(int64_t offset) {
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&ResponseFileWriter::TruncateOnSequence,
+                                        base::Unretained(core_.get()), offset));
+}
+
+void ResponseFileWriter::Write(base::StringPiece data, DoneCallback callback) {
+  pending_bytes_ += data.size();
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ResponseFileWriter::WriteOnSequence,
+                     base::Unretained(core_.get()), data.as_string()),
+      base::BindOnce(&ResponseFileWriter::OnWritten, weak_factory_.GetWeakPtr(),
+                     data.size(), std::move(callback)));
+}
+
+void ResponseFileWriter::Close(DoneCallback callback) {
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ResponseFileWriter::CloseOnSequence,
+                     base::Unretained(core_.get())),
+      std::move(callback));
+}
+
+// static
+std::pair<base::File::Error, int64_t> ResponseFileWriter::OpenOnSequence(
+    Core* core) {
+  if (!core->path.empty()) {
+    // Existing contents are kept until Truncate(), so a download can resume.
+    core->file = base::File(core->path, base::File::FLAG_OPEN_ALWAYS |
+                                            base::File::FLAG_WRITE);
+  }
+  if (!core->file.IsValid()) {
+    core->error = core->file.error_details();
+    return {core->error, 0};
+  }
+  int64_t length = core->file.GetLength();
+  if (length < 0) {
+    core->error = base::File::GetLastFileError();
+    return {core->error, 0};
+  }
+  return {base::File::FILE_OK, length};
+}
+
+// static
+void ResponseFileWriter::TruncateOnSequence(Core* core, int64_t offset) {
+  if (core->error != base::File::FILE_OK)
+    return;
+  if (!core->file.SetLength(offset) ||
+      core->file.Seek(base::File::FROM_BEGIN, offset) != offset)
+    core->error = base::File::GetLastFileError();
+}
+
+// static
+base::File::Error ResponseFileWriter::WriteOnSequence(Core* core,
+                                                      std::string data) {
+  if (core->error != base::File::FILE_OK)
+    return core->error;
+  if (core->file.WriteAtCurrentPos(data.data(), data.size()) !=
+      static_cast<int>(data.size()))
+    core->error = base::File::GetLastFileError();
+  return core->error;
+}
+
+// static
+base::File::Error ResponseFileWriter::CloseOnSequence(Core* core) {
+  core->file.Close();
+  return core->error;
+}
+
+void ResponseFileWriter::OnWritten(size_t size,
+                                   DoneCallback callback,
+                                   base::File::Error error) {
+  pending_bytes_ -= size;
+  std::move(callback).Run(error);
+}
+
+}  // namespace electron
@@ -0,0 +1,75 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_RESPONSE_FILE_WRITER_H_
+#define SHELL_BROWSER_NET_RESPONSE_FILE_WRITER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
+
+namespace electron {
+
+// Writes a response body to a file on a background sequence.
+//
+// All methods must be called on the same sequence, the file operations are
+// run in the order they were requested.
+class ResponseFileWriter {
+ public:
+  using OpenCallback =
+      base::OnceCallback<void(base::File::Error error, int64_t length)>;
+  using DoneCallback = base::OnceCallback<void(base::File::Error error)>;
+
+  // Writes to |path|, which is created if it does not exist.
+  explicit ResponseFileWriter(const base::FilePath& path);
+  // Writes to a duplicate of the file descriptor |fd|, the caller keeps
+  // ownership of |fd|.
+  explicit ResponseFileWriter(int fd);
+  ~ResponseFileWriter();
+
+  // Opens the file, |callback| receives its current length.
+  void Open(OpenCallback callback);
+
+  // Drops the contents after |offset|, the following writes start there.
+  void Truncate(int64_t offset);
+
+  void Write(base::StringPiece data, DoneCallback callback);
+  void Close(DoneCallback callback);
+
+  // Bytes passed to Write() that have not been written yet.
+  size_t pending_bytes() const { return pending_bytes_; }
+
+ private:
+  struct Core;
+
+  static std::pair<base::File::Error, int64_t> OpenOnSequence(Core* core);
+  static void TruncateOnSequence(Core* core, int64_t offset);
+  static base::File::Error WriteOnSequence(Core* core, std::string data);
+  static base::File::Error CloseOnSequence(Core* core);
+
+  void OnWritten(size_t size, DoneCallback callback, base::File::Error error);
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Only accessed on |task_runner_|, and deleted there after the pending
+  // operations.
+  std::unique_ptr<Core, base::OnTaskRunnerDeleter> core_;
+
+  size_t pending_bytes_ = 0;
+
+  base::WeakPtrFactory<ResponseFileWriter> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseFileWriter);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_RESPONSE_FILE_WRITER_H_
@@ -0,0 +1,90 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/url_pattern_matcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "url/gurl.h"
+
+namespace electron {
+
+URLPatternMatcher::URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(URLPatternMatcher&&) = default;
+
+URLPatternMatcher::~URLPatternMatcher() = default;
+
+URLPatternMatcher& URLPatternMatcher::operator=(URLPatternMatcher&&) = default;
+
+void URLPatternMatcher::AddPattern(const URLPattern& pattern, PatternId id) {
+  if (pattern.match_all_urls() || pattern.host().empty())
+    any_host_.push_back({pattern, id});
+  else if (pattern.match_subdomains())
+    domains_[pattern.host()].push_back({pattern, id});
+  else
+    hosts_[pattern.host()].push_back({pattern, id});
+  size_++;
+}
+
+template <typename Visitor>
+void URLPatternMatcher::VisitCandidates(const GURL& url,
+                                        Visitor visitor) const {
+  if (!any_host_.empty() && visitor(any_host_))
+    return;
+
+  std::string host = url.host();
+  if (host.empty())
+    return;
+
+  auto it = hosts_.find(host);
+  if (it != hosts_.end() && visitor(it->second))
+    return;
+
+  if (domains_.empty())
+    return;
+
+  // Walk "a.b.example.com", "b.example.com", "example.com", "com".
+  size_t pos = 0;
+  while (pos != std::string::npos) {
+    it = domains_.find(pos == 0 ? host : host.substr(pos));
+    if (it != domains_.end() && visitor(it->second))
+      return;
+    pos = host.find('.', pos);
+    if (pos != std::string::npos)
+      ++pos;
+  }
+}
+
+bool URLPatternMatcher::Matches(const GURL& url) const {
+  bool matched = false;
+  VisitCandidates(url, [&](const Bucket& bucket) {
+    for (const Entry& entry : bucket) {
+      if (entry.pattern.MatchesURL(url)) {
+        matched = true;
+        break;
+      }
+    }
+    return matched;
+  });
+  return matched;
+}
+
+std::vector<URLPatternMatcher::PatternId> URLPatternMatcher::MatchAll(
+    const GURL& url) const {
+  std::vector<PatternId> ids;
+  VisitCandidates(url, [&](const Bucket& bucket) {
+    for (const Entry& entry : bucket) {
+      if (entry.pattern.MatchesURL(url))
+        ids.push_back(entry.id);
+    }
+    return false;
+  });
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return ids;
+}
+
+}  // namespace electron
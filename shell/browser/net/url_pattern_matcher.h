@@ -0,0 +1,72 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace electron {
+
+// Matches URLs against a large set of URLPatterns.
+//
+// Patterns are indexed by their host, so a lookup only has to test the
+// patterns registered for the host of the URL and its parent domains, plus
+// the few patterns that match any host, instead of every pattern in the set.
+class URLPatternMatcher {
+ public:
+  using PatternId = size_t;
+
+  URLPatternMatcher();
+  URLPatternMatcher(URLPatternMatcher&&);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher& operator=(URLPatternMatcher&&);
+
+  void AddPattern(const URLPattern& pattern, PatternId id = 0);
+
+  bool IsEmpty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Returns whether any pattern matches |url|.
+  bool Matches(const GURL& url) const;
+
+  // Returns the ids of all patterns matching |url| in ascending order, with
+  // duplicates removed.
+  std::vector<PatternId> MatchAll(const GURL& url) const;
+
+ private:
+  struct Entry {
+    URLPattern pattern;
+    PatternId id;
+  };
+  using Bucket = std::vector<Entry>;
+
+  // Calls |visitor| with every bucket that may contain patterns matching
+  // |url|, stops early when it returns true.
+  template <typename Visitor>
+  void VisitCandidates(const GURL& url, Visitor visitor) const;
+
+  // Patterns for exactly one host.
+  std::unordered_map<std::string, Bucket> hosts_;
+  // Patterns for a host and all its subdomains, e.g. "*://*.example.com/*".
+  std::unordered_map<std::string, Bucket> domains_;
+  // Patterns matching any host.
+  Bucket any_host_;
+
+  size_t size_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternMatcher);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
@@ -17,9 +17,11 @@ URLPipeLoader::URLPipeLoader(
     network::mojom::URLLoaderRequest loader,
     network::mojom::URLLoaderClientPtr client,
     const net::NetworkTrafficAnnotationTag& annotation,
-    base::DictionaryValue upload_data)
+    base::DictionaryValue upload_data,
+    std::unique_ptr<ProtocolResponseCache::Recorder> recorder)
     : binding_(this, std::move(loader)),
       client_(std::move(client)),
+      recorder_(std::move(recorder)),
       weak_factory_(this) {
   binding_.set_connection_error_handler(base::BindOnce(
       &URLPipeLoader::NotifyComplete, base::Unretained(this), net::ERR_FAILED));
@@ -53,6 +55,8 @@ void URLPipeLoader::Start(
 }
 
 void URLPipeLoader::NotifyComplete(int result) {
+  if (recorder_)
+    recorder_->OnComplete(result);
   client_->OnComplete(network::URLLoaderCompletionStatus(result));
   delete this;
 }
@@ -70,6 +74,13 @@ void URLPipeLoader::OnResponseStarted(
 
   producer_ = std::make_unique<mojo::DataPipeProducer>(std::move(producer));
 
+  if (recorder_) {
+    network::ResourceResponseHead head;
+    head.headers = response_head.headers;
+    head.mime_type = response_head.mime_type;
+    head.charset = response_head.charset;
+    recorder_->OnResponseStarted(head);
+  }
   client_->OnReceiveResponse(response_head.Clone());
   client_->OnStartLoadingResponseBody(std::move(consumer));
 }
@@ -83,6 +94,8 @@ void URLPipeLoader::OnWrite(base::OnceClosure resume, MojoResult result) {
 
 void URLPipeLoader::OnDataReceived(base::StringPiece string_piece,
                                    base::OnceClosure resume) {
+  if (recorder_)
+    recorder_->OnData(string_piece);
   producer_->Write(
       std::make_unique<mojo::StringDataSource>(
           string_piece, mojo::StringDataSource::AsyncWritingMode::
@@ -14,6 +14,7 @@
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "services/network/public/cpp/simple_url_loader_stream_consumer.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
+#include "shell/browser/net/protocol_response_cache.h"
 
 namespace network {
 class SharedURLLoaderFactory;
@@ -36,7 +37,8 @@ class URLPipeLoader : public network::mojom::URLLoader,
                 network::mojom::URLLoaderRequest loader,
                 network::mojom::URLLoaderClientPtr client,
                 const net::NetworkTrafficAnnotationTag& annotation,
-                base::DictionaryValue upload_data);
+                base::DictionaryValue upload_data,
+                std::unique_ptr<ProtocolResponseCache::Recorder> recorder);
 
  private:
   ~URLPipeLoader() override;
@@ -71,6 +73,9 @@ class URLPipeLoader : public network::mojom::URLLoader,
   std::unique_ptr<mojo::DataPipeProducer> producer_;
   std::unique_ptr<network::SimpleURLLoader> loader_;
 
+  // Copies the response for the cache of the protocol, may be null.
+  std::unique_ptr<ProtocolResponseCache::Recorder> recorder_;
+
   base::WeakPtrFactory<URLPipeLoader> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(URLPipeLoader);
@@ -0,0 +1,95 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_rules.h"
+
+#include <utility>
+
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+
+namespace electron {
+
+WebRequestRule::WebRequestRule() = default;
+WebRequestRule::WebRequestRule(const WebRequestRule&) = default;
+WebRequestRule::~WebRequestRule() = default;
+
+WebRequestRules::WebRequestRules() = default;
+
+WebRequestRules::WebRequestRules(WebRequestRules&&) = default;
+
+WebRequestRules::~WebRequestRules() = default;
+
+WebRequestRules& WebRequestRules::operator=(WebRequestRules&&) = default;
+
+void WebRequestRules::AddRule(const std::set<URLPattern>& patterns,
+                              WebRequestRule rule) {
+  for (const URLPattern& pattern : patterns)
+    matcher_.AddPattern(pattern, rules_.size());
+  rules_.push_back(std::move(rule));
+}
+
+int WebRequestRules::OnBeforeRequest(const GURL& url, GURL* new_url) const {
+  if (rules_.empty())
+    return net::OK;
+
+  for (size_t id : matcher_.MatchAll(url)) {
+    const WebRequestRule& rule = rules_[id];
+    if (rule.action == WebRequestRule::Action::kBlock)
+      return net::ERR_BLOCKED_BY_CLIENT;
+    // Redirecting a URL to itself would loop forever.
+    if (rule.action == WebRequestRule::Action::kRedirect &&
+        rule.redirect_url != url) {
+      *new_url = rule.redirect_url;
+      return net::OK;
+    }
+  }
+  return net::OK;
+}
+
+void WebRequestRules::OnBeforeSendHeaders(
+    const GURL& url,
+    net::HttpRequestHeaders* headers) const {
+  if (rules_.empty())
+    return;
+
+  for (size_t id : matcher_.MatchAll(url)) {
+    const WebRequestRule& rule = rules_[id];
+    if (rule.action != WebRequestRule::Action::kModifyHeaders)
+      continue;
+    for (const std::string& name : rule.remove_request_headers)
+      headers->RemoveHeader(name);
+    for (const auto& it : rule.set_request_headers)
+      headers->SetHeader(it.first, it.second);
+  }
+}
+
+scoped_refptr<net::HttpResponseHeaders> WebRequestRules::OnHeadersReceived(
+    const GURL& url,
+    const net::HttpResponseHeaders* original_headers) const {
+  if (rules_.empty() || !original_headers)
+    return nullptr;
+
+  scoped_refptr<net::HttpResponseHeaders> headers;
+  for (size_t id : matcher_.MatchAll(url)) {
+    const WebRequestRule& rule = rules_[id];
+    if (rule.action != WebRequestRule::Action::kModifyHeaders ||
+        (rule.remove_response_headers.empty() &&
+         rule.set_response_headers.empty()))
+      continue;
+    if (!headers)
+      headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+          original_headers->raw_headers());
+    for (const std::string& name : rule.remove_response_headers)
+      headers->RemoveHeader(name);
+    for (const auto& it : rule.set_response_headers) {
+      headers->RemoveHeader(it.first);
+      headers->AddHeader(it.first + ": " + it.second);
+    }
+  }
+  return headers;
+}
+
+}  // namespace electron
@@ -0,0 +1,82 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+#include "url/gurl.h"
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+}  // namespace net
+
+namespace electron {
+
+struct WebRequestRule {
+  enum class Action {
+    kBlock,
+    kRedirect,
+    kModifyHeaders,
+  };
+
+  WebRequestRule();
+  WebRequestRule(const WebRequestRule&);
+  ~WebRequestRule();
+
+  Action action = Action::kBlock;
+  GURL redirect_url;
+  std::map<std::string, std::string> set_request_headers;
+  std::vector<std::string> remove_request_headers;
+  std::map<std::string, std::string> set_response_headers;
+  std::vector<std::string> remove_response_headers;
+};
+
+// Declarative webRequest rules, evaluated without calling into JavaScript.
+//
+// Rules are checked in the order they were added: the first matching block
+// or redirect rule decides the fate of a request, while all matching header
+// rules are applied.
+class WebRequestRules {
+ public:
+  WebRequestRules();
+  WebRequestRules(WebRequestRules&&);
+  ~WebRequestRules();
+
+  WebRequestRules& operator=(WebRequestRules&&);
+
+  void AddRule(const std::set<URLPattern>& patterns, WebRequestRule rule);
+
+  bool IsEmpty() const { return rules_.empty(); }
+
+  // Returns net::ERR_BLOCKED_BY_CLIENT when the request is blocked, otherwise
+  // net::OK with |new_url| set when the request is redirected.
+  int OnBeforeRequest(const GURL& url, GURL* new_url) const;
+
+  void OnBeforeSendHeaders(const GURL& url,
+                           net::HttpRequestHeaders* headers) const;
+
+  // Returns the modified headers, or nullptr if no rule applies.
+  scoped_refptr<net::HttpResponseHeaders> OnHeadersReceived(
+      const GURL& url,
+      const net::HttpResponseHeaders* original_headers) const;
+
+ private:
+  std::vector<WebRequestRule> rules_;
+  URLPatternMatcher matcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestRules);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
@@ -0,0 +1,506 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_worker.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/timer/timer.h"
+#include "gin/arguments.h"
+#include "gin/converter.h"
+#include "gin/dictionary.h"
+#include "gin/object_template_builder.h"
+#include "gin/public/isolate_holder.h"
+#include "shell/browser/atom_browser_main_parts.h"
+#include "shell/browser/javascript_environment.h"
+#include "shell/common/gin_converters/value_converter.h"
+#include "shell/common/node_includes.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+const char* const kEventNames[] = {
+    "onBeforeRequest",  "onBeforeSendHeaders", "onHeadersReceived",
+    "onSendHeaders",    "onBeforeRedirect",    "onResponseStarted",
+    "onErrorOccurred",  "onCompleted",
+};
+
+// Node's platform schedules V8's delayed foreground tasks, like incremental
+// GC steps, on a libuv loop that nothing else runs on the worker thread.
+constexpr base::TimeDelta kPlatformTasksInterval =
+    base::TimeDelta::FromSeconds(1);
+
+// The main process converter creates node::Buffer objects for binary values,
+// which need a Node environment the worker does not have.
+v8::Local<v8::Value> ValueToV8(v8::Isolate* isolate, const base::Value& value) {
+  auto context = isolate->GetCurrentContext();
+  switch (value.type()) {
+    case base::Value::Type::BOOLEAN:
+      return v8::Boolean::New(isolate, value.GetBool());
+    case base::Value::Type::INTEGER:
+      return v8::Integer::New(isolate, value.GetInt());
+    case base::Value::Type::DOUBLE:
+      return v8::Number::New(isolate, value.GetDouble());
+    case base::Value::Type::STRING:
+      return gin::StringToV8(isolate, value.GetString());
+    case base::Value::Type::BINARY: {
+      const auto& blob = value.GetBlob();
+      auto buffer = v8::ArrayBuffer::New(isolate, blob.size());
+      if (!blob.empty())
+        memcpy(buffer->GetContents().Data(), blob.data(), blob.size());
+      return v8::Uint8Array::New(buffer, 0, blob.size());
+    }
+    case base::Value::Type::DICTIONARY: {
+      v8::Local<v8::Object> object = v8::Object::New(isolate);
+      for (const auto& item : value.DictItems()) {
+        object
+            ->Set(context, gin::StringToV8(isolate, item.first),
+                  ValueToV8(isolate, item.second))
+            .Check();
+      }
+      return object;
+    }
+    case base::Value::Type::LIST: {
+      const auto& list = value.GetList();
+      v8::Local<v8::Array> array = v8::Array::New(isolate, list.size());
+      for (size_t i = 0; i < list.size(); ++i) {
+        array
+            ->Set(context, static_cast<uint32_t>(i),
+                  ValueToV8(isolate, list[i]))
+            .Check();
+      }
+      return array;
+    }
+    default:
+      return v8::Null(isolate);
+  }
+}
+
+std::string ExceptionToString(v8::Isolate* isolate,
+                              const v8::TryCatch& try_catch) {
+  if (try_catch.HasCaught()) {
+    v8::String::Utf8Value message(isolate, try_catch.Exception());
+    if (*message)
+      return *message;
+  }
+  return "Unknown error";
+}
+
+}  // namespace
+
+// Owns the isolate, created on the UI thread and then only used and deleted
+// on the worker thread.
+class WebRequestWorker::Core {
+ public:
+  Core(base::WeakPtr<WebRequestWorker> owner,
+       scoped_refptr<base::SingleThreadTaskRunner> owner_task_runner,
+       node::MultiIsolatePlatform* platform)
+      : owner_(owner),
+        owner_task_runner_(std::move(owner_task_runner)),
+        platform_(platform) {}
+
+  ~Core() {
+    platform_tasks_timer_.Stop();
+    if (!isolate_holder_)
+      return;
+
+    v8::Isolate* isolate = isolate_holder_->isolate();
+    {
+      v8::Locker locker(isolate);
+      v8::Isolate::Scope isolate_scope(isolate);
+      listeners_.clear();
+      port_.Reset();
+      context_.Reset();
+    }
+    platform_->CancelPendingDelayedTasks(isolate);
+    platform_->UnregisterIsolate(isolate);
+    isolate_holder_.reset();
+
+    // Let libuv run the close callbacks of the platform's handles.
+    uv_run(&loop_, UV_RUN_DEFAULT);
+    uv_loop_close(&loop_);
+  }
+
+  static void Destroy(Core* core,
+                      base::Thread* thread,
+                      scoped_refptr<base::SingleThreadTaskRunner> ui_runner) {
+    delete core;
+    // Joining the thread has to happen on another thread.
+    ui_runner->DeleteSoon(FROM_HERE, thread);
+  }
+
+  void Start(const std::string& source) {
+    Initialize();
+
+    std::string error;
+    {
+      v8::Isolate* isolate = isolate_holder_->isolate();
+      v8::Locker locker(isolate);
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = context_.Get(isolate);
+      v8::Context::Scope context_scope(context);
+
+      v8::TryCatch try_catch(isolate);
+      v8::ScriptOrigin origin(gin::StringToV8(isolate, "webRequestWorker"));
+      v8::Local<v8::Script> script;
+      if (!v8::Script::Compile(context, gin::StringToV8(isolate, source),
+                               &origin)
+               .ToLocal(&script) ||
+          script->Run(context).IsEmpty())
+        error = ExceptionToString(isolate, try_catch);
+    }
+    RunPendingTasks();
+
+    owner_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&WebRequestWorker::OnStarted, owner_, error));
+  }
+
+  void DispatchEvent(const std::string& event,
+                     base::Value details,
+                     uint64_t response_id) {
+    auto iter = listeners_.find(event);
+    if (iter == listeners_.end()) {
+      // The listener was removed while the event was on its way.
+      if (response_id)
+        Reply(response_id, base::Value());
+      return;
+    }
+
+    {
+      v8::Isolate* isolate = isolate_holder_->isolate();
+      v8::Locker locker(isolate);
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = context_.Get(isolate);
+      v8::Context::Scope context_scope(context);
+
+      // The listener may replace itself, so hold it before calling it.
+      v8::Local<v8::Function> listener = iter->second.Get(isolate);
+      std::vector<v8::Local<v8::Value>> args = {ValueToV8(isolate, details)};
+      if (response_id) {
+        // Not a gin function template, V8 caches every template it
+        // instantiates for the lifetime of the context.
+        v8::Local<v8::Value> data[] = {
+            v8::External::New(isolate, this),
+            v8::BigInt::NewFromUnsigned(isolate, response_id)};
+        pending_responses_.insert(response_id);
+        args.push_back(
+            v8::Function::New(context, &Core::OnListenerResponse,
+                              v8::Array::New(isolate, data, 2))
+                .ToLocalChecked());
+      }
+
+      v8::TryCatch try_catch(isolate);
+      if (listener
+              ->Call(context, v8::Undefined(isolate), args.size(),
+                     args.data())
+              .IsEmpty()) {
+        LOG(ERROR) << "Uncaught exception in webRequest." << event
+                   << " listener of worker: "
+                   << ExceptionToString(isolate, try_catch);
+        if (response_id && pending_responses_.erase(response_id))
+          Reply(response_id, base::Value());
+      }
+    }
+    RunPendingTasks();
+  }
+
+  void PostMessage(base::Value message) {
+    {
+      v8::Isolate* isolate = isolate_holder_->isolate();
+      v8::Locker locker(isolate);
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = context_.Get(isolate);
+      v8::Context::Scope context_scope(context);
+
+      v8::Local<v8::Object> port = port_.Get(isolate);
+      gin::Dictionary dict(isolate, port);
+      v8::Local<v8::Value> onmessage;
+      if (dict.Get("onmessage", &onmessage) && onmessage->IsFunction()) {
+        v8::TryCatch try_catch(isolate);
+        v8::Local<v8::Value> args[] = {ValueToV8(isolate, message)};
+        if (onmessage.As<v8::Function>()
+                ->Call(context, port, 1, args)
+                .IsEmpty()) {
+          LOG(ERROR) << "Uncaught exception in port.onmessage of worker: "
+                     << ExceptionToString(isolate, try_catch);
+        }
+      }
+    }
+    RunPendingTasks();
+  }
+
+ private:
+  void Initialize() {
+    uv_loop_init(&loop_);
+    v8::Isolate* isolate = v8::Isolate::Allocate();
+    platform_->RegisterIsolate(isolate, &loop_);
+    isolate_holder_ = std::make_unique<gin::IsolateHolder>(
+        base::ThreadTaskRunnerHandle::Get(), gin::IsolateHolder::kSingleThread,
+        gin::IsolateHolder::kAllowAtomicsWait,
+        gin::IsolateHolder::IsolateType::kUtility,
+        gin::IsolateHolder::IsolateCreationMode::kNormal, isolate);
+    isolate->SetMicrotasksPolicy(v8::MicrotasksPolicy::kExplicit);
+
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    context_.Reset(isolate, context);
+    v8::Context::Scope context_scope(context);
+
+    // Unretained is safe, the functions go away with the isolate.
+    gin::ObjectTemplateBuilder web_request(isolate);
+    for (const char* event : kEventNames) {
+      web_request.SetMethod(event,
+                            base::BindRepeating(&Core::SetListener,
+                                                base::Unretained(this),
+                                                std::string(event)));
+    }
+    v8::Local<v8::Object> port =
+        gin::ObjectTemplateBuilder(isolate)
+            .SetMethod("postMessage",
+                       base::BindRepeating(&Core::PostMessageToOwner,
+                                           base::Unretained(this)))
+            .Build()
+            ->NewInstance(context)
+            .ToLocalChecked();
+    port_.Reset(isolate, port);
+
+    gin::Dictionary global(isolate, context->Global());
+    global.Set("webRequest",
+               web_request.Build()->NewInstance(context).ToLocalChecked());
+    global.Set("port", port);
+
+    platform_tasks_timer_.Start(
+        FROM_HERE, kPlatformTasksInterval,
+        base::BindRepeating(&Core::RunPendingTasks, base::Unretained(this)));
+  }
+
+  // Runs the microtasks queued by the last call into JavaScript, and the
+  // foreground tasks Node's platform posted for the isolate.
+  void RunPendingTasks() {
+    v8::Isolate* isolate = isolate_holder_->isolate();
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::MicrotasksScope::PerformCheckpoint(isolate);
+    uv_run(&loop_, UV_RUN_NOWAIT);
+  }
+
+  // webRequest.on*([filter, ]listener)
+  void SetListener(const std::string& event, gin::Arguments* args) {
+    v8::Isolate* isolate = args->isolate();
+    v8::Local<v8::Value> arg;
+
+    std::set<URLPattern> patterns;
+    if (args->GetNext(&arg) && arg->IsObject() && !arg->IsFunction()) {
+      gin::Dictionary dict(isolate, arg.As<v8::Object>());
+      std::vector<std::string> urls;
+      if (!dict.Get("urls", &urls)) {
+        args->ThrowTypeError("Parameter 'filter' must have property 'urls'.");
+        return;
+      }
+      for (const std::string& url : urls) {
+        URLPattern pattern(URLPattern::SCHEME_ALL);
+        const URLPattern::ParseResult result = pattern.Parse(url);
+        if (result != URLPattern::ParseResult::kSuccess) {
+          args->ThrowTypeError("Invalid url pattern " + url + ": " +
+                               URLPattern::GetParseResultString(result));
+          return;
+        }
+        patterns.insert(pattern);
+      }
+      args->GetNext(&arg);
+    }
+
+    if (arg.IsEmpty() || !(arg->IsFunction() || arg->IsNull())) {
+      args->ThrowTypeError("Must pass null or a Function");
+      return;
+    }
+
+    bool has_listener = arg->IsFunction();
+    if (has_listener)
+      listeners_[event].Reset(isolate, arg.As<v8::Function>());
+    else
+      listeners_.erase(event);
+    owner_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&WebRequestWorker::OnListenerChanged, owner_,
+                                  event, patterns, has_listener));
+  }
+
+  // port.postMessage(message)
+  void PostMessageToOwner(gin::Arguments* args) {
+    v8::Local<v8::Value> arg;
+    base::Value message;
+    if (!args->GetNext(&arg) ||
+        !gin::ConvertFromV8(args->isolate(), arg, &message)) {
+      args->ThrowTypeError("Must pass a serializable message");
+      return;
+    }
+    owner_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&WebRequestWorker::OnMessage, owner_,
+                                  std::move(message)));
+  }
+
+  // The callback passed to listeners of response events.
+  static void OnListenerResponse(
+      const v8::FunctionCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Array> data = info.Data().As<v8::Array>();
+    auto* self = static_cast<Core*>(
+        data->Get(context, 0).ToLocalChecked().As<v8::External>()->Value());
+    uint64_t id =
+        data->Get(context, 1).ToLocalChecked().As<v8::BigInt>()->Uint64Value();
+
+    // Only the first call counts.
+    if (!self->pending_responses_.erase(id))
+      return;
+
+    base::Value response;
+    if (info.Length() > 0)
+      gin::ConvertFromV8(isolate, info[0], &response);
+    self->Reply(id, std::move(response));
+  }
+
+  void Reply(uint64_t id, base::Value response) {
+    owner_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&WebRequestWorker::OnResponse, owner_, id,
+                                  std::move(response)));
+  }
+
+  base::WeakPtr<WebRequestWorker> owner_;
+  scoped_refptr<base::SingleThreadTaskRunner> owner_task_runner_;
+  node::MultiIsolatePlatform* platform_;
+
+  uv_loop_t loop_;
+  std::unique_ptr<gin::IsolateHolder> isolate_holder_;
+  v8::Global<v8::Context> context_;
+  v8::Global<v8::Object> port_;
+  std::map<std::string, v8::Global<v8::Function>> listeners_;
+  std::set<uint64_t> pending_responses_;
+
+  base::RepeatingTimer platform_tasks_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Core);
+};
+
+WebRequestWorker::WebRequestWorker(const MessageCallback& on_message)
+    : on_message_(on_message) {}
+
+WebRequestWorker::~WebRequestWorker() {
+  if (start_callback_)
+    std::move(start_callback_).Run("The worker was stopped");
+
+  // Let the requests waiting for the worker continue.
+  auto pending_responses = std::move(pending_responses_);
+  for (auto& pending : pending_responses)
+    std::move(pending.second).Run(base::Value());
+
+  if (!thread_)
+    return;
+
+  // The isolate has to be disposed on its own thread.
+  thread_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&Core::Destroy, core_, thread_.release(),
+                     base::ThreadTaskRunnerHandle::Get()));
+}
+
+void WebRequestWorker::Start(const std::string& source,
+                             StartCallback callback) {
+  DCHECK(!thread_);
+  auto thread =
+      std::make_unique<base::Thread>(ELECTRON_PRODUCT_NAME "WebRequestWorker");
+  if (!thread->Start()) {
+    std::move(callback).Run("Failed to start the worker thread");
+    return;
+  }
+  thread_ = std::move(thread);
+  start_callback_ = std::move(callback);
+
+  core_ = new Core(weak_factory_.GetWeakPtr(),
+                   base::ThreadTaskRunnerHandle::Get(),
+                   AtomBrowserMainParts::Get()->js_env()->platform());
+  thread_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&Core::Start, base::Unretained(core_), source));
+}
+
+bool WebRequestWorker::HasListener(const std::string& event,
+                                   const GURL& url) const {
+  auto iter = listeners_.find(event);
+  if (iter == listeners_.end())
+    return false;
+  return iter->second.IsEmpty() || iter->second.Matches(url);
+}
+
+void WebRequestWorker::DispatchEvent(const std::string& event,
+                                     base::Value details) {
+  // Core is deleted by a task posted after this one, so Unretained is safe.
+  thread_->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&Core::DispatchEvent, base::Unretained(core_),
+                                event, std::move(details), 0));
+}
+
+void WebRequestWorker::DispatchEvent(const std::string& event,
+                                     base::Value details,
+                                     ResponseCallback callback) {
+  uint64_t id = next_response_id_++;
+  pending_responses_[id] = std::move(callback);
+  thread_->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&Core::DispatchEvent, base::Unretained(core_),
+                                event, std::move(details), id));
+}
+
+void WebRequestWorker::PostMessage(base::Value message) {
+  if (!thread_)
+    return;
+  thread_->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&Core::PostMessage, base::Unretained(core_),
+                                std::move(message)));
+}
+
+void WebRequestWorker::OnStarted(const std::string& error) {
+  // May delete |this|.
+  std::move(start_callback_).Run(error);
+}
+
+void WebRequestWorker::OnListenerChanged(const std::string& event,
+                                         const std::set<URLPattern>& patterns,
+                                         bool has_listener) {
+  if (!has_listener) {
+    listeners_.erase(event);
+    return;
+  }
+  URLPatternMatcher matcher;
+  for (const URLPattern& pattern : patterns)
+    matcher.AddPattern(pattern);
+  listeners_[event] = std::move(matcher);
+}
+
+void WebRequestWorker::OnMessage(base::Value message) {
+  if (on_message_)
+    on_message_.Run(message);
+}
+
+void WebRequestWorker::OnResponse(uint64_t id, base::Value response) {
+  auto iter = pending_responses_.find(id);
+  if (iter == pending_responses_.end())
+    return;
+  ResponseCallback callback = std::move(iter->second);
+  pending_responses_.erase(iter);
+  std::move(callback).Run(std::move(response));
+}
+
+}  // namespace electron
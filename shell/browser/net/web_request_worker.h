@@ -0,0 +1,102 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_WEB_REQUEST_WORKER_H_
+#define SHELL_BROWSER_NET_WEB_REQUEST_WORKER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/values.h"
+#include "extensions/common/url_pattern.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+
+class GURL;
+
+namespace base {
+class Thread;
+}
+
+namespace electron {
+
+// Runs webRequest listeners in a dedicated V8 isolate on its own thread, so
+// slow listeners and a busy main process do not delay each other.
+//
+// The worker script registers listeners with the same webRequest.on* methods
+// as the main process, and talks to the main process with port.postMessage()
+// and port.onmessage. Values crossing the thread boundary are copied as
+// base::Value.
+//
+// This object lives on the UI thread, the isolate is only touched on the
+// worker thread.
+class WebRequestWorker {
+ public:
+  using MessageCallback = base::RepeatingCallback<void(const base::Value&)>;
+  // |error| is empty when the script ran successfully.
+  using StartCallback = base::OnceCallback<void(const std::string& error)>;
+  using ResponseCallback = base::OnceCallback<void(base::Value)>;
+
+  explicit WebRequestWorker(const MessageCallback& on_message);
+  ~WebRequestWorker();
+
+  // Creates the isolate and runs |source| in it. If the worker goes away
+  // before the script ran, |callback| is called with an error.
+  void Start(const std::string& source, StartCallback callback);
+
+  bool HasListener() const { return !listeners_.empty(); }
+
+  // Returns whether the worker has a listener for |event| whose filter
+  // matches |url|.
+  bool HasListener(const std::string& event, const GURL& url) const;
+
+  // Calls the listener of |event| with |details|.
+  void DispatchEvent(const std::string& event, base::Value details);
+
+  // Calls the listener of |event| with |details|, and |callback| with the
+  // object the listener passes to its callback. If the worker goes away
+  // before the listener answers, |callback| is called with a none value.
+  void DispatchEvent(const std::string& event,
+                     base::Value details,
+                     ResponseCallback callback);
+
+  // Delivers |message| to port.onmessage in the worker.
+  void PostMessage(base::Value message);
+
+ private:
+  class Core;
+
+  void OnStarted(const std::string& error);
+  void OnListenerChanged(const std::string& event,
+                         const std::set<URLPattern>& patterns,
+                         bool has_listener);
+  void OnMessage(base::Value message);
+  void OnResponse(uint64_t id, base::Value response);
+
+  MessageCallback on_message_;
+  StartCallback start_callback_;
+
+  std::unique_ptr<base::Thread> thread_;
+  // Lives on |thread_|.
+  Core* core_ = nullptr;
+
+  // Event name => filter of the listener registered by the worker, an empty
+  // filter matches all URLs.
+  std::map<std::string, URLPatternMatcher> listeners_;
+
+  uint64_t next_response_id_ = 1;
+  std::map<uint64_t, ResponseCallback> pending_responses_;
+
+  base::WeakPtrFactory<WebRequestWorker> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestWorker);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_WEB_REQUEST_WORKER_H_
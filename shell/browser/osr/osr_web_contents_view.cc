@@ -62,7 +62,13 @@ void OffScreenWebContentsView::OnWindowClosed() {
 }
 
 gfx::Size OffScreenWebContentsView::GetSize() {
-  return native_window_ ? native_window_->GetSize() : gfx::Size();
+  return native_window_ ? native_window_->GetSize() : size_;
+}
+
+void OffScreenWebContentsView::SetSize(const gfx::Size& size) {
+  size_ = size;
+  if (!native_window_)
+    OnWindowResize();
 }
 
 #if !defined(OS_MACOSX)
@@ -38,6 +38,8 @@ class OffScreenWebContentsView : public content::WebContentsView,
   void OnWindowClosed() override;
 
   gfx::Size GetSize();
+  // The size used when there is no window to take it from.
+  void SetSize(const gfx::Size& size);
 
   // content::WebContentsView:
   gfx::NativeView GetNativeView() const override;
@@ -92,6 +94,7 @@ class OffScreenWebContentsView : public content::WebContentsView,
   OffScreenRenderWidgetHostView* GetView() const;
 
   NativeWindow* native_window_;
+  gfx::Size size_;
 
   const bool transparent_;
   bool painting_ = true;
@@ -23,6 +23,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/web_contents.h"
+#include "shell/browser/api/atom_api_pdf_data.h"
 #include "shell/common/gin_helper/locker.h"
 
 #include "shell/common/node_includes.h"
@@ -49,6 +50,16 @@ void StopWorker(int document_cookie) {
 
 }  // namespace
 
+PrintPreviewMessageHandler::PendingRequest::PendingRequest(
+    bool raw,
+    gin_helper::Promise<v8::Local<v8::Value>> promise)
+    : raw(raw), promise(std::move(promise)) {}
+
+PrintPreviewMessageHandler::PendingRequest::PendingRequest(PendingRequest&&) =
+    default;
+
+PrintPreviewMessageHandler::PendingRequest::~PendingRequest() = default;
+
 PrintPreviewMessageHandler::PrintPreviewMessageHandler(
     content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents), weak_ptr_factory_(this) {
@@ -80,6 +91,15 @@ bool PrintPreviewMessageHandler::OnMessageReceived(
   return handled;
 }
 
+void PrintPreviewMessageHandler::RenderProcessGone(
+    base::TerminationStatus status) {
+  RejectAllPromises();
+}
+
+void PrintPreviewMessageHandler::WebContentsDestroyed() {
+  RejectAllPromises();
+}
+
 void PrintPreviewMessageHandler::OnMetafileReadyForPrinting(
     content::RenderFrameHost* render_frame_host,
     const PrintHostMsg_DidPreviewDocument_Params& params,
@@ -144,10 +164,11 @@ void PrintPreviewMessageHandler::OnPrintPreviewCancelled(
 
 void PrintPreviewMessageHandler::PrintToPDF(
     base::DictionaryValue options,
+    bool raw,
     gin_helper::Promise<v8::Local<v8::Value>> promise) {
   int request_id;
   options.GetInteger(printing::kPreviewRequestID, &request_id);
-  promise_map_.emplace(request_id, std::move(promise));
+  request_map_.emplace(request_id, PendingRequest(raw, std::move(promise)));
 
   auto* focused_frame = web_contents()->GetFocusedFrame();
   auto* rfh = focused_frame && focused_frame->HasSelection()
@@ -156,15 +177,16 @@ void PrintPreviewMessageHandler::PrintToPDF(
   rfh->Send(new PrintMsg_PrintPreview(rfh->GetRoutingID(), options));
 }
 
-gin_helper::Promise<v8::Local<v8::Value>>
-PrintPreviewMessageHandler::GetPromise(int request_id) {
-  auto it = promise_map_.find(request_id);
-  DCHECK(it != promise_map_.end());
+base::Optional<PrintPreviewMessageHandler::PendingRequest>
+PrintPreviewMessageHandler::TakeRequest(int request_id) {
+  auto it = request_map_.find(request_id);
+  if (it == request_map_.end())
+    return base::nullopt;
 
-  gin_helper::Promise<v8::Local<v8::Value>> promise = std::move(it->second);
-  promise_map_.erase(it);
+  base::Optional<PendingRequest> request(std::move(it->second));
+  request_map_.erase(it);
 
-  return promise;
+  return request;
 }
 
 void PrintPreviewMessageHandler::ResolvePromise(
@@ -172,7 +194,10 @@ void PrintPreviewMessageHandler::ResolvePromise(
     scoped_refptr<base::RefCountedMemory> data_bytes) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
-  gin_helper::Promise<v8::Local<v8::Value>> promise = GetPromise(request_id);
+  base::Optional<PendingRequest> request = TakeRequest(request_id);
+  if (!request)
+    return;
+  gin_helper::Promise<v8::Local<v8::Value>>& promise = request->promise;
 
   v8::Isolate* isolate = promise.isolate();
   gin_helper::Locker locker(isolate);
@@ -180,6 +205,12 @@ void PrintPreviewMessageHandler::ResolvePromise(
   v8::Context::Scope context_scope(
       v8::Local<v8::Context>::New(isolate, promise.GetContext()));
 
+  if (request->raw) {
+    promise.Resolve(
+        api::PdfData::Create(isolate, std::move(data_bytes)).ToV8());
+    return;
+  }
+
   v8::Local<v8::Value> buffer =
       node::Buffer::Copy(isolate,
                          reinterpret_cast<const char*>(data_bytes->front()),
@@ -192,8 +223,18 @@ void PrintPreviewMessageHandler::ResolvePromise(
 void PrintPreviewMessageHandler::RejectPromise(int request_id) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
-  gin_helper::Promise<v8::Local<v8::Value>> promise = GetPromise(request_id);
-  promise.RejectWithErrorMessage("Failed to generate PDF");
+  base::Optional<PendingRequest> request = TakeRequest(request_id);
+  if (request)
+    request->promise.RejectWithErrorMessage("Failed to generate PDF");
+}
+
+void PrintPreviewMessageHandler::RejectAllPromises() {
+  // The renderer will not answer anymore, callers waiting for a slot to print
+  // must not be kept waiting.
+  RequestMap requests;
+  requests.swap(request_map_);
+  for (auto& request : requests)
+    request.second.promise.RejectWithErrorMessage("Failed to generate PDF");
 }
 
 WEB_CONTENTS_USER_DATA_KEY_IMPL(PrintPreviewMessageHandler)
@@ -9,6 +9,7 @@
 
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "base/optional.h"
 #include "components/services/pdf_compositor/public/mojom/pdf_compositor.mojom.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
@@ -31,13 +32,18 @@ class PrintPreviewMessageHandler
  public:
   ~PrintPreviewMessageHandler() override;
 
+  // With |raw| the promise is resolved with a PdfData instead of a Buffer,
+  // which leaves the document in shared memory.
   void PrintToPDF(base::DictionaryValue options,
+                  bool raw,
                   gin_helper::Promise<v8::Local<v8::Value>> promise);
 
  protected:
   // content::WebContentsObserver implementation.
   bool OnMessageReceived(const IPC::Message& message,
                          content::RenderFrameHost* render_frame_host) override;
+  void RenderProcessGone(base::TerminationStatus status) override;
+  void WebContentsDestroyed() override;
 
  private:
   friend class content::WebContentsUserData<PrintPreviewMessageHandler>;
@@ -56,14 +62,25 @@ class PrintPreviewMessageHandler
   void OnPrintPreviewCancelled(int document_cookie,
                                const PrintHostMsg_PreviewIds& ids);
 
-  gin_helper::Promise<v8::Local<v8::Value>> GetPromise(int request_id);
+  struct PendingRequest {
+    PendingRequest(bool raw, gin_helper::Promise<v8::Local<v8::Value>> promise);
+    PendingRequest(PendingRequest&&);
+    ~PendingRequest();
+
+    bool raw;
+    gin_helper::Promise<v8::Local<v8::Value>> promise;
+  };
+
+  // Requests are gone once the renderer is, late replies find nothing.
+  base::Optional<PendingRequest> TakeRequest(int request_id);
 
   void ResolvePromise(int request_id,
                       scoped_refptr<base::RefCountedMemory> data_bytes);
   void RejectPromise(int request_id);
+  void RejectAllPromises();
 
-  using PromiseMap = std::map<int, gin_helper::Promise<v8::Local<v8::Value>>>;
-  PromiseMap promise_map_;
+  using RequestMap = std::map<int, PendingRequest>;
+  RequestMap request_map_;
 
   base::WeakPtrFactory<PrintPreviewMessageHandler> weak_ptr_factory_;
 
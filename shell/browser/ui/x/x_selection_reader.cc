@@ -0,0 +1,252 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/ui/x/x_selection_reader.h"
+
+#include <poll.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/task_runner_util.h"
+#include "ui/gfx/x/x11.h"
+
+namespace electron {
+
+namespace {
+
+// The property the owner of the selection writes the data to.
+const char kSelectionProperty[] = "ELECTRON_SELECTION";
+
+// The size of the reads of the property, in 32-bit units.
+const long kPropertyChunkSize = 256 * 1024;  // NOLINT(runtime/int)
+
+}  // namespace
+
+XSelectionReader::Result::Result() = default;
+XSelectionReader::Result::Result(Result&&) = default;
+XSelectionReader::Result& XSelectionReader::Result::operator=(Result&&) =
+    default;
+XSelectionReader::Result::~Result() = default;
+
+// A connection to the X server with a hidden window the selections are
+// converted to. It is only used on the reader's thread.
+class XSelectionReader::Connection {
+ public:
+  Connection() : display_(XOpenDisplay(nullptr)) {
+    if (!display_)
+      return;
+    window_ = XCreateSimpleWindow(display_, DefaultRootWindow(display_), 0, 0,
+                                  1, 1, 0, 0, 0);
+    // INCR transfers are driven by the changes of the property.
+    XSelectInput(display_, window_, PropertyChangeMask);
+    property_ = GetAtom(kSelectionProperty);
+  }
+
+  ~Connection() {
+    if (!display_)
+      return;
+    XDestroyWindow(display_, window_);
+    XCloseDisplay(display_);
+  }
+
+  Result Read(const std::string& selection,
+              const std::vector<std::string>& targets,
+              base::TimeDelta timeout) {
+    Result result;
+    if (!display_)
+      return result;
+
+    ::Atom selection_atom = GetAtom(selection.c_str());
+    std::string offered;
+    ::Atom type;
+    result.status =
+        Convert(selection_atom, GetAtom("TARGETS"), timeout, &type, &offered);
+    if (result.status != ReadStatus::kSuccess)
+      return result;
+
+    // The targets are a list of atoms, which Xlib hands out as longs.
+    const auto* offered_atoms = reinterpret_cast<const ::Atom*>(offered.data());
+    size_t offered_count = offered.size() / sizeof(::Atom);
+    auto is_offered = [&](::Atom atom) {
+      return std::find(offered_atoms, offered_atoms + offered_count, atom) !=
+             offered_atoms + offered_count;
+    };
+    for (const std::string& target : targets) {
+      ::Atom target_atom = GetAtom(target.c_str());
+      if (!is_offered(target_atom))
+        continue;
+      result.target = target;
+      result.status = Convert(selection_atom, target_atom, timeout, &type,
+                              &result.data);
+      return result;
+    }
+    result.status = ReadStatus::kUnavailable;
+    return result;
+  }
+
+ private:
+  ::Atom GetAtom(const char* name) {
+    return XInternAtom(display_, name, x11::False);
+  }
+
+  ReadStatus Convert(::Atom selection,
+                     ::Atom target,
+                     base::TimeDelta timeout,
+                     ::Atom* type,
+                     std::string* data) {
+    data->clear();
+    DiscardPendingEvents();
+    XDeleteProperty(display_, window_, property_);
+    XConvertSelection(display_, selection, target, property_, window_,
+                      x11::CurrentTime);
+    XFlush(display_);
+
+    XEvent event;
+    bool received = WaitForEvent(
+        timeout,
+        [&](const XEvent& candidate) {
+          return candidate.type == SelectionNotify &&
+                 candidate.xselection.requestor == window_ &&
+                 candidate.xselection.selection == selection &&
+                 candidate.xselection.target == target;
+        },
+        &event);
+    if (!received)
+      return ReadStatus::kTimeout;
+    // The owner refused the conversion, or there is no owner.
+    if (event.xselection.property == x11::None)
+      return ReadStatus::kUnavailable;
+    if (!ReadProperty(type, data))
+      return ReadStatus::kFailed;
+    if (*type != GetAtom("INCR"))
+      return ReadStatus::kSuccess;
+
+    // Reading the INCR property deleted it, which asks for the first chunk.
+    // Every chunk is then written to the property, and deleting it asks for
+    // the next one, until an empty chunk ends the transfer.
+    data->clear();
+    for (;;) {
+      received = WaitForEvent(
+          timeout,
+          [&](const XEvent& candidate) {
+            return candidate.type == PropertyNotify &&
+                   candidate.xproperty.window == window_ &&
+                   candidate.xproperty.atom == property_ &&
+                   candidate.xproperty.state == PropertyNewValue;
+          },
+          &event);
+      if (!received)
+        return ReadStatus::kTimeout;
+      std::string chunk;
+      if (!ReadProperty(type, &chunk))
+        return ReadStatus::kFailed;
+      if (chunk.empty())
+        return ReadStatus::kSuccess;
+      data->append(chunk);
+    }
+  }
+
+  // Reads the whole property in chunks, and deletes it.
+  bool ReadProperty(::Atom* type, std::string* data) {
+    long offset = 0;  // NOLINT(runtime/int)
+    for (;;) {
+      int format = 0;
+      unsigned long item_count = 0;   // NOLINT(runtime/int)
+      unsigned long bytes_after = 0;  // NOLINT(runtime/int)
+      unsigned char* value = nullptr;
+      if (XGetWindowProperty(display_, window_, property_, offset,
+                             kPropertyChunkSize, x11::False, AnyPropertyType,
+                             type, &format, &item_count, &bytes_after,
+                             &value) != x11::Success) {
+        return false;
+      }
+      if (*type == x11::None) {
+        XFree(value);
+        return false;
+      }
+      // Items of format 32 are stored in longs.
+      size_t item_size = format == 32 ? sizeof(long) : format / 8;  // NOLINT
+      data->append(reinterpret_cast<const char*>(value),
+                   item_count * item_size);
+      XFree(value);
+      offset += item_count * format / 32;
+      if (bytes_after == 0)
+        break;
+    }
+    XDeleteProperty(display_, window_, property_);
+    XFlush(display_);
+    return true;
+  }
+
+  // Events left over from a read that timed out must not be mistaken for
+  // replies to the next one.
+  void DiscardPendingEvents() {
+    XEvent event;
+    while (XPending(display_))
+      XNextEvent(display_, &event);
+  }
+
+  template <typename Predicate>
+  bool WaitForEvent(base::TimeDelta timeout,
+                    Predicate predicate,
+                    XEvent* event) {
+    base::TimeTicks deadline = base::TimeTicks::Now() + timeout;
+    for (;;) {
+      while (XPending(display_)) {
+        XNextEvent(display_, event);
+        if (predicate(*event))
+          return true;
+      }
+      base::TimeDelta remaining = deadline - base::TimeTicks::Now();
+      if (remaining <= base::TimeDelta())
+        return false;
+      pollfd fd = {ConnectionNumber(display_), POLLIN, 0};
+      if (HANDLE_EINTR(poll(&fd, 1, remaining.InMillisecondsRoundedUp())) <=
+          0)
+        return false;
+    }
+  }
+
+  XDisplay* display_;
+  ::Window window_ = x11::None;
+  ::Atom property_ = x11::None;
+
+  DISALLOW_COPY_AND_ASSIGN(Connection);
+};
+
+// static
+XSelectionReader* XSelectionReader::GetInstance() {
+  static base::NoDestructor<XSelectionReader> instance;
+  return instance.get();
+}
+
+XSelectionReader::XSelectionReader() : thread_("ElectronXSelection") {
+  thread_.Start();
+}
+
+XSelectionReader::~XSelectionReader() = default;
+
+void XSelectionReader::Read(const std::string& selection,
+                            std::vector<std::string> targets,
+                            base::TimeDelta timeout,
+                            ReadCallback callback) {
+  base::PostTaskAndReplyWithResult(
+      thread_.task_runner().get(), FROM_HERE,
+      base::BindOnce(
+          [](XSelectionReader* reader, const std::string& selection,
+             std::vector<std::string> targets, base::TimeDelta timeout) {
+            // The connection is opened on the first read and kept, reads are
+            // done one at a time.
+            if (!reader->connection_)
+              reader->connection_ = std::make_unique<Connection>();
+            return reader->connection_->Read(selection, targets, timeout);
+          },
+          base::Unretained(this), selection, std::move(targets), timeout),
+      std::move(callback));
+}
+
+}  // namespace electron
@@ -0,0 +1,76 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_UI_X_X_SELECTION_READER_H_
+#define SHELL_BROWSER_UI_X_X_SELECTION_READER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+
+namespace electron {
+
+// Reads X selections on a thread with its own connection to the X server, so
+// waiting for the owner of a selection never blocks the UI thread.
+//
+// Large selections sent incrementally (INCR) are supported. The timeout is
+// the longest time to wait for the owner between two replies, so a large
+// transfer can take longer as long as it makes progress.
+class XSelectionReader {
+ public:
+  enum class ReadStatus {
+    kSuccess,
+    // The owner does not offer any of the targets, or there is no owner.
+    kUnavailable,
+    kTimeout,
+    kFailed,
+  };
+
+  struct Result {
+    Result();
+    Result(Result&&);
+    Result& operator=(Result&&);
+    ~Result();
+
+    ReadStatus status = ReadStatus::kFailed;
+    // The target the selection was converted to.
+    std::string target;
+    std::string data;
+  };
+
+  using ReadCallback = base::OnceCallback<void(Result)>;
+
+  static XSelectionReader* GetInstance();
+
+  // Converts |selection|, "CLIPBOARD" or "PRIMARY", to the first of |targets|
+  // offered by its owner. |callback| is called on the calling sequence.
+  void Read(const std::string& selection,
+            std::vector<std::string> targets,
+            base::TimeDelta timeout,
+            ReadCallback callback);
+
+ private:
+  friend class base::NoDestructor<XSelectionReader>;
+
+  class Connection;
+
+  XSelectionReader();
+  ~XSelectionReader();
+
+  base::Thread thread_;
+  // Lives on |thread_|.
+  std::unique_ptr<Connection> connection_;
+
+  DISALLOW_COPY_AND_ASSIGN(XSelectionReader);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_UI_X_X_SELECTION_READER_H_
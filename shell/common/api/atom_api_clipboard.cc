@@ -4,20 +4,247 @@
 
 #include "shell/common/api/atom_api_clipboard.h"
 
+#include <utility>
+
+#include "base/stl_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "shell/common/gin_converters/image_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixmap.h"
+#include "ui/base/clipboard/clipboard_constants.h"
 #include "ui/base/clipboard/clipboard_format_type.h"
 #include "ui/base/clipboard/scoped_clipboard_writer.h"
 
+#if defined(USE_X11)
+#include "base/bind.h"
+#include "base/task/post_task.h"
+#include "shell/browser/ui/x/x_selection_reader.h"
+#include "shell/common/gin_helper/locker.h"
+#include "ui/gfx/codec/png_codec.h"
+#endif
+
 namespace electron {
 
 namespace api {
 
+namespace {
+
+// readMany() reads the formats again when the clipboard changes while they
+// are being read, so they all come from the same copy.
+const int kMaxReadManyAttempts = 3;
+
+base::string16 ReadTextFrom(ui::Clipboard* clipboard,
+                            ui::ClipboardBuffer type) {
+  base::string16 data;
+  if (clipboard->IsFormatAvailable(ui::ClipboardFormatType::GetPlainTextWType(),
+                                   type)) {
+    clipboard->ReadText(type, &data);
+  } else if (clipboard->IsFormatAvailable(
+                 ui::ClipboardFormatType::GetPlainTextType(), type)) {
+    std::string result;
+    clipboard->ReadAsciiText(type, &result);
+    data = base::ASCIIToUTF16(result);
+  }
+  return data;
+}
+
+base::string16 ReadHTMLFrom(ui::Clipboard* clipboard,
+                            ui::ClipboardBuffer type) {
+  base::string16 html;
+  std::string url;
+  uint32_t start;
+  uint32_t end;
+  clipboard->ReadHTML(type, &html, &url, &start, &end);
+  return html.substr(start, end - start);
+}
+
+void WriteImageTo(ui::ScopedClipboardWriter* writer, const gfx::Image& image) {
+  SkBitmap orig = image.AsBitmap();
+  SkBitmap bmp;
+
+  if (bmp.tryAllocPixels(orig.info()) &&
+      orig.readPixels(bmp.info(), bmp.getPixels(), bmp.rowBytes(), 0, 0)) {
+    writer->WriteImage(bmp);
+  }
+}
+
+v8::Local<v8::Value> ReadFormats(v8::Isolate* isolate,
+                                 const std::vector<std::string>& formats,
+                                 ui::ClipboardBuffer type) {
+  ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
+  gin_helper::Dictionary dict = gin_helper::Dictionary::CreateEmpty(isolate);
+
+  // The available types are asked for once, instead of once per format.
+  std::vector<base::string16> types;
+  bool ignore;
+  clipboard->ReadAvailableTypes(type, &types, &ignore);
+  auto has_type = [&types](const char* mime_type) {
+    return base::Contains(types, base::ASCIIToUTF16(mime_type));
+  };
+
+  for (const std::string& format : formats) {
+    if (format == "text") {
+      if (has_type(ui::kMimeTypeText))
+        dict.Set(format, ReadTextFrom(clipboard, type));
+    } else if (format == "html") {
+      if (has_type(ui::kMimeTypeHTML))
+        dict.Set(format, ReadHTMLFrom(clipboard, type));
+    } else if (format == "rtf") {
+      if (has_type(ui::kMimeTypeRTF)) {
+        std::string rtf;
+        clipboard->ReadRTF(type, &rtf);
+        dict.Set(format, base::UTF8ToUTF16(rtf));
+      }
+    } else if (format == "image") {
+      if (has_type(ui::kMimeTypePNG)) {
+        dict.Set(format,
+                 gfx::Image::CreateFrom1xBitmap(clipboard->ReadImage(type)));
+      }
+    } else if (format == "bookmark") {
+      base::string16 title;
+      std::string url;
+      clipboard->ReadBookmark(&title, &url);
+      if (!url.empty()) {
+        gin_helper::Dictionary bookmark =
+            gin_helper::Dictionary::CreateEmpty(isolate);
+        bookmark.Set("title", title);
+        bookmark.Set("url", url);
+        dict.Set(format, bookmark);
+      }
+    } else {
+      ui::ClipboardFormatType format_type(
+          ui::ClipboardFormatType::GetType(format));
+      if (clipboard->IsFormatAvailable(format_type, type)) {
+        std::string data;
+        clipboard->ReadData(format_type, &data);
+        dict.Set(format, node::Buffer::Copy(isolate, data.data(), data.size())
+                             .ToLocalChecked());
+      }
+    }
+  }
+  return dict.GetHandle();
+}
+
+#if defined(USE_X11)
+// The longest time to wait for the owner of the selection between two of its
+// replies.
+const int kDefaultReadTimeoutMs = 1000;
+
+std::vector<std::string> GetSelectionTargets(const std::string& format) {
+  if (format == "text")
+    return {"UTF8_STRING", "text/plain;charset=utf-8", "STRING", "TEXT",
+            "text/plain"};
+  if (format == "html")
+    return {"text/html"};
+  if (format == "rtf")
+    return {"text/rtf"};
+  if (format == "image")
+    return {"image/png"};
+  return {format};
+}
+
+base::string16 DecodeSelectionText(const std::string& target,
+                                   const std::string& data) {
+  // Firefox writes HTML in UTF-16, with a byte order mark.
+  if (data.size() >= 2 && data[0] == '\xff' && data[1] == '\xfe') {
+    const auto* chars = reinterpret_cast<const base::char16*>(data.data());
+    return base::string16(chars + 1, chars + data.size() / 2);
+  }
+  // STRING and TEXT are Latin-1.
+  if (target == "STRING" || target == "TEXT") {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    return base::string16(bytes, bytes + data.size());
+  }
+  return base::UTF8ToUTF16(data);
+}
+
+SkBitmap DecodeSelectionImage(const std::string& data) {
+  SkBitmap bitmap;
+  gfx::PNGCodec::Decode(reinterpret_cast<const unsigned char*>(data.data()),
+                        data.size(), &bitmap);
+  return bitmap;
+}
+
+void ResolveWithImage(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                      SkBitmap bitmap) {
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+  promise.Resolve(
+      gin::ConvertToV8(isolate, gfx::Image::CreateFrom1xBitmap(bitmap)));
+}
+
+void OnSelectionRead(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                     const std::string& format,
+                     XSelectionReader::Result result) {
+  switch (result.status) {
+    case XSelectionReader::ReadStatus::kTimeout:
+      promise.RejectWithErrorMessage("Timed out reading the clipboard");
+      return;
+    case XSelectionReader::ReadStatus::kFailed:
+      promise.RejectWithErrorMessage("Failed to read the clipboard");
+      return;
+    case XSelectionReader::ReadStatus::kUnavailable:
+      result.data.clear();
+      break;
+    case XSelectionReader::ReadStatus::kSuccess:
+      break;
+  }
+
+  // Large images are decoded away from the UI thread as well.
+  if (format == "image") {
+    base::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_BLOCKING},
+        base::BindOnce(&DecodeSelectionImage, std::move(result.data)),
+        base::BindOnce(&ResolveWithImage, std::move(promise)));
+    return;
+  }
+
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+  if (format == "text" || format == "html" || format == "rtf") {
+    promise.Resolve(gin::ConvertToV8(
+        isolate, DecodeSelectionText(result.target, result.data)));
+  } else {
+    promise.Resolve(
+        node::Buffer::Copy(isolate, result.data.data(), result.data.size())
+            .ToLocalChecked());
+  }
+}
+#else
+// Reads |format| the way the synchronous readers do.
+v8::Local<v8::Value> ReadFormat(v8::Isolate* isolate,
+                                const std::string& format,
+                                ui::ClipboardBuffer type) {
+  ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
+  if (format == "text")
+    return gin::ConvertToV8(isolate, ReadTextFrom(clipboard, type));
+  if (format == "html")
+    return gin::ConvertToV8(isolate, ReadHTMLFrom(clipboard, type));
+  if (format == "rtf") {
+    std::string rtf;
+    clipboard->ReadRTF(type, &rtf);
+    return gin::ConvertToV8(isolate, base::UTF8ToUTF16(rtf));
+  }
+  if (format == "image") {
+    return gin::ConvertToV8(
+        isolate, gfx::Image::CreateFrom1xBitmap(clipboard->ReadImage(type)));
+  }
+  std::string data;
+  clipboard->ReadData(ui::ClipboardFormatType::GetType(format), &data);
+  return node::Buffer::Copy(isolate, data.data(), data.size()).ToLocalChecked();
+}
+#endif
+
+}  // namespace
+
 ui::ClipboardBuffer Clipboard::GetClipboardBuffer(gin_helper::Arguments* args) {
   std::string type;
   if (args->GetNext(&type) && type == "selection")
@@ -103,20 +330,129 @@ void Clipboard::Write(const gin_helper::Dictionary& data,
     writer.WriteImage(image.AsBitmap());
 }
 
-base::string16 Clipboard::ReadText(gin_helper::Arguments* args) {
-  base::string16 data;
+v8::Local<v8::Value> Clipboard::ReadMany(
+    const std::vector<std::string>& formats,
+    gin_helper::Arguments* args) {
   ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
   auto type = GetClipboardBuffer(args);
-  if (clipboard->IsFormatAvailable(ui::ClipboardFormatType::GetPlainTextWType(),
-                                   type)) {
-    clipboard->ReadText(type, &data);
-  } else if (clipboard->IsFormatAvailable(
-                 ui::ClipboardFormatType::GetPlainTextType(), type)) {
-    std::string result;
-    clipboard->ReadAsciiText(type, &result);
-    data = base::ASCIIToUTF16(result);
+  v8::Local<v8::Value> result;
+  for (int attempt = 0; attempt < kMaxReadManyAttempts; ++attempt) {
+    uint64_t sequence_number = clipboard->GetSequenceNumber(type);
+    result = ReadFormats(args->isolate(), formats, type);
+    if (clipboard->GetSequenceNumber(type) == sequence_number)
+      break;
   }
-  return data;
+  return result;
+}
+
+void Clipboard::WriteMany(const gin_helper::Dictionary& data,
+                          gin_helper::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Array> keys;
+  if (!data.GetHandle()->GetOwnPropertyNames(context).ToLocal(&keys)) {
+    args->ThrowError("data must be an object");
+    return;
+  }
+
+  // All the formats are written together, by a single writer.
+  ui::ScopedClipboardWriter writer(GetClipboardBuffer(args));
+  for (uint32_t i = 0; i < keys->Length(); ++i) {
+    std::string format;
+    if (!gin::ConvertFromV8(isolate, keys->Get(context, i).ToLocalChecked(),
+                            &format))
+      continue;
+
+    if (format == "text") {
+      base::string16 text;
+      if (data.Get(format, &text))
+        writer.WriteText(text);
+    } else if (format == "html") {
+      base::string16 html;
+      if (data.Get(format, &html))
+        writer.WriteHTML(html, std::string());
+    } else if (format == "rtf") {
+      std::string rtf;
+      if (data.Get(format, &rtf))
+        writer.WriteRTF(rtf);
+    } else if (format == "image") {
+      gfx::Image image;
+      if (data.Get(format, &image))
+        WriteImageTo(&writer, image);
+    } else if (format == "bookmark") {
+      gin_helper::Dictionary bookmark;
+      base::string16 title;
+      std::string url;
+      if (data.Get(format, &bookmark) && bookmark.Get("url", &url)) {
+        bookmark.Get("title", &title);
+        writer.WriteBookmark(title, url);
+      }
+    } else {
+      v8::Local<v8::Value> value;
+      std::string string_value;
+      base::span<const uint8_t> payload_span;
+      if (!data.Get(format, &value)) {
+        continue;
+      } else if (node::Buffer::HasInstance(value)) {
+        payload_span = base::make_span(
+            reinterpret_cast<const uint8_t*>(node::Buffer::Data(value)),
+            node::Buffer::Length(value));
+      } else if (gin::ConvertFromV8(isolate, value, &string_value)) {
+        payload_span = base::make_span(
+            reinterpret_cast<const uint8_t*>(string_value.data()),
+            string_value.size());
+      } else {
+        writer.Reset();
+        args->ThrowError("Custom formats must be Buffers or strings");
+        return;
+      }
+      std::string format_type =
+          ui::ClipboardFormatType::GetType(format).Serialize();
+      writer.WriteData(base::UTF8ToUTF16(format_type),
+                       mojo_base::BigBuffer(payload_span));
+    }
+  }
+}
+
+uint64_t Clipboard::GetSequenceNumber(gin_helper::Arguments* args) {
+  return ui::Clipboard::GetForCurrentThread()->GetSequenceNumber(
+      GetClipboardBuffer(args));
+}
+
+v8::Local<v8::Promise> Clipboard::ReadAsync(const std::string& format,
+                                            gin_helper::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  gin_helper::Dictionary options;
+  std::string type;
+  if (args->GetNext(&options))
+    options.Get("type", &type);
+  bool selection = type == "selection";
+
+#if defined(USE_X11)
+  // The selection is converted on another connection to the X server, the UI
+  // thread only waits for the result.
+  int timeout = kDefaultReadTimeoutMs;
+  if (!options.IsEmpty())
+    options.Get("timeout", &timeout);
+  XSelectionReader::GetInstance()->Read(
+      selection ? "PRIMARY" : "CLIPBOARD", GetSelectionTargets(format),
+      base::TimeDelta::FromMilliseconds(timeout),
+      base::BindOnce(&OnSelectionRead, std::move(promise), format));
+#else
+  // Reading the clipboard does not wait for other apps on these platforms.
+  promise.Resolve(ReadFormat(isolate, format,
+                             selection ? ui::ClipboardBuffer::kSelection
+                                       : ui::ClipboardBuffer::kCopyPaste));
+#endif
+  return handle;
+}
+
+base::string16 Clipboard::ReadText(gin_helper::Arguments* args) {
+  return ReadTextFrom(ui::Clipboard::GetForCurrentThread(),
+                      GetClipboardBuffer(args));
 }
 
 void Clipboard::WriteText(const base::string16& text,
@@ -138,15 +474,8 @@ void Clipboard::WriteRTF(const std::string& text, gin_helper::Arguments* args) {
 }
 
 base::string16 Clipboard::ReadHTML(gin_helper::Arguments* args) {
-  base::string16 data;
-  base::string16 html;
-  std::string url;
-  uint32_t start;
-  uint32_t end;
-  ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
-  clipboard->ReadHTML(GetClipboardBuffer(args), &html, &url, &start, &end);
-  data = html.substr(start, end - start);
-  return data;
+  return ReadHTMLFrom(ui::Clipboard::GetForCurrentThread(),
+                      GetClipboardBuffer(args));
 }
 
 void Clipboard::WriteHTML(const base::string16& html,
@@ -183,13 +512,7 @@ gfx::Image Clipboard::ReadImage(gin_helper::Arguments* args) {
 void Clipboard::WriteImage(const gfx::Image& image,
                            gin_helper::Arguments* args) {
   ui::ScopedClipboardWriter writer(GetClipboardBuffer(args));
-  SkBitmap orig = image.AsBitmap();
-  SkBitmap bmp;
-
-  if (bmp.tryAllocPixels(orig.info()) &&
-      orig.readPixels(bmp.info(), bmp.getPixels(), bmp.rowBytes(), 0, 0)) {
-    writer.WriteImage(bmp);
-  }
+  WriteImageTo(&writer, image);
 }
 
 #if !defined(OS_MACOSX)
@@ -219,6 +542,11 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("has", &electron::api::Clipboard::Has);
   dict.SetMethod("read", &electron::api::Clipboard::Read);
   dict.SetMethod("write", &electron::api::Clipboard::Write);
+  dict.SetMethod("readMany", &electron::api::Clipboard::ReadMany);
+  dict.SetMethod("_writeMany", &electron::api::Clipboard::WriteMany);
+  dict.SetMethod("_getSequenceNumber",
+                 &electron::api::Clipboard::GetSequenceNumber);
+  dict.SetMethod("readAsync", &electron::api::Clipboard::ReadAsync);
   dict.SetMethod("readText", &electron::api::Clipboard::ReadText);
   dict.SetMethod("writeText", &electron::api::Clipboard::WriteText);
   dict.SetMethod("readRTF", &electron::api::Clipboard::ReadRTF);
@@ -34,6 +34,14 @@ class Clipboard {
   static void Write(const gin_helper::Dictionary& data,
                     gin_helper::Arguments* args);
 
+  static v8::Local<v8::Value> ReadMany(const std::vector<std::string>& formats,
+                                       gin_helper::Arguments* args);
+  static void WriteMany(const gin_helper::Dictionary& data,
+                        gin_helper::Arguments* args);
+  static uint64_t GetSequenceNumber(gin_helper::Arguments* args);
+  static v8::Local<v8::Promise> ReadAsync(const std::string& format,
+                                          gin_helper::Arguments* args);
+
   static base::string16 ReadText(gin_helper::Arguments* args);
   static void WriteText(const base::string16& text,
                         gin_helper::Arguments* args);
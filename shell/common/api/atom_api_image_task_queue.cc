@@ -0,0 +1,110 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/api/atom_api_image_task_queue.h"
+
+#include <algorithm>
+
+#include "base/system/sys_info.h"
+#include "base/task/post_task.h"
+#include "gin/converter.h"
+#include "gin/object_template_builder.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+// Private key of the default queue on the global object.
+const char kDefaultQueueKey[] = "electron::ImageTaskQueue::default";
+
+}  // namespace
+
+gin::WrapperInfo ImageTaskQueue::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+ImageTaskQueue::ImageTaskQueue(v8::Isolate* isolate, int concurrency)
+    : isolate_(isolate),
+      concurrency_(concurrency),
+      task_runner_(base::CreateTaskRunner(
+          {base::ThreadPool(), base::MayBlock(),
+           base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+
+ImageTaskQueue::~ImageTaskQueue() = default;
+
+// static
+gin::Handle<ImageTaskQueue> ImageTaskQueue::Create(v8::Isolate* isolate,
+                                                   int concurrency) {
+  return gin::CreateHandle(isolate, new ImageTaskQueue(isolate, concurrency));
+}
+
+// static
+ImageTaskQueue* ImageTaskQueue::GetDefault(v8::Isolate* isolate) {
+  // The queue is kept by the global object, so it is collected with the
+  // context instead of outliving the isolate.
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> global = context->Global();
+  v8::Local<v8::Private> key =
+      v8::Private::ForApi(isolate, gin::StringToV8(isolate, kDefaultQueueKey));
+  v8::Local<v8::Value> value;
+  ImageTaskQueue* queue = nullptr;
+  if (global->GetPrivate(context, key).ToLocal(&value) &&
+      gin::ConvertFromV8(isolate, value, &queue))
+    return queue;
+
+  // Leave a core to the thread that waits for the results.
+  int concurrency = std::max(base::SysInfo::NumberOfProcessors() - 1, 1);
+  auto handle = Create(isolate, concurrency);
+  global->SetPrivate(context, key, handle.ToV8());
+  return handle.get();
+}
+
+void ImageTaskQueue::Enqueue(PendingTask task) {
+  if (self_.IsEmpty()) {
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> wrapper;
+    if (GetWrapper(isolate_).ToLocal(&wrapper))
+      self_.Reset(isolate_, wrapper);
+  }
+  pending_.push_back(std::move(task));
+  RunPendingTasks();
+}
+
+void ImageTaskQueue::RunPendingTasks() {
+  while (running_ < concurrency_ && !pending_.empty()) {
+    PendingTask task = std::move(pending_.front());
+    pending_.pop_front();
+    ++running_;
+    std::move(task).Run(false);
+  }
+  if (running_ == 0 && pending_.empty())
+    self_.Reset();
+}
+
+void ImageTaskQueue::Cancel() {
+  ++generation_;
+  std::deque<PendingTask> pending;
+  pending.swap(pending_);
+  for (PendingTask& task : pending)
+    std::move(task).Run(true);
+  if (running_ == 0)
+    self_.Reset();
+}
+
+gin::ObjectTemplateBuilder ImageTaskQueue::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<ImageTaskQueue>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("cancel", &ImageTaskQueue::Cancel)
+      .SetProperty("concurrency", &ImageTaskQueue::GetConcurrency)
+      .SetProperty("pending", &ImageTaskQueue::GetPendingCount);
+}
+
+const char* ImageTaskQueue::GetTypeName() {
+  return "ImageTaskQueue";
+}
+
+}  // namespace api
+
+}  // namespace electron
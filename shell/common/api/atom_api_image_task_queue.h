@@ -0,0 +1,119 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_API_ATOM_API_IMAGE_TASK_QUEUE_H_
+#define SHELL_COMMON_API_ATOM_API_IMAGE_TASK_QUEUE_H_
+
+#include <deque>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/task_runner.h"
+#include "base/task_runner_util.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+
+namespace electron {
+
+namespace api {
+
+// Runs the image operations of nativeImage's asynchronous methods on the
+// thread pool, at most |concurrency| at a time.
+//
+// Cancelling the queue drops the operations that have not started yet, and
+// the results of the running ones.
+class ImageTaskQueue : public gin::Wrappable<ImageTaskQueue> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<ImageTaskQueue> Create(v8::Isolate* isolate,
+                                            int concurrency);
+
+  // The queue used when none is passed, one per context.
+  static ImageTaskQueue* GetDefault(v8::Isolate* isolate);
+
+  // Runs |task| on the thread pool once a slot is free, and then |reply| on
+  // the calling sequence with its result, or with nullopt if the queue was
+  // cancelled in between.
+  template <typename T>
+  void Post(base::OnceCallback<T()> task,
+            base::OnceCallback<void(base::Optional<T>)> reply) {
+    Enqueue(base::BindOnce(&ImageTaskQueue::RunTask<T>,
+                           weak_factory_.GetWeakPtr(), std::move(task),
+                           std::move(reply)));
+  }
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  // Starts the task, or cancels it when passed true.
+  using PendingTask = base::OnceCallback<void(bool cancelled)>;
+
+  ImageTaskQueue(v8::Isolate* isolate, int concurrency);
+  ~ImageTaskQueue() override;
+
+  template <typename T>
+  void RunTask(base::OnceCallback<T()> task,
+               base::OnceCallback<void(base::Optional<T>)> reply,
+               bool cancelled) {
+    if (cancelled) {
+      std::move(reply).Run(base::nullopt);
+      return;
+    }
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE, std::move(task),
+        base::BindOnce(&ImageTaskQueue::OnTaskDone<T>,
+                       weak_factory_.GetWeakPtr(), generation_,
+                       std::move(reply)));
+  }
+
+  template <typename T>
+  void OnTaskDone(uint64_t generation,
+                  base::OnceCallback<void(base::Optional<T>)> reply,
+                  T result) {
+    --running_;
+    if (generation == generation_)
+      std::move(reply).Run(std::move(result));
+    else
+      std::move(reply).Run(base::nullopt);
+    RunPendingTasks();
+  }
+
+  void Enqueue(PendingTask task);
+  void RunPendingTasks();
+
+  void Cancel();
+  int GetConcurrency() const { return concurrency_; }
+  int GetPendingCount() const {
+    return static_cast<int>(pending_.size()) + running_;
+  }
+
+  v8::Isolate* isolate_;
+  int concurrency_;
+  scoped_refptr<base::TaskRunner> task_runner_;
+
+  std::deque<PendingTask> pending_;
+  int running_ = 0;
+  // Incremented on cancellation, to drop the results of running tasks.
+  uint64_t generation_ = 0;
+
+  // Keeps the wrapper alive while tasks are queued or running.
+  v8::Global<v8::Object> self_;
+
+  base::WeakPtrFactory<ImageTaskQueue> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ImageTaskQueue);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_API_ATOM_API_IMAGE_TASK_QUEUE_H_
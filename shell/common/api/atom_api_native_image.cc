@@ -10,19 +10,26 @@
 #include <vector>
 
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/optional.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "net/base/data_url.h"
+#include "shell/common/api/atom_api_image_task_queue.h"
 #include "shell/common/asar/asar_util.h"
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/gfx_converter.h"
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/locker.h"
 #include "shell/common/gin_helper/object_template_builder.h"
+#include "shell/common/gin_helper/promise.h"
+#include "shell/common/image_pipeline.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/skia_util.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -99,6 +106,245 @@ base::win::ScopedHICON ReadICOFromPath(int size, const base::FilePath& path) {
 
 void Noop(char*, void*) {}
 
+const char kCancelledMessage[] = "The image operation was cancelled";
+
+// Hands |data| over to a Buffer without copying it.
+v8::Local<v8::Value> BufferFromVector(v8::Isolate* isolate,
+                                      std::vector<unsigned char> data) {
+  if (data.empty())
+    return node::Buffer::New(isolate, 0).ToLocalChecked();
+  auto* vector = new std::vector<unsigned char>(std::move(data));
+  return node::Buffer::New(
+             isolate, reinterpret_cast<char*>(vector->data()), vector->size(),
+             [](char*, void* hint) {
+               delete static_cast<std::vector<unsigned char>*>(hint);
+             },
+             vector)
+      .ToLocalChecked();
+}
+
+// Copies |data|, the cached PNG bytes of an image must not be written to.
+v8::Local<v8::Value> BufferFromMemory(
+    v8::Isolate* isolate,
+    scoped_refptr<base::RefCountedMemory> data) {
+  return node::Buffer::Copy(isolate,
+                            reinterpret_cast<const char*>(data->front()),
+                            data->size())
+      .ToLocalChecked();
+}
+
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const std::string& quality) {
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
+// Options shared by the asynchronous methods.
+struct AsyncOptions {
+  float scale_factor = 1.0f;
+  ImageTaskQueue* queue = nullptr;
+};
+
+AsyncOptions GetAsyncOptions(v8::Isolate* isolate,
+                             const gin_helper::Dictionary* options) {
+  AsyncOptions result;
+  if (options) {
+    options->Get("scaleFactor", &result.scale_factor);
+    options->Get("queue", &result.queue);
+  }
+  if (!result.queue)
+    result.queue = ImageTaskQueue::GetDefault(isolate);
+  return result;
+}
+
+AsyncOptions GetAsyncOptions(gin::Arguments* args) {
+  gin_helper::Dictionary options;
+  bool has_options = args->GetNext(&options);
+  return GetAsyncOptions(args->isolate(), has_options ? &options : nullptr);
+}
+
+// The functions below run on the thread pool.
+
+std::vector<unsigned char> EncodePNG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
+  return encoded;
+}
+
+std::vector<unsigned char> EncodeJPEG(const SkBitmap& bitmap, int quality) {
+  std::vector<unsigned char> encoded;
+  if (!gfx::JPEGCodec::Encode(bitmap, quality, &encoded))
+    encoded.clear();
+  return encoded;
+}
+
+std::string EncodeDataURL(const SkBitmap& bitmap) {
+  return webui::GetBitmapDataUrl(bitmap);
+}
+
+gfx::ImageSkia ResizeImage(const std::vector<gfx::ImageSkiaRep>& reps,
+                           skia::ImageOperations::ResizeMethod method,
+                           const gfx::Size& size) {
+  gfx::ImageSkia resized;
+  for (const gfx::ImageSkiaRep& rep : reps) {
+    gfx::Size pixel_size = gfx::ScaleToCeiledSize(size, rep.scale());
+    if (pixel_size.IsEmpty())
+      continue;
+    resized.AddRepresentation(gfx::ImageSkiaRep(
+        skia::ImageOperations::Resize(rep.GetBitmap(), method,
+                                      pixel_size.width(), pixel_size.height()),
+        rep.scale()));
+  }
+  // The image is handed over to the JS thread.
+  resized.MakeThreadSafe();
+  return resized;
+}
+
+gfx::ImageSkia DecodePath(const base::FilePath& path) {
+  gfx::ImageSkia image_skia;
+  electron::util::PopulateImageSkiaRepsFromPath(&image_skia, path);
+  image_skia.MakeThreadSafe();
+  return image_skia;
+}
+
+gfx::ImageSkia DecodeBuffer(const std::vector<unsigned char>& data,
+                            int width,
+                            int height,
+                            double scale_factor) {
+  gfx::ImageSkia image_skia;
+  electron::util::AddImageSkiaRepFromBuffer(&image_skia, data.data(),
+                                            data.size(), width, height,
+                                            scale_factor);
+  image_skia.MakeThreadSafe();
+  return image_skia;
+}
+
+// The functions below run on the JS thread with the results.
+
+void ResolveWithBuffer(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                       base::Optional<std::vector<unsigned char>> data) {
+  if (!data) {
+    promise.RejectWithErrorMessage(kCancelledMessage);
+    return;
+  }
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+  promise.Resolve(BufferFromVector(isolate, std::move(*data)));
+}
+
+void ResolveWithString(gin_helper::Promise<std::string> promise,
+                       base::Optional<std::string> data) {
+  if (!data) {
+    promise.RejectWithErrorMessage(kCancelledMessage);
+    return;
+  }
+  promise.Resolve(*data);
+}
+
+void ResolveWithImage(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                      bool is_template,
+                      base::Optional<gfx::ImageSkia> image_skia) {
+  if (!image_skia) {
+    promise.RejectWithErrorMessage(kCancelledMessage);
+    return;
+  }
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+  gin::Handle<NativeImage> handle =
+      NativeImage::Create(isolate, gfx::Image(*image_skia));
+#if defined(OS_MACOSX)
+  if (is_template)
+    handle->SetTemplateImage(true);
+#endif
+  promise.Resolve(handle.ToV8());
+}
+
+// Collects the results of NativeImage::ProcessBatch, and settles its promise
+// once all the images are done.
+class BatchResults : public base::RefCounted<BatchResults> {
+ public:
+  BatchResults(gin_helper::Promise<v8::Local<v8::Value>> promise, size_t size)
+      : promise_(std::move(promise)), results_(size), remaining_(size) {}
+
+  void OnImageDone(size_t index,
+                   base::Optional<std::vector<unsigned char>> data) {
+    if (settled_)
+      return;
+    if (!data) {
+      settled_ = true;
+      promise_.RejectWithErrorMessage(kCancelledMessage);
+      return;
+    }
+    results_[index] = std::move(*data);
+    if (--remaining_ > 0)
+      return;
+
+    settled_ = true;
+    v8::Isolate* isolate = promise_.isolate();
+    gin_helper::Locker locker(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Context::Scope context_scope(promise_.GetContext());
+    std::vector<v8::Local<v8::Value>> buffers;
+    buffers.reserve(results_.size());
+    for (std::vector<unsigned char>& result : results_) {
+      // The images that failed are null.
+      if (result.empty())
+        buffers.push_back(v8::Null(isolate));
+      else
+        buffers.push_back(BufferFromVector(isolate, std::move(result)));
+    }
+    results_.clear();
+    promise_.Resolve(gin::ConvertToV8(isolate, buffers));
+  }
+
+ private:
+  friend class base::RefCounted<BatchResults>;
+
+  ~BatchResults() = default;
+
+  gin_helper::Promise<v8::Local<v8::Value>> promise_;
+  bool settled_ = false;
+  std::vector<std::vector<unsigned char>> results_;
+  size_t remaining_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchResults);
+};
+
+bool GetPipelineOperation(const gin_helper::Dictionary& dict,
+                          ImagePipeline::Operation* operation,
+                          std::string* error) {
+  std::string type;
+  dict.Get("type", &type);
+  if (type == "crop") {
+    operation->type = ImagePipeline::Operation::Type::kCrop;
+    if (!dict.Get("rect", &operation->rect)) {
+      *error = "crop operations must have a rect";
+      return false;
+    }
+  } else if (type == "resize") {
+    operation->type = ImagePipeline::Operation::Type::kResize;
+    int value;
+    if (dict.Get("width", &value))
+      operation->width = value;
+    if (dict.Get("height", &value))
+      operation->height = value;
+    std::string quality;
+    dict.Get("quality", &quality);
+    operation->method = GetResizeMethod(quality);
+  } else {
+    *error = "Unknown operation type: " + type;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
@@ -158,20 +404,13 @@ v8::Local<v8::Value> NativeImage::ToPNG(gin::Arguments* args) {
   if (scale_factor == 1.0f) {
     // Use raw 1x PNG bytes when available
     scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-    if (png->size() > 0) {
-      const char* data = reinterpret_cast<const char*>(png->front());
-      size_t size = png->size();
-      return node::Buffer::Copy(args->isolate(), data, size).ToLocalChecked();
-    }
+    if (png->size() > 0)
+      return BufferFromMemory(args->isolate(), std::move(png));
   }
 
   const SkBitmap bitmap =
       image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap();
-  std::vector<unsigned char> encoded;
-  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
-  const char* data = reinterpret_cast<char*>(encoded.data());
-  size_t size = encoded.size();
-  return node::Buffer::Copy(args->isolate(), data, size).ToLocalChecked();
+  return BufferFromVector(args->isolate(), EncodePNG(bitmap));
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(gin::Arguments* args) {
@@ -191,12 +430,7 @@ v8::Local<v8::Value> NativeImage::ToBitmap(gin::Arguments* args) {
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
   std::vector<unsigned char> output;
   gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
-  if (output.empty())
-    return node::Buffer::New(isolate, 0).ToLocalChecked();
-  return node::Buffer::Copy(isolate,
-                            reinterpret_cast<const char*>(&output.front()),
-                            output.size())
-      .ToLocalChecked();
+  return BufferFromVector(isolate, std::move(output));
 }
 
 std::string NativeImage::ToDataURL(gin::Arguments* args) {
@@ -213,6 +447,99 @@ std::string NativeImage::ToDataURL(gin::Arguments* args) {
       image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap());
 }
 
+v8::Local<v8::Promise> NativeImage::ToPNGAsync(gin::Arguments* args) {
+  AsyncOptions options = GetAsyncOptions(args);
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  if (options.scale_factor == 1.0f) {
+    // Use raw 1x PNG bytes when available
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    if (png->size() > 0) {
+      promise.Resolve(BufferFromMemory(args->isolate(), std::move(png)));
+      return handle;
+    }
+  }
+
+  const SkBitmap bitmap =
+      image_.AsImageSkia().GetRepresentation(options.scale_factor).GetBitmap();
+  options.queue->Post(
+      base::BindOnce(&EncodePNG, bitmap),
+      base::BindOnce(&ResolveWithBuffer, std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> NativeImage::ToJPEGAsync(gin::Arguments* args) {
+  int quality = 0;
+  if (!args->GetNext(&quality)) {
+    args->ThrowTypeError("Must pass the quality");
+    return v8::Local<v8::Promise>();
+  }
+  AsyncOptions options = GetAsyncOptions(args);
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  options.queue->Post(
+      base::BindOnce(&EncodeJPEG,
+                     image_.AsImageSkia().GetRepresentation(1.0f).GetBitmap(),
+                     quality),
+      base::BindOnce(&ResolveWithBuffer, std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> NativeImage::ToDataURLAsync(gin::Arguments* args) {
+  AsyncOptions options = GetAsyncOptions(args);
+  gin_helper::Promise<std::string> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  if (options.scale_factor == 1.0f) {
+    // Use raw 1x PNG bytes when available
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    if (png->size() > 0) {
+      promise.Resolve(webui::GetPngDataUrl(png->front(), png->size()));
+      return handle;
+    }
+  }
+
+  const SkBitmap bitmap =
+      image_.AsImageSkia().GetRepresentation(options.scale_factor).GetBitmap();
+  options.queue->Post(
+      base::BindOnce(&EncodeDataURL, bitmap),
+      base::BindOnce(&ResolveWithString, std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> NativeImage::ResizeAsync(gin::Arguments* args) {
+  gin_helper::Dictionary dict;
+  if (!args->GetNext(&dict)) {
+    args->ThrowTypeError("Must pass the resize options");
+    return v8::Local<v8::Promise>();
+  }
+  base::Optional<int> width;
+  base::Optional<int> height;
+  int value;
+  if (dict.Get("width", &value))
+    width = value;
+  if (dict.Get("height", &value))
+    height = value;
+  std::string quality;
+  dict.Get("quality", &quality);
+  AsyncOptions options = GetAsyncOptions(args->isolate(), &dict);
+
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // Resample every representation the image has, not only the 1x one.
+  gfx::ImageSkia image_skia = image_.AsImageSkia();
+  image_skia.EnsureRepsForSupportedScales();
+  options.queue->Post(
+      base::BindOnce(&ResizeImage, image_skia.image_reps(),
+                     GetResizeMethod(quality),
+                     electron::util::GetResizedSize(GetSize(), width, height)),
+      base::BindOnce(&ResolveWithImage, std::move(promise), false));
+  return handle;
+}
+
 v8::Local<v8::Value> NativeImage::GetBitmap(gin::Arguments* args) {
   float scale_factor = GetScaleFactorFromOptions(args);
 
@@ -261,34 +588,19 @@ float NativeImage::GetAspectRatio() {
 
 gin::Handle<NativeImage> NativeImage::Resize(v8::Isolate* isolate,
                                              base::DictionaryValue options) {
-  gfx::Size size = GetSize();
-  int width = size.width();
-  int height = size.height();
-  bool width_set = options.GetInteger("width", &width);
-  bool height_set = options.GetInteger("height", &height);
-  size.SetSize(width, height);
-
-  if (width_set && !height_set) {
-    // Scale height to preserve original aspect ratio
-    size.set_height(width);
-    size = gfx::ScaleToRoundedSize(size, 1.f, 1.f / GetAspectRatio());
-  } else if (height_set && !width_set) {
-    // Scale width to preserve original aspect ratio
-    size.set_width(height);
-    size = gfx::ScaleToRoundedSize(size, GetAspectRatio(), 1.f);
-  }
-
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+  base::Optional<int> width;
+  base::Optional<int> height;
+  int value;
+  if (options.GetInteger("width", &value))
+    width = value;
+  if (options.GetInteger("height", &value))
+    height = value;
   std::string quality;
   options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
 
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(quality),
+      electron::util::GetResizedSize(GetSize(), width, height));
   return gin::CreateHandle(isolate,
                            new NativeImage(isolate, gfx::Image(resized)));
 }
@@ -488,6 +800,160 @@ gin::Handle<NativeImage> NativeImage::CreateFromDataURL(v8::Isolate* isolate,
   return CreateEmpty(isolate);
 }
 
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromPathAsync(gin::Arguments* args) {
+  base::FilePath path;
+  if (!args->GetNext(&path)) {
+    args->ThrowTypeError("Must pass a path");
+    return v8::Local<v8::Promise>();
+  }
+  AsyncOptions options = GetAsyncOptions(args);
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  base::FilePath image_path = NormalizePath(path);
+#if defined(OS_WIN)
+  // Icons are loaded lazily for each size.
+  if (image_path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    promise.Resolve(CreateFromPath(args->isolate(), image_path).ToV8());
+    return handle;
+  }
+#endif
+  bool is_template = false;
+#if defined(OS_MACOSX)
+  is_template = IsTemplateFilename(image_path);
+#endif
+  options.queue->Post(
+      base::BindOnce(&DecodePath, image_path),
+      base::BindOnce(&ResolveWithImage, std::move(promise), is_template));
+  return handle;
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromBufferAsync(
+    gin::Arguments* args) {
+  v8::Local<v8::Value> buffer;
+  if (!args->GetNext(&buffer) || !node::Buffer::HasInstance(buffer)) {
+    args->ThrowTypeError("buffer must be a node Buffer");
+    return v8::Local<v8::Promise>();
+  }
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+  gin_helper::Dictionary dict;
+  bool has_options = args->GetNext(&dict);
+  if (has_options) {
+    dict.Get("width", &width);
+    dict.Get("height", &height);
+    dict.Get("scaleFactor", &scale_factor);
+  }
+  AsyncOptions options =
+      GetAsyncOptions(args->isolate(), has_options ? &dict : nullptr);
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // The buffer may change while it is decoded.
+  const auto* data =
+      reinterpret_cast<const unsigned char*>(node::Buffer::Data(buffer));
+  std::vector<unsigned char> copy(data, data + node::Buffer::Length(buffer));
+  options.queue->Post(
+      base::BindOnce(&DecodeBuffer, std::move(copy), width, height,
+                     scale_factor),
+      base::BindOnce(&ResolveWithImage, std::move(promise), false));
+  return handle;
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::ProcessBatch(gin::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  std::vector<v8::Local<v8::Value>> inputs;
+  if (!args->GetNext(&inputs)) {
+    args->ThrowTypeError("Must pass an array of images");
+    return v8::Local<v8::Promise>();
+  }
+
+  std::vector<gin_helper::Dictionary> operation_dicts;
+  if (!args->GetNext(&operation_dicts)) {
+    args->ThrowTypeError("Must pass an array of operations");
+    return v8::Local<v8::Promise>();
+  }
+  std::vector<ImagePipeline::Operation> operations;
+  for (const gin_helper::Dictionary& operation_dict : operation_dicts) {
+    ImagePipeline::Operation operation;
+    std::string error;
+    if (!GetPipelineOperation(operation_dict, &operation, &error)) {
+      args->ThrowTypeError(error);
+      return v8::Local<v8::Promise>();
+    }
+    operations.push_back(operation);
+  }
+
+  std::string format = "png";
+  int quality = 90;
+  gin_helper::Dictionary dict;
+  bool has_options = args->GetNext(&dict);
+  if (has_options) {
+    dict.Get("format", &format);
+    dict.Get("quality", &quality);
+  }
+  ImagePipeline::Format pipeline_format;
+  if (!ImagePipeline::GetFormat(format, &pipeline_format)) {
+    args->ThrowTypeError("Unknown format: " + format);
+    return v8::Local<v8::Promise>();
+  }
+  AsyncOptions options =
+      GetAsyncOptions(isolate, has_options ? &dict : nullptr);
+  auto pipeline = base::MakeRefCounted<ImagePipeline>(
+      std::move(operations), pipeline_format, quality);
+
+  // Check all the inputs before starting any of them.
+  using Task = base::OnceCallback<std::vector<unsigned char>()>;
+  std::vector<Task> tasks;
+  tasks.reserve(inputs.size());
+  for (v8::Local<v8::Value> input : inputs) {
+    base::FilePath path;
+    NativeImage* image = nullptr;
+    if (node::Buffer::HasInstance(input)) {
+      // The buffer may change while it is processed.
+      const auto* data =
+          reinterpret_cast<const unsigned char*>(node::Buffer::Data(input));
+      std::vector<unsigned char> copy(data, data + node::Buffer::Length(input));
+      tasks.push_back(base::BindOnce(&ImagePipeline::ProcessEncoded, pipeline,
+                                     std::move(copy)));
+    } else if (input->IsString() && gin::ConvertFromV8(isolate, input, &path)) {
+      tasks.push_back(base::BindOnce(&ImagePipeline::ProcessPath, pipeline,
+                                     NormalizePath(path)));
+    } else if (gin::ConvertFromV8(isolate, input, &image)) {
+      // Shares the pixels of the image.
+      const SkBitmap bitmap =
+          image->image().AsImageSkia().GetRepresentation(1.0f).GetBitmap();
+      tasks.push_back(
+          base::BindOnce(&ImagePipeline::ProcessBitmap, pipeline, bitmap));
+    } else {
+      args->ThrowTypeError("Images must be Buffers, paths or NativeImages");
+      return v8::Local<v8::Promise>();
+    }
+  }
+
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (tasks.empty()) {
+    promise.Resolve(v8::Array::New(isolate));
+    return handle;
+  }
+
+  // Each image is a single task, so the images of the batch are spread over
+  // the threads of the queue.
+  auto results =
+      base::MakeRefCounted<BatchResults>(std::move(promise), tasks.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    options.queue->Post(std::move(tasks[i]),
+                        base::BindOnce(&BatchResults::OnImageDone, results, i));
+  }
+  return handle;
+}
+
 #if !defined(OS_MACOSX)
 gin::Handle<NativeImage> NativeImage::CreateFromNamedImage(
     gin::Arguments* args,
@@ -502,11 +968,14 @@ void NativeImage::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(gin::StringToV8(isolate, "NativeImage"));
   gin_helper::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("toPNG", &NativeImage::ToPNG)
+      .SetMethod("toPNGAsync", &NativeImage::ToPNGAsync)
       .SetMethod("toJPEG", &NativeImage::ToJPEG)
+      .SetMethod("toJPEGAsync", &NativeImage::ToJPEGAsync)
       .SetMethod("toBitmap", &NativeImage::ToBitmap)
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getNativeHandle", &NativeImage::GetNativeHandle)
       .SetMethod("toDataURL", &NativeImage::ToDataURL)
+      .SetMethod("toDataURLAsync", &NativeImage::ToDataURLAsync)
       .SetMethod("isEmpty", &NativeImage::IsEmpty)
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("_setTemplateImage", &NativeImage::SetTemplateImage)
@@ -514,6 +983,7 @@ void NativeImage::BuildPrototype(v8::Isolate* isolate,
       .SetProperty("isMacTemplateImage", &NativeImage::IsTemplateImage,
                    &NativeImage::SetTemplateImage)
       .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("crop", &NativeImage::Crop)
       .SetMethod("getAspectRatio", &NativeImage::GetAspectRatio)
       .SetMethod("addRepresentation", &NativeImage::AddRepresentation);
@@ -556,8 +1026,18 @@ bool Converter<electron::api::NativeImage*>::FromV8(
 
 namespace {
 
+using electron::api::ImageTaskQueue;
 using electron::api::NativeImage;
 
+gin::Handle<ImageTaskQueue> CreateTaskQueue(gin_helper::ErrorThrower thrower,
+                                            int concurrency) {
+  if (concurrency < 1) {
+    thrower.ThrowError("concurrency must be at least 1");
+    return gin::Handle<ImageTaskQueue>();
+  }
+  return ImageTaskQueue::Create(thrower.isolate(), concurrency);
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -577,6 +1057,12 @@ void Initialize(v8::Local<v8::Object> exports,
   native_image.SetMethod("createFromDataURL", &NativeImage::CreateFromDataURL);
   native_image.SetMethod("createFromNamedImage",
                          &NativeImage::CreateFromNamedImage);
+  native_image.SetMethod("createFromPathAsync",
+                         &NativeImage::CreateFromPathAsync);
+  native_image.SetMethod("createFromBufferAsync",
+                         &NativeImage::CreateFromBufferAsync);
+  native_image.SetMethod("createTaskQueue", &CreateTaskQueue);
+  native_image.SetMethod("processBatch", &NativeImage::ProcessBatch);
 }
 
 }  // namespace
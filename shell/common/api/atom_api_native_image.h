@@ -63,6 +63,9 @@ class NativeImage : public mate::Wrappable<NativeImage> {
                                                     const GURL& url);
   static gin::Handle<NativeImage> CreateFromNamedImage(gin::Arguments* args,
                                                        const std::string& name);
+  static v8::Local<v8::Promise> CreateFromPathAsync(gin::Arguments* args);
+  static v8::Local<v8::Promise> CreateFromBufferAsync(gin::Arguments* args);
+  static v8::Local<v8::Promise> ProcessBatch(gin::Arguments* args);
 
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
@@ -90,6 +93,10 @@ class NativeImage : public mate::Wrappable<NativeImage> {
                                   base::DictionaryValue options);
   gin::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   std::string ToDataURL(gin::Arguments* args);
+  v8::Local<v8::Promise> ToPNGAsync(gin::Arguments* args);
+  v8::Local<v8::Promise> ToJPEGAsync(gin::Arguments* args);
+  v8::Local<v8::Promise> ToDataURLAsync(gin::Arguments* args);
+  v8::Local<v8::Promise> ResizeAsync(gin::Arguments* args);
   bool IsEmpty();
   gfx::Size GetSize();
   float GetAspectRatio();
@@ -24,8 +24,10 @@
 #include "shell/common/application_info.h"
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/error_thrower.h"
 #include "shell/common/gin_helper/locker.h"
 #include "shell/common/gin_helper/promise.h"
+#include "shell/common/heap_profiler.h"
 #include "shell/common/heap_snapshot.h"
 #include "shell/common/node_includes.h"
 #include "third_party/blink/renderer/platform/heap/process_heap.h"  // nogncheck
@@ -91,6 +93,8 @@ void ElectronBindings::BindTo(v8::Isolate* isolate,
   BindProcess(isolate, &dict, metrics_.get());
 
   dict.SetMethod("takeHeapSnapshot", &TakeHeapSnapshot);
+  dict.SetMethod("startSamplingHeapProfiler", &StartSamplingHeapProfiler);
+  dict.SetMethod("stopSamplingHeapProfiler", &StopSamplingHeapProfiler);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::IncreaseFdLimitTo);
 #endif
@@ -354,4 +358,28 @@ bool ElectronBindings::TakeHeapSnapshot(v8::Isolate* isolate,
   return electron::TakeHeapSnapshot(isolate, &file);
 }
 
+// static
+bool ElectronBindings::StartSamplingHeapProfiler(v8::Isolate* isolate,
+                                                 gin_helper::Arguments* args) {
+  int64_t sampling_interval = kDefaultHeapSamplingInterval;
+  int stack_depth = kDefaultHeapSamplingStackDepth;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("samplingInterval", &sampling_interval);
+    options.Get("stackDepth", &stack_depth);
+  }
+  if (sampling_interval <= 0 || stack_depth <= 0) {
+    gin_helper::ErrorThrower(isolate).ThrowTypeError(
+        "samplingInterval and stackDepth must be positive");
+    return false;
+  }
+  return electron::StartSamplingHeapProfiler(isolate, sampling_interval,
+                                             stack_depth);
+}
+
+// static
+std::string ElectronBindings::StopSamplingHeapProfiler(v8::Isolate* isolate) {
+  return electron::StopSamplingHeapProfiler(isolate);
+}
+
 }  // namespace electron
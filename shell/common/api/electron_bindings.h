@@ -7,6 +7,7 @@
 
 #include <list>
 #include <memory>
+#include <string>
 
 #include "base/files/file_path.h"
 #include "base/macros.h"
@@ -63,6 +64,9 @@ class ElectronBindings {
   static v8::Local<v8::Value> GetIOCounters(v8::Isolate* isolate);
   static bool TakeHeapSnapshot(v8::Isolate* isolate,
                                const base::FilePath& file_path);
+  static bool StartSamplingHeapProfiler(v8::Isolate* isolate,
+                                        gin_helper::Arguments* args);
+  static std::string StopSamplingHeapProfiler(v8::Isolate* isolate);
 
   void ActivateUVLoop(v8::Isolate* isolate);
 
@@ -0,0 +1,97 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/heap_profiler.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "gin/converter.h"
+#include "v8/include/v8-profiler.h"
+
+namespace {
+
+std::string ToString(v8::Isolate* isolate, v8::Local<v8::String> value) {
+  std::string result;
+  gin::ConvertFromV8(isolate, value, &result);
+  return result;
+}
+
+// Mirrors HeapProfiler.SamplingHeapProfileNode of the DevTools protocol.
+base::Value NodeToValue(v8::Isolate* isolate,
+                        const v8::AllocationProfile::Node* node) {
+  base::Value call_frame(base::Value::Type::DICTIONARY);
+  call_frame.SetKey("functionName",
+                    base::Value(ToString(isolate, node->name)));
+  call_frame.SetKey("scriptId",
+                    base::Value(std::to_string(node->script_id)));
+  call_frame.SetKey("url", base::Value(ToString(isolate, node->script_name)));
+  // V8 positions are 1-based while DevTools expects 0-based ones.
+  call_frame.SetKey("lineNumber", base::Value(node->line_number - 1));
+  call_frame.SetKey("columnNumber", base::Value(node->column_number - 1));
+
+  double self_size = 0;
+  for (const auto& allocation : node->allocations)
+    self_size += static_cast<double>(allocation.size) * allocation.count;
+
+  base::Value children(base::Value::Type::LIST);
+  for (const auto* child : node->children)
+    children.GetList().push_back(NodeToValue(isolate, child));
+
+  base::Value result(base::Value::Type::DICTIONARY);
+  result.SetKey("callFrame", std::move(call_frame));
+  result.SetKey("selfSize", base::Value(self_size));
+  result.SetKey("id", base::Value(static_cast<int>(node->node_id)));
+  result.SetKey("children", std::move(children));
+  return result;
+}
+
+}  // namespace
+
+namespace electron {
+
+bool StartSamplingHeapProfiler(v8::Isolate* isolate,
+                               uint64_t sampling_interval,
+                               int stack_depth) {
+  DCHECK(isolate);
+  return isolate->GetHeapProfiler()->StartSamplingHeapProfiler(
+      sampling_interval, stack_depth);
+}
+
+std::string StopSamplingHeapProfiler(v8::Isolate* isolate) {
+  DCHECK(isolate);
+  v8::HandleScope handle_scope(isolate);
+  auto* heap_profiler = isolate->GetHeapProfiler();
+  std::unique_ptr<v8::AllocationProfile> profile(
+      heap_profiler->GetAllocationProfile());
+  if (!profile)
+    return std::string();
+
+  base::Value samples(base::Value::Type::LIST);
+  for (const auto& sample : profile->GetSamples()) {
+    base::Value value(base::Value::Type::DICTIONARY);
+    value.SetKey("size", base::Value(static_cast<double>(sample.size *
+                                                         sample.count)));
+    value.SetKey("nodeId", base::Value(static_cast<int>(sample.node_id)));
+    value.SetKey("ordinal", base::Value(static_cast<double>(sample.sample_id)));
+    samples.GetList().push_back(std::move(value));
+  }
+
+  base::Value result(base::Value::Type::DICTIONARY);
+  result.SetKey("head", NodeToValue(isolate, profile->GetRootNode()));
+  result.SetKey("samples", std::move(samples));
+
+  // The profile references the profiler's data, so stop only after it has
+  // been converted.
+  profile.reset();
+  heap_profiler->StopSamplingHeapProfiler();
+
+  std::string json;
+  base::JSONWriter::Write(result, &json);
+  return json;
+}
+
+}  // namespace electron
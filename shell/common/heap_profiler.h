@@ -0,0 +1,31 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_HEAP_PROFILER_H_
+#define SHELL_COMMON_HEAP_PROFILER_H_
+
+#include <string>
+
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Average number of bytes between two samples, and maximum stack depth
+// recorded per sample, used when the caller does not specify them.
+constexpr uint64_t kDefaultHeapSamplingInterval = 512 * 1024;
+constexpr int kDefaultHeapSamplingStackDepth = 16;
+
+// Starts V8's sampling heap profiler. Returns false if it was already running.
+bool StartSamplingHeapProfiler(v8::Isolate* isolate,
+                               uint64_t sampling_interval,
+                               int stack_depth);
+
+// Stops the sampling heap profiler and returns the collected allocation
+// profile as JSON, in the format of the `.heapprofile` files used by DevTools.
+// Returns an empty string if the profiler was not running.
+std::string StopSamplingHeapProfiler(v8::Isolate* isolate);
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_HEAP_PROFILER_H_
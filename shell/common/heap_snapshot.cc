@@ -4,10 +4,46 @@
 
 #include "shell/common/heap_snapshot.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/system/wait.h"
+#include "third_party/zlib/zlib.h"
 #include "v8/include/v8-profiler.h"
 
 namespace {
 
+// Size of the chunks V8 hands us, and of the compression output buffer.
+constexpr int kChunkSize = 65536;
+
+// How much serialized data may wait for the background writer before the
+// isolate thread is made to wait. This bounds the memory used for snapshots
+// of very large heaps when the disk is slower than the serializer.
+constexpr size_t kMaxPendingBytes = 64 * 1024 * 1024;
+
+// The snapshot is abandoned when the writer makes no progress for this long,
+// e.g. because the reader of the data pipe stopped reading.
+constexpr base::TimeDelta kMaxWriterStall = base::TimeDelta::FromSeconds(30);
+
+// The use of the ForTesting flavor is a hack workaround to avoid having to
+// patch this as a friend into the guard class.
+class HeapSnapshotScopedAllowBaseSyncPrimitives
+    : public base::ScopedAllowBaseSyncPrimitivesForTesting {};
+
 class HeapSnapshotOutputStream : public v8::OutputStream {
  public:
   explicit HeapSnapshotOutputStream(base::File* file) : file_(file) {
@@ -17,7 +53,7 @@ class HeapSnapshotOutputStream : public v8::OutputStream {
   bool IsComplete() const { return is_complete_; }
 
   // v8::OutputStream
-  int GetChunkSize() override { return 65536; }
+  int GetChunkSize() override { return kChunkSize; }
   void EndOfStream() override { is_complete_ = true; }
 
   v8::OutputStream::WriteResult WriteAsciiChunk(char* data, int size) override {
@@ -30,6 +66,244 @@ class HeapSnapshotOutputStream : public v8::OutputStream {
   bool is_complete_ = false;
 };
 
+// Destination of the serialized snapshot. Sinks are created on the isolate
+// thread but only used on the background sequence.
+class HeapSnapshotSink {
+ public:
+  virtual ~HeapSnapshotSink() = default;
+
+  virtual bool Write(const char* data, size_t size) = 0;
+  virtual bool Finish() { return true; }
+};
+
+class FileSink : public HeapSnapshotSink {
+ public:
+  explicit FileSink(base::File file) : file_(std::move(file)) {}
+
+  bool Write(const char* data, size_t size) override {
+    return file_.WriteAtCurrentPos(data, size) == static_cast<int>(size);
+  }
+
+ private:
+  base::File file_;
+};
+
+class DataPipeSink : public HeapSnapshotSink {
+ public:
+  explicit DataPipeSink(mojo::ScopedDataPipeProducerHandle pipe)
+      : pipe_(std::move(pipe)) {}
+
+  bool Write(const char* data, size_t size) override {
+    while (size > 0) {
+      uint32_t num_bytes = static_cast<uint32_t>(
+          std::min<size_t>(size, std::numeric_limits<uint32_t>::max()));
+      MojoResult result =
+          pipe_->WriteData(data, &num_bytes, MOJO_WRITE_DATA_FLAG_NONE);
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        // We are on a sequence that may block, so just wait for the reader.
+        if (mojo::Wait(pipe_.get(), MOJO_HANDLE_SIGNAL_WRITABLE) !=
+            MOJO_RESULT_OK)
+          return false;
+        continue;
+      }
+      if (result != MOJO_RESULT_OK)
+        return false;
+      data += num_bytes;
+      size -= num_bytes;
+    }
+    return true;
+  }
+
+ private:
+  mojo::ScopedDataPipeProducerHandle pipe_;
+};
+
+// Gzip-compresses everything written to it before passing it on to |next|.
+class GzipSink : public HeapSnapshotSink {
+ public:
+  explicit GzipSink(std::unique_ptr<HeapSnapshotSink> next)
+      : next_(std::move(next)), buffer_(kChunkSize) {
+    memset(&stream_, 0, sizeof(stream_));
+    // Adding 16 to the window bits selects the gzip wrapper.
+    initialized_ = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+  }
+
+  ~GzipSink() override {
+    if (initialized_)
+      deflateEnd(&stream_);
+  }
+
+  bool Write(const char* data, size_t size) override {
+    return Deflate(data, size, Z_NO_FLUSH);
+  }
+
+  bool Finish() override {
+    return Deflate(nullptr, 0, Z_FINISH) && next_->Finish();
+  }
+
+ private:
+  bool Deflate(const char* data, size_t size, int flush) {
+    if (!initialized_)
+      return false;
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream_.avail_in = static_cast<uInt>(size);
+    int result = Z_OK;
+    do {
+      stream_.next_out = reinterpret_cast<Bytef*>(buffer_.data());
+      stream_.avail_out = static_cast<uInt>(buffer_.size());
+      result = deflate(&stream_, flush);
+      if (result == Z_STREAM_ERROR)
+        return false;
+      size_t produced = buffer_.size() - stream_.avail_out;
+      if (produced > 0 && !next_->Write(buffer_.data(), produced))
+        return false;
+    } while (stream_.avail_out == 0);
+    return flush != Z_FINISH || result == Z_STREAM_END;
+  }
+
+  std::unique_ptr<HeapSnapshotSink> next_;
+  std::vector<char> buffer_;
+  z_stream stream_;
+  bool initialized_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(GzipSink);
+};
+
+// Hands the chunks produced on the isolate thread to a sink living on a
+// background sequence.
+class BackgroundWriter : public base::RefCountedThreadSafe<BackgroundWriter> {
+ public:
+  explicit BackgroundWriter(std::unique_ptr<HeapSnapshotSink> sink)
+      : task_runner_(base::CreateSequencedTaskRunner(
+            {base::ThreadPool(), base::MayBlock(),
+             base::TaskPriority::USER_VISIBLE})),
+        sink_(std::move(sink)),
+        condition_(&lock_) {}
+
+  // Called on the isolate thread, returns false once writing has failed.
+  //
+  // The isolate thread blocks while more than |kMaxPendingBytes| are waiting
+  // for the writer. V8 serializes the snapshot synchronously, so this is the
+  // only way to apply backpressure. Every write ends or fails on its own,
+  // except for data pipe writes to a reader that stopped reading, so the
+  // stall is bounded by giving up after |kMaxWriterStall| without progress.
+  bool Append(std::string chunk) {
+    {
+      base::AutoLock auto_lock(lock_);
+      if (!failed_ && pending_bytes_ > kMaxPendingBytes)
+        WaitForWriter();
+      if (failed_)
+        return false;
+      pending_bytes_ += chunk.size();
+    }
+    task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&BackgroundWriter::WriteOnSequence, this,
+                                  std::move(chunk)));
+    return true;
+  }
+
+  // Flushes the sink after all pending chunks have been written and then runs
+  // |callback| on the calling sequence.
+  void Finish(bool serialized, electron::HeapSnapshotCallback callback) {
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE,
+        base::BindOnce(&BackgroundWriter::FinishOnSequence, this, serialized),
+        std::move(callback));
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<BackgroundWriter>;
+
+  ~BackgroundWriter() = default;
+
+  void WaitForWriter() {
+    lock_.AssertAcquired();
+    HeapSnapshotScopedAllowBaseSyncPrimitives allow_base_sync_primitives;
+    base::TimeTicks deadline = base::TimeTicks::Now() + kMaxWriterStall;
+    while (!failed_ && pending_bytes_ > kMaxPendingBytes) {
+      base::TimeDelta remaining = deadline - base::TimeTicks::Now();
+      if (remaining <= base::TimeDelta()) {
+        failed_ = true;
+        return;
+      }
+      size_t pending_bytes = pending_bytes_;
+      condition_.TimedWait(remaining);
+      if (pending_bytes_ < pending_bytes)
+        deadline = base::TimeTicks::Now() + kMaxWriterStall;
+    }
+  }
+
+  void WriteOnSequence(std::string chunk) {
+    bool success = sink_ && sink_->Write(chunk.data(), chunk.size());
+    base::AutoLock auto_lock(lock_);
+    pending_bytes_ -= chunk.size();
+    if (!success)
+      failed_ = true;
+    condition_.Signal();
+  }
+
+  bool FinishOnSequence(bool serialized) {
+    bool success = serialized && sink_ && sink_->Finish();
+    // Close the file or pipe right away instead of whenever the last
+    // reference to the writer goes away.
+    sink_.reset();
+    base::AutoLock auto_lock(lock_);
+    return success && !failed_;
+  }
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  std::unique_ptr<HeapSnapshotSink> sink_;
+
+  base::Lock lock_;
+  base::ConditionVariable condition_;
+  size_t pending_bytes_ = 0;  // Guarded by |lock_|.
+  bool failed_ = false;       // Guarded by |lock_|.
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundWriter);
+};
+
+class BackgroundOutputStream : public v8::OutputStream {
+ public:
+  explicit BackgroundOutputStream(scoped_refptr<BackgroundWriter> writer)
+      : writer_(std::move(writer)) {}
+
+  bool IsComplete() const { return is_complete_; }
+
+  // v8::OutputStream
+  int GetChunkSize() override { return kChunkSize; }
+  void EndOfStream() override { is_complete_ = true; }
+
+  v8::OutputStream::WriteResult WriteAsciiChunk(char* data, int size) override {
+    // V8 reuses |data| for the next chunk, so it has to be copied.
+    return writer_->Append(std::string(data, size)) ? kContinue : kAbort;
+  }
+
+ private:
+  scoped_refptr<BackgroundWriter> writer_;
+  bool is_complete_ = false;
+};
+
+void TakeHeapSnapshotWithSink(v8::Isolate* isolate,
+                              std::unique_ptr<HeapSnapshotSink> sink,
+                              electron::HeapSnapshotCompression compression,
+                              electron::HeapSnapshotCallback callback) {
+  if (compression == electron::HeapSnapshotCompression::kGzip)
+    sink = std::make_unique<GzipSink>(std::move(sink));
+  auto writer = base::MakeRefCounted<BackgroundWriter>(std::move(sink));
+
+  bool serialized = false;
+  auto* snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
+  if (snapshot) {
+    BackgroundOutputStream stream(writer);
+    snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+    const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+    serialized = stream.IsComplete();
+  }
+
+  writer->Finish(serialized, std::move(callback));
+}
+
 }  // namespace
 
 namespace electron {
@@ -53,4 +327,35 @@ bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file) {
   return stream.IsComplete();
 }
 
+void TakeHeapSnapshotInBackground(v8::Isolate* isolate,
+                                  base::File file,
+                                  HeapSnapshotCompression compression,
+                                  HeapSnapshotCallback callback) {
+  DCHECK(isolate);
+
+  if (!file.IsValid()) {
+    std::move(callback).Run(false);
+    return;
+  }
+
+  TakeHeapSnapshotWithSink(isolate, std::make_unique<FileSink>(std::move(file)),
+                           compression, std::move(callback));
+}
+
+void TakeHeapSnapshotInBackground(v8::Isolate* isolate,
+                                  mojo::ScopedDataPipeProducerHandle pipe,
+                                  HeapSnapshotCompression compression,
+                                  HeapSnapshotCallback callback) {
+  DCHECK(isolate);
+
+  if (!pipe.is_valid()) {
+    std::move(callback).Run(false);
+    return;
+  }
+
+  TakeHeapSnapshotWithSink(isolate,
+                           std::make_unique<DataPipeSink>(std::move(pipe)),
+                           compression, std::move(callback));
+}
+
 }  // namespace electron
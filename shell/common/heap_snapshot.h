@@ -5,13 +5,40 @@
 #ifndef SHELL_COMMON_HEAP_SNAPSHOT_H_
 #define SHELL_COMMON_HEAP_SNAPSHOT_H_
 
+#include "base/callback_forward.h"
 #include "base/files/file.h"
+#include "mojo/public/cpp/system/data_pipe.h"
 #include "v8/include/v8.h"
 
 namespace electron {
 
+enum class HeapSnapshotCompression {
+  kNone,
+  kGzip,
+};
+
+using HeapSnapshotCallback = base::OnceCallback<void(bool success)>;
+
 bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file);
 
+// Takes a heap snapshot and writes it to |file|.
+//
+// The snapshot is still serialized on the thread that owns |isolate|, but
+// compression and disk writes happen on a background sequence, so the isolate
+// thread only waits when the writer falls too far behind, and fails the
+// snapshot if the writer stalls. |callback| is run on the calling sequence
+// once all data has been flushed.
+void TakeHeapSnapshotInBackground(v8::Isolate* isolate,
+                                  base::File file,
+                                  HeapSnapshotCompression compression,
+                                  HeapSnapshotCallback callback);
+
+// Same as above, but streams the snapshot into a data pipe.
+void TakeHeapSnapshotInBackground(v8::Isolate* isolate,
+                                  mojo::ScopedDataPipeProducerHandle pipe,
+                                  HeapSnapshotCompression compression,
+                                  HeapSnapshotCallback callback);
+
 }  // namespace electron
 
 #endif  // SHELL_COMMON_HEAP_SNAPSHOT_H_
@@ -0,0 +1,262 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/image_pipeline.h"
+
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "shell/common/asar/asar_util.h"
+#include "shell/common/skia_util.h"
+#include "third_party/skia/include/core/SkPixelRef.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/encode/SkWebpEncoder.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/size.h"
+#include "ui/gfx/skia_util.h"
+
+namespace electron {
+
+namespace {
+
+// Upper bound of the memory kept by the free buffers of the pool.
+constexpr size_t kMaxPooledBytes = 64 * 1024 * 1024;
+
+// The buffers the resized images are written to, shared by all threads.
+class ScratchBufferPool {
+ public:
+  ScratchBufferPool() = default;
+
+  // Returns a buffer of at least |size| bytes, with its actual size in
+  // |capacity|, or null when out of memory.
+  std::unique_ptr<uint8_t[]> Take(size_t size, size_t* capacity) {
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = buffers_.lower_bound(size);
+      // Don't waste a buffer that is much larger than needed.
+      if (it != buffers_.end() && it->first / 2 <= size) {
+        *capacity = it->first;
+        std::unique_ptr<uint8_t[]> buffer = std::move(it->second);
+        pooled_bytes_ -= it->first;
+        buffers_.erase(it);
+        return buffer;
+      }
+    }
+    *capacity = size;
+    return std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[size]);
+  }
+
+  void Return(std::unique_ptr<uint8_t[]> buffer, size_t capacity) {
+    base::AutoLock auto_lock(lock_);
+    if (pooled_bytes_ + capacity > kMaxPooledBytes)
+      return;
+    pooled_bytes_ += capacity;
+    buffers_.emplace(capacity, std::move(buffer));
+  }
+
+ private:
+  base::Lock lock_;
+  std::multimap<size_t, std::unique_ptr<uint8_t[]>> buffers_;
+  size_t pooled_bytes_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ScratchBufferPool);
+};
+
+ScratchBufferPool* GetScratchBufferPool() {
+  static base::NoDestructor<ScratchBufferPool> pool;
+  return pool.get();
+}
+
+// Gives its buffer back to the pool once the bitmap is released.
+class PooledPixelRef : public SkPixelRef {
+ public:
+  PooledPixelRef(const SkImageInfo& info,
+                 size_t row_bytes,
+                 std::unique_ptr<uint8_t[]> buffer,
+                 size_t capacity)
+      : SkPixelRef(info.width(), info.height(), buffer.get(), row_bytes),
+        buffer_(std::move(buffer)),
+        capacity_(capacity) {}
+
+  ~PooledPixelRef() override {
+    GetScratchBufferPool()->Return(std::move(buffer_), capacity_);
+  }
+
+ private:
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledPixelRef);
+};
+
+class ScratchAllocator : public SkBitmap::Allocator {
+ public:
+  ScratchAllocator() = default;
+
+  bool allocPixelRef(SkBitmap* bitmap) override {
+    const SkImageInfo& info = bitmap->info();
+    size_t row_bytes = info.minRowBytes();
+    size_t size = info.computeByteSize(row_bytes);
+    if (SkImageInfo::ByteSizeOverflowed(size))
+      return false;
+
+    size_t capacity;
+    std::unique_ptr<uint8_t[]> buffer =
+        GetScratchBufferPool()->Take(size, &capacity);
+    if (!buffer)
+      return false;
+    bitmap->setPixelRef(sk_make_sp<PooledPixelRef>(info, row_bytes,
+                                                   std::move(buffer), capacity),
+                        0, 0);
+    return true;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScratchAllocator);
+};
+
+bool Decode(const unsigned char* data, size_t size, SkBitmap* bitmap) {
+  if (gfx::PNGCodec::Decode(data, size, bitmap))
+    return true;
+
+  std::unique_ptr<SkBitmap> jpeg = gfx::JPEGCodec::Decode(data, size);
+  if (!jpeg)
+    return false;
+  // See AddImageSkiaRepFromJPEG.
+  jpeg->setAlphaType(SkAlphaType::kOpaque_SkAlphaType);
+  *bitmap = *jpeg;
+  return true;
+}
+
+}  // namespace
+
+ImagePipeline::Operation::Operation() = default;
+ImagePipeline::Operation::Operation(const Operation&) = default;
+ImagePipeline::Operation::~Operation() = default;
+
+// static
+bool ImagePipeline::GetFormat(const std::string& name, Format* format) {
+  if (name == "png")
+    *format = Format::kPNG;
+  else if (name == "jpeg")
+    *format = Format::kJPEG;
+  else if (name == "webp")
+    *format = Format::kWebP;
+  else
+    return false;
+  return true;
+}
+
+ImagePipeline::ImagePipeline(std::vector<Operation> operations,
+                             Format format,
+                             int quality)
+    : operations_(std::move(operations)), format_(format), quality_(quality) {}
+
+ImagePipeline::~ImagePipeline() = default;
+
+std::vector<unsigned char> ImagePipeline::ProcessEncoded(
+    const std::vector<unsigned char>& data) const {
+  SkBitmap bitmap;
+  if (!Decode(data.data(), data.size(), &bitmap))
+    return std::vector<unsigned char>();
+  return ProcessBitmap(bitmap);
+}
+
+std::vector<unsigned char> ImagePipeline::ProcessPath(
+    const base::FilePath& path) const {
+  std::string contents;
+  if (!asar::ReadFileToString(path, &contents))
+    return std::vector<unsigned char>();
+  SkBitmap bitmap;
+  if (!Decode(reinterpret_cast<const unsigned char*>(contents.data()),
+              contents.size(), &bitmap))
+    return std::vector<unsigned char>();
+  // Free the file before encoding.
+  contents.clear();
+  contents.shrink_to_fit();
+  return ProcessBitmap(bitmap);
+}
+
+std::vector<unsigned char> ImagePipeline::ProcessBitmap(
+    const SkBitmap& bitmap) const {
+  SkBitmap result = bitmap;
+  if (!Apply(&result))
+    return std::vector<unsigned char>();
+  return Encode(result);
+}
+
+bool ImagePipeline::Apply(SkBitmap* bitmap) const {
+  ScratchAllocator allocator;
+  for (const Operation& operation : operations_) {
+    switch (operation.type) {
+      case Operation::Type::kCrop: {
+        // The subset shares the pixels of |bitmap|.
+        SkBitmap cropped;
+        if (!bitmap->extractSubset(&cropped,
+                                   gfx::RectToSkIRect(operation.rect)))
+          return false;
+        *bitmap = cropped;
+        break;
+      }
+      case Operation::Type::kResize: {
+        gfx::Size size = util::GetResizedSize(
+            gfx::Size(bitmap->width(), bitmap->height()), operation.width,
+            operation.height);
+        if (size.IsEmpty())
+          return false;
+        if (size.width() == bitmap->width() &&
+            size.height() == bitmap->height())
+          break;
+        // Reads the cropped pixels in place, with the vectorized convolution
+        // filters of Skia.
+        *bitmap = skia::ImageOperations::Resize(*bitmap, operation.method,
+                                                size.width(), size.height(),
+                                                &allocator);
+        if (bitmap->isNull())
+          return false;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<unsigned char> ImagePipeline::Encode(const SkBitmap& bitmap) const {
+  std::vector<unsigned char> encoded;
+  switch (format_) {
+    case Format::kPNG:
+      if (!gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded))
+        encoded.clear();
+      break;
+    case Format::kJPEG:
+      if (!gfx::JPEGCodec::Encode(bitmap, quality_, &encoded))
+        encoded.clear();
+      break;
+    case Format::kWebP: {
+      SkPixmap pixmap;
+      if (!bitmap.peekPixels(&pixmap))
+        break;
+      SkWebpEncoder::Options options;
+      options.fCompression = SkWebpEncoder::Compression::kLossy;
+      options.fQuality = quality_;
+      SkDynamicMemoryWStream stream;
+      if (!SkWebpEncoder::Encode(&stream, pixmap, options))
+        break;
+      encoded.resize(stream.bytesWritten());
+      stream.copyTo(encoded.data());
+      break;
+    }
+  }
+  return encoded;
+}
+
+}  // namespace electron
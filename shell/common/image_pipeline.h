@@ -0,0 +1,84 @@
+// Copyright (c) 2019 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_IMAGE_PIPELINE_H_
+#define SHELL_COMMON_IMAGE_PIPELINE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/optional.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/rect.h"
+
+namespace electron {
+
+// Runs a list of operations on images in a single pass, from the encoded
+// input to the encoded output.
+//
+// Crops only select a subset of the pixels, and resizes are written to
+// buffers reused between images, so no intermediate image is allocated when
+// processing a batch of images of similar sizes.
+class ImagePipeline : public base::RefCountedThreadSafe<ImagePipeline> {
+ public:
+  struct Operation {
+    enum class Type {
+      kCrop,
+      kResize,
+    };
+
+    Operation();
+    Operation(const Operation&);
+    ~Operation();
+
+    Type type = Type::kCrop;
+    // For kCrop, in pixels.
+    gfx::Rect rect;
+    // For kResize, the missing one is scaled to preserve the aspect ratio.
+    base::Optional<int> width;
+    base::Optional<int> height;
+    skia::ImageOperations::ResizeMethod method =
+        skia::ImageOperations::RESIZE_BEST;
+  };
+
+  enum class Format {
+    kPNG,
+    kJPEG,
+    kWebP,
+  };
+
+  // Parses "png", "jpeg" or "webp".
+  static bool GetFormat(const std::string& name, Format* format);
+
+  ImagePipeline(std::vector<Operation> operations, Format format, int quality);
+
+  // These can run on any thread, and return an empty vector when the image
+  // could not be decoded or the operations did not apply to it.
+  std::vector<unsigned char> ProcessEncoded(
+      const std::vector<unsigned char>& data) const;
+  std::vector<unsigned char> ProcessPath(const base::FilePath& path) const;
+  std::vector<unsigned char> ProcessBitmap(const SkBitmap& bitmap) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ImagePipeline>;
+
+  ~ImagePipeline();
+
+  bool Apply(SkBitmap* bitmap) const;
+  std::vector<unsigned char> Encode(const SkBitmap& bitmap) const;
+
+  const std::vector<Operation> operations_;
+  const Format format_;
+  const int quality_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImagePipeline);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_IMAGE_PIPELINE_H_
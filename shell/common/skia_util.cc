@@ -150,6 +150,27 @@ bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
         image, path.InsertBeforeExtensionASCII(pair.name), pair.scale);
   return succeed;
 }
+
+gfx::Size GetResizedSize(const gfx::Size& size,
+                         base::Optional<int> width,
+                         base::Optional<int> height) {
+  float aspect_ratio =
+      size.IsEmpty() ? 1.f
+                     : static_cast<float>(size.width()) / size.height();
+  gfx::Size resized(width.value_or(size.width()),
+                    height.value_or(size.height()));
+  if (width && !height) {
+    // Scale height to preserve original aspect ratio
+    resized.set_height(*width);
+    resized = gfx::ScaleToRoundedSize(resized, 1.f, 1.f / aspect_ratio);
+  } else if (height && !width) {
+    // Scale width to preserve original aspect ratio
+    resized.set_width(*height);
+    resized = gfx::ScaleToRoundedSize(resized, aspect_ratio, 1.f);
+  }
+  return resized;
+}
+
 #if defined(OS_WIN)
 bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
   // Convert the icon from the Windows specific HICON to gfx::ImageSkia.
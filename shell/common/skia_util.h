@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "base/optional.h"
+#include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
 
 namespace electron {
@@ -33,6 +35,12 @@ bool AddImageSkiaRepFromPNG(gfx::ImageSkia* image,
                             size_t size,
                             double scale_factor);
 
+// Returns |size| resized to |width| and |height|, the missing one is scaled
+// to preserve the aspect ratio.
+gfx::Size GetResizedSize(const gfx::Size& size,
+                         base::Optional<int> width,
+                         base::Optional<int> height);
+
 #if defined(OS_WIN)
 bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon);
 #endif
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "base/task/post_task.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
 #include "gin/dictionary.h"
@@ -78,6 +79,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer> {
     if (!gin::ConvertFromV8(isolate, arguments, &message)) {
       return;
     }
+    TRACE_EVENT2("electron", "IPCRenderer::Send", "channel", channel, "bytes",
+                 message.encoded_message.size());
     electron_browser_ptr_->get()->Message(internal, channel,
                                           std::move(message));
   }
@@ -90,6 +93,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer> {
     if (!gin::ConvertFromV8(isolate, arguments, &message)) {
       return v8::Local<v8::Promise>();
     }
+    TRACE_EVENT2("electron", "IPCRenderer::Invoke", "channel", channel, "bytes",
+                 message.encoded_message.size());
     gin_helper::Promise<blink::CloneableMessage> p(isolate);
     auto handle = p.GetHandle();
 
@@ -113,6 +118,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer> {
     if (!gin::ConvertFromV8(isolate, arguments, &message)) {
       return;
     }
+    TRACE_EVENT2("electron", "IPCRenderer::SendTo", "channel", channel, "bytes",
+                 message.encoded_message.size());
     electron_browser_ptr_->get()->MessageTo(
         internal, send_to_all, web_contents_id, channel, std::move(message));
   }
@@ -124,6 +131,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer> {
     if (!gin::ConvertFromV8(isolate, arguments, &message)) {
       return;
     }
+    TRACE_EVENT2("electron", "IPCRenderer::SendToHost", "channel", channel,
+                 "bytes", message.encoded_message.size());
     electron_browser_ptr_->get()->MessageHost(channel, std::move(message));
   }
 
@@ -135,6 +144,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer> {
     if (!gin::ConvertFromV8(isolate, arguments, &message)) {
       return blink::CloneableMessage();
     }
+    TRACE_EVENT2("electron", "IPCRenderer::SendSync", "channel", channel,
+                 "bytes", message.encoded_message.size());
     // We aren't using a true synchronous mojo call here. We're calling an
     // asynchronous method and blocking on the result. The reason we're doing
     // this is a little complicated, so buckle up.
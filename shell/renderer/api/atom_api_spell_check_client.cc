@@ -4,22 +4,21 @@
 
 #include "shell/renderer/api/atom_api_spell_check_client.h"
 
-#include <map>
+#include <algorithm>
 #include <memory>
-
-#include <set>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "components/spellcheck/renderer/spellcheck_worditerator.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/function_template.h"
 #include "third_party/blink/public/web/web_text_checking_completion.h"
-#include "third_party/blink/public/web/web_text_checking_result.h"
 #include "third_party/icu/source/common/unicode/uscript.h"
 
 namespace electron {
@@ -28,6 +27,12 @@ namespace api {
 
 namespace {
 
+// The number of words whose spelling is cached.
+const size_t kMisspelledCacheSize = 16 * 1024;
+
+// The number of paragraphs whose words are cached.
+const size_t kParagraphCacheSize = 256;
+
 bool HasWordCharacters(const base::string16& text, int index) {
   const base::char16* data = text.data();
   int length = text.length();
@@ -41,46 +46,166 @@ bool HasWordCharacters(const base::string16& text, int index) {
   return false;
 }
 
-struct Word {
-  blink::WebTextCheckingResult result;
-  base::string16 text;
-  std::vector<base::string16> contraction_words;
-};
-
 }  // namespace
 
+SpellCheckClient::Word::Word() = default;
+SpellCheckClient::Word::Word(const Word&) = default;
+SpellCheckClient::Word::Word(Word&&) = default;
+SpellCheckClient::Word& SpellCheckClient::Word::operator=(const Word&) =
+    default;
+SpellCheckClient::Word& SpellCheckClient::Word::operator=(Word&&) = default;
+SpellCheckClient::Word::~Word() = default;
+
 class SpellCheckClient::SpellcheckRequest {
  public:
   SpellcheckRequest(
+      int id,
       const base::string16& text,
       std::unique_ptr<blink::WebTextCheckingCompletion> completion)
-      : text_(text), completion_(std::move(completion)) {}
+      : id_(id), text_(text), completion_(std::move(completion)) {}
   ~SpellcheckRequest() = default;
 
+  int id() const { return id_; }
   const base::string16& text() const { return text_; }
   blink::WebTextCheckingCompletion* completion() { return completion_.get(); }
-  std::vector<Word>& wordlist() { return word_list_; }
+  std::vector<size_t>& paragraph_offsets() { return paragraph_offsets_; }
+  std::vector<Paragraph>& paragraphs() { return paragraphs_; }
 
  private:
-  base::string16 text_;          // Text to be checked in this task.
-  std::vector<Word> word_list_;  // List of Words found in text
+  int id_;
+  base::string16 text_;  // Text to be checked in this task.
+  // The paragraphs of |text_|, and where they start in it.
+  std::vector<size_t> paragraph_offsets_;
+  std::vector<Paragraph> paragraphs_;
   // The interface to send the misspelled ranges to WebKit.
   std::unique_ptr<blink::WebTextCheckingCompletion> completion_;
 
   DISALLOW_COPY_AND_ASSIGN(SpellcheckRequest);
 };
 
+// Splits paragraphs into words, off the main thread.
+class SpellCheckClient::Tokenizer {
+ public:
+  explicit Tokenizer(const std::string& language) {
+    character_attributes_.SetDefaultLanguage(language);
+  }
+
+  std::vector<TokenizedParagraph> Tokenize(
+      std::vector<base::string16> texts) {
+    std::vector<TokenizedParagraph> paragraphs(texts.size());
+    bool initialized = Initialize();
+    for (size_t i = 0; i < texts.size(); ++i) {
+      // The paragraphs are spelled correctly if the iterators failed.
+      if (initialized)
+        paragraphs[i].words = TokenizeParagraph(texts[i]);
+      paragraphs[i].text = std::move(texts[i]);
+    }
+    return paragraphs;
+  }
+
+ private:
+  bool Initialize() {
+    if (!text_iterator_.IsInitialized() &&
+        !text_iterator_.Initialize(&character_attributes_, true)) {
+      VLOG(1) << "Failed to initialize SpellcheckWordIterator";
+      return false;
+    }
+
+    if (!contraction_iterator_.IsInitialized() &&
+        !contraction_iterator_.Initialize(&character_attributes_, false)) {
+      VLOG(1) << "Failed to initialize contraction_iterator_";
+      return false;
+    }
+    return true;
+  }
+
+  Paragraph TokenizeParagraph(const base::string16& text) {
+    Paragraph paragraph;
+    text_iterator_.SetText(text.c_str(), text.size());
+
+    base::string16 word;
+    size_t word_start;
+    size_t word_length;
+    for (;;) {  // Run until end of text
+      const auto status =
+          text_iterator_.GetNextWord(&word, &word_start, &word_length);
+      if (status == SpellcheckWordIterator::IS_END_OF_TEXT)
+        break;
+      if (status == SpellcheckWordIterator::IS_SKIPPABLE)
+        continue;
+
+      Word word_entry;
+      word_entry.result.location = base::checked_cast<int>(word_start);
+      word_entry.result.length = base::checked_cast<int>(word_length);
+      word_entry.text = word;
+      // If the given word is a concatenated word of two or more valid words
+      // (e.g. "hello:hello"), we should treat it as a valid word.
+      if (!IsContraction(word, &word_entry.contraction_words))
+        word_entry.contraction_words.clear();
+      paragraph.push_back(std::move(word_entry));
+    }
+    return paragraph;
+  }
+
+  // Returns whether or not the given string is a contraction.
+  // This function is a fall-back when the SpellcheckWordIterator class
+  // returns a concatenated word which is not in the selected dictionary
+  // (e.g. "in'n'out") but each word is valid.
+  // Output variable contraction_words will contain individual
+  // words in the contraction.
+  bool IsContraction(const base::string16& contraction,
+                     std::vector<base::string16>* contraction_words) {
+    DCHECK(contraction_iterator_.IsInitialized());
+
+    contraction_iterator_.SetText(contraction.c_str(), contraction.length());
+
+    base::string16 word;
+    size_t word_start;
+    size_t word_length;
+    for (auto status = contraction_iterator_.GetNextWord(&word, &word_start,
+                                                         &word_length);
+         status != SpellcheckWordIterator::IS_END_OF_TEXT;
+         status = contraction_iterator_.GetNextWord(&word, &word_start,
+                                                    &word_length)) {
+      if (status == SpellcheckWordIterator::IS_SKIPPABLE)
+        continue;
+
+      contraction_words->push_back(word);
+    }
+    return contraction_words->size() > 1;
+  }
+
+  // Represents character attributes used for filtering out characters which
+  // are not supported by this SpellCheck object.
+  SpellcheckCharAttribute character_attributes_;
+
+  // Represents word iterators used in this spellchecker. The |text_iterator_|
+  // splits text provided by WebKit into words, contractions, or concatenated
+  // words. The |contraction_iterator_| splits a concatenated word extracted by
+  // |text_iterator_| into word components so we can treat a concatenated word
+  // consisting only of correct words as a correct word.
+  SpellcheckWordIterator text_iterator_;
+  SpellcheckWordIterator contraction_iterator_;
+
+  DISALLOW_COPY_AND_ASSIGN(Tokenizer);
+};
+
 SpellCheckClient::SpellCheckClient(const std::string& language,
                                    v8::Isolate* isolate,
                                    v8::Local<v8::Object> provider)
-    : pending_request_param_(nullptr),
+    : misspelled_cache_(kMisspelledCacheSize),
+      paragraph_cache_(kParagraphCacheSize),
+      tokenizer_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      tokenizer_(new Tokenizer(language),
+                 base::OnTaskRunnerDeleter(tokenizer_task_runner_)),
+      pending_request_param_(nullptr),
       isolate_(isolate),
       context_(isolate, isolate->GetCurrentContext()),
       provider_(isolate, provider) {
   DCHECK(!context_.IsEmpty());
 
-  character_attributes_.SetDefaultLanguage(language);
-
   // Persistent the method.
   v8::Local<v8::Function> spell_check;
   gin_helper::Dictionary(isolate, provider).Get("spellCheck", &spell_check);
@@ -106,8 +231,8 @@ void SpellCheckClient::RequestCheckingOfText(
     pending_request_param_->completion()->DidCancelCheckingText();
   }
 
-  pending_request_param_ =
-      std::make_unique<SpellcheckRequest>(text, std::move(completionCallback));
+  pending_request_param_ = std::make_unique<SpellcheckRequest>(
+      ++next_request_id_, text, std::move(completionCallback));
 
   base::ThreadTaskRunnerHandle::Get()->PostTask(
       FROM_HERE,
@@ -128,6 +253,8 @@ void SpellCheckClient::UpdateSpellingUIWithMisspelledWord(
     const blink::WebString& word) {}
 
 void SpellCheckClient::SpellCheckText() {
+  if (!pending_request_param_)
+    return;
   const auto& text = pending_request_param_->text();
   if (text.empty() || spell_check_.IsEmpty()) {
     pending_request_param_->completion()->DidCancelCheckingText();
@@ -135,73 +262,117 @@ void SpellCheckClient::SpellCheckText() {
     return;
   }
 
-  if (!text_iterator_.IsInitialized() &&
-      !text_iterator_.Initialize(&character_attributes_, true)) {
-    // We failed to initialize text_iterator_, return as spelled correctly.
-    VLOG(1) << "Failed to initialize SpellcheckWordIterator";
-    return;
+  // Typing only changes one paragraph, the others are found in the cache.
+  auto& offsets = pending_request_param_->paragraph_offsets();
+  auto& paragraphs = pending_request_param_->paragraphs();
+  std::vector<base::string16> uncached;
+  std::vector<size_t> uncached_indices;
+  size_t start = 0;
+  while (start <= text.size()) {
+    size_t end = std::min(text.find('\n', start), text.size());
+    base::string16 paragraph = text.substr(start, end - start);
+    offsets.push_back(start);
+    paragraphs.emplace_back();
+    auto it = paragraph_cache_.Get(paragraph);
+    if (it != paragraph_cache_.end()) {
+      paragraphs.back() = it->second;
+    } else if (HasWordCharacters(paragraph, 0)) {
+      uncached_indices.push_back(paragraphs.size() - 1);
+      uncached.push_back(std::move(paragraph));
+    }
+    start = end + 1;
   }
 
-  if (!contraction_iterator_.IsInitialized() &&
-      !contraction_iterator_.Initialize(&character_attributes_, false)) {
-    // We failed to initialize the word iterator, return as spelled correctly.
-    VLOG(1) << "Failed to initialize contraction_iterator_";
+  if (uncached.empty()) {
+    CheckUncachedWords();
     return;
   }
+  base::PostTaskAndReplyWithResult(
+      tokenizer_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&Tokenizer::Tokenize, base::Unretained(tokenizer_.get()),
+                     std::move(uncached)),
+      base::BindOnce(&SpellCheckClient::OnParagraphsTokenized, AsWeakPtr(),
+                     pending_request_param_->id(),
+                     std::move(uncached_indices)));
+}
 
-  text_iterator_.SetText(text.c_str(), text.size());
+void SpellCheckClient::OnParagraphsTokenized(
+    int request_id,
+    std::vector<size_t> indices,
+    std::vector<TokenizedParagraph> paragraphs) {
+  // The paragraphs of a cancelled request are cached all the same, the next
+  // request is likely to contain most of them.
+  bool pending = pending_request_param_ &&
+                 pending_request_param_->id() == request_id;
+  for (size_t i = 0; i < paragraphs.size(); ++i) {
+    if (pending)
+      pending_request_param_->paragraphs()[indices[i]] = paragraphs[i].words;
+    paragraph_cache_.Put(std::move(paragraphs[i].text),
+                         std::move(paragraphs[i].words));
+  }
+  if (pending)
+    CheckUncachedWords();
+}
 
-  SpellCheckScope scope(*this);
-  base::string16 word;
-  size_t word_start;
-  size_t word_length;
+void SpellCheckClient::CheckUncachedWords() {
   std::set<base::string16> words;
-  auto& word_list = pending_request_param_->wordlist();
-  Word word_entry;
-  for (;;) {  // Run until end of text
-    const auto status =
-        text_iterator_.GetNextWord(&word, &word_start, &word_length);
-    if (status == SpellcheckWordIterator::IS_END_OF_TEXT)
-      break;
-    if (status == SpellcheckWordIterator::IS_SKIPPABLE)
-      continue;
-
-    word_entry.result.location = base::checked_cast<int>(word_start);
-    word_entry.result.length = base::checked_cast<int>(word_length);
-    word_entry.text = word;
-    word_entry.contraction_words.clear();
-
-    word_list.push_back(word_entry);
-    words.insert(word);
-    // If the given word is a concatenated word of two or more valid words
-    // (e.g. "hello:hello"), we should treat it as a valid word.
-    if (IsContraction(scope, word, &word_entry.contraction_words)) {
-      for (const auto& w : word_entry.contraction_words) {
-        words.insert(w);
-      }
+  auto add_if_uncached = [&](const base::string16& word) {
+    if (misspelled_cache_.Get(word) == misspelled_cache_.end())
+      words.insert(word);
+  };
+  for (const auto& paragraph : pending_request_param_->paragraphs()) {
+    for (const auto& word : paragraph) {
+      add_if_uncached(word.text);
+      for (const auto& contraction_word : word.contraction_words)
+        add_if_uncached(contraction_word);
     }
   }
 
-  // Send out all the words data to the spellchecker to check
-  SpellCheckWords(scope, words);
+  if (words.empty()) {
+    FinishRequest();
+    return;
+  }
+
+  // Send out the words that are not cached to the spellchecker to check
+  SpellCheckScope scope(*this);
+  SpellCheckWords(scope, words, pending_request_param_->id());
 }
 
 void SpellCheckClient::OnSpellCheckDone(
+    const std::set<base::string16>& words,
+    int request_id,
     const std::vector<base::string16>& misspelled_words) {
-  std::vector<blink::WebTextCheckingResult> results;
   std::unordered_set<base::string16> misspelled(misspelled_words.begin(),
                                                 misspelled_words.end());
+  // The words that were not reported are spelled correctly.
+  for (const auto& word : words)
+    misspelled_cache_.Put(word, misspelled.find(word) != misspelled.end());
+
+  if (pending_request_param_ && pending_request_param_->id() == request_id)
+    FinishRequest();
+}
 
-  auto& word_list = pending_request_param_->wordlist();
+bool SpellCheckClient::IsMisspelled(const base::string16& word) {
+  // A word can only be missing if more words than the cache holds were
+  // checked at once, it is then treated as spelled correctly.
+  auto it = misspelled_cache_.Peek(word);
+  return it != misspelled_cache_.end() && it->second;
+}
 
-  for (const auto& word : word_list) {
-    if (misspelled.find(word.text) != misspelled.end()) {
+void SpellCheckClient::FinishRequest() {
+  std::vector<blink::WebTextCheckingResult> results;
+  const auto& offsets = pending_request_param_->paragraph_offsets();
+  const auto& paragraphs = pending_request_param_->paragraphs();
+  for (size_t i = 0; i < paragraphs.size(); ++i) {
+    for (const auto& word : paragraphs[i]) {
+      if (!IsMisspelled(word.text))
+        continue;
       // If this is a contraction, iterate through parts and accept the word
       // if none of them are misspelled
       if (!word.contraction_words.empty()) {
         auto all_correct = true;
         for (const auto& contraction_word : word.contraction_words) {
-          if (misspelled.find(contraction_word) != misspelled.end()) {
+          if (IsMisspelled(contraction_word)) {
             all_correct = false;
             break;
           }
@@ -209,7 +380,9 @@ void SpellCheckClient::OnSpellCheckDone(
         if (all_correct)
           continue;
       }
-      results.push_back(word.result);
+      blink::WebTextCheckingResult result = word.result;
+      result.location += base::checked_cast<int>(offsets[i]);
+      results.push_back(result);
     }
   }
   pending_request_param_->completion()->DidFinishCheckingText(results);
@@ -217,12 +390,13 @@ void SpellCheckClient::OnSpellCheckDone(
 }
 
 void SpellCheckClient::SpellCheckWords(const SpellCheckScope& scope,
-                                       const std::set<base::string16>& words) {
+                                       const std::set<base::string16>& words,
+                                       int request_id) {
   DCHECK(!scope.spell_check_.IsEmpty());
 
   v8::Local<v8::FunctionTemplate> templ = gin_helper::CreateFunctionTemplate(
-      isolate_,
-      base::BindRepeating(&SpellCheckClient::OnSpellCheckDone, AsWeakPtr()));
+      isolate_, base::BindRepeating(&SpellCheckClient::OnSpellCheckDone,
+                                    AsWeakPtr(), words, request_id));
 
   auto context = isolate_->GetCurrentContext();
   v8::Local<v8::Value> args[] = {gin::ConvertToV8(isolate_, words),
@@ -231,36 +405,6 @@ void SpellCheckClient::SpellCheckWords(const SpellCheckScope& scope,
   scope.spell_check_->Call(context, scope.provider_, 2, args).IsEmpty();
 }
 
-// Returns whether or not the given string is a contraction.
-// This function is a fall-back when the SpellcheckWordIterator class
-// returns a concatenated word which is not in the selected dictionary
-// (e.g. "in'n'out") but each word is valid.
-// Output variable contraction_words will contain individual
-// words in the contraction.
-bool SpellCheckClient::IsContraction(
-    const SpellCheckScope& scope,
-    const base::string16& contraction,
-    std::vector<base::string16>* contraction_words) {
-  DCHECK(contraction_iterator_.IsInitialized());
-
-  contraction_iterator_.SetText(contraction.c_str(), contraction.length());
-
-  base::string16 word;
-  size_t word_start;
-  size_t word_length;
-  for (auto status =
-           contraction_iterator_.GetNextWord(&word, &word_start, &word_length);
-       status != SpellcheckWordIterator::IS_END_OF_TEXT;
-       status = contraction_iterator_.GetNextWord(&word, &word_start,
-                                                  &word_length)) {
-    if (status == SpellcheckWordIterator::IS_SKIPPABLE)
-      continue;
-
-    contraction_words->push_back(word);
-  }
-  return contraction_words->size() > 1;
-}
-
 SpellCheckClient::SpellCheckScope::SpellCheckScope(
     const SpellCheckClient& client)
     : handle_scope_(client.isolate_),
@@ -11,15 +11,18 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
-#include "components/spellcheck/renderer/spellcheck_worditerator.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string16.h"
 #include "third_party/blink/public/platform/web_spell_check_panel_host_client.h"
 #include "third_party/blink/public/platform/web_vector.h"
 #include "third_party/blink/public/web/web_text_check_client.h"
+#include "third_party/blink/public/web/web_text_checking_result.h"
 #include "v8/include/v8.h"
 
 namespace blink {
-struct WebTextCheckingResult;
 class WebTextCheckingCompletion;
 }  // namespace blink
 
@@ -27,6 +30,13 @@ namespace electron {
 
 namespace api {
 
+// Checks the spelling of the text of a frame with a spell check provider
+// written in JavaScript.
+//
+// The text is split into paragraphs, which are tokenized on a worker sequence
+// and cached, so only the paragraphs that changed are tokenized again. The
+// spelling of every word is cached too, and the provider is only called with
+// the words that are not, in one batch per request.
 class SpellCheckClient : public blink::WebSpellCheckPanelHostClient,
                          public blink::WebTextCheckClient,
                          public base::SupportsWeakPtr<SpellCheckClient> {
@@ -38,6 +48,29 @@ class SpellCheckClient : public blink::WebSpellCheckPanelHostClient,
 
  private:
   class SpellcheckRequest;
+  class Tokenizer;
+
+  struct Word {
+    Word();
+    Word(const Word&);
+    Word(Word&&);
+    Word& operator=(const Word&);
+    Word& operator=(Word&&);
+    ~Word();
+
+    // The range of the word in its paragraph.
+    blink::WebTextCheckingResult result;
+    base::string16 text;
+    // The words a contraction is made of, empty if it is not one.
+    std::vector<base::string16> contraction_words;
+  };
+  using Paragraph = std::vector<Word>;
+
+  struct TokenizedParagraph {
+    base::string16 text;
+    Paragraph words;
+  };
+
   // blink::WebTextCheckClient:
   void RequestCheckingOfText(const blink::WebString& textToCheck,
                              std::unique_ptr<blink::WebTextCheckingCompletion>
@@ -60,44 +93,51 @@ class SpellCheckClient : public blink::WebSpellCheckPanelHostClient,
     ~SpellCheckScope();
   };
 
-  // Run through the word iterator and send out requests
-  // to the JS API for checking spellings of words in the current
-  // request.
+  // Splits the text of the pending request into paragraphs, and tokenizes
+  // the ones that are not cached on the tokenizer's sequence.
   void SpellCheckText();
 
+  // Caches the paragraphs of request |request_id|, and continues it if it is
+  // still pending.
+  void OnParagraphsTokenized(int request_id,
+                             std::vector<size_t> indices,
+                             std::vector<TokenizedParagraph> paragraphs);
+
+  // Sends the words of the pending request whose spelling is not cached to
+  // the JS API, or finishes the request if there are none.
+  void CheckUncachedWords();
+
   // Call JavaScript to check spelling a word.
   // The javascript function will callback OnSpellCheckDone
   // with the results of all the misspelled words.
   void SpellCheckWords(const SpellCheckScope& scope,
-                       const std::set<base::string16>& words);
-
-  // Returns whether or not the given word is a contraction of valid words
-  // (e.g. "word:word").
-  // Output variable contraction_words will contain individual
-  // words in the contraction.
-  bool IsContraction(const SpellCheckScope& scope,
-                     const base::string16& word,
-                     std::vector<base::string16>* contraction_words);
+                       const std::set<base::string16>& words,
+                       int request_id);
 
   // Callback for the JS API which returns the list of misspelled words.
-  void OnSpellCheckDone(const std::vector<base::string16>& misspelled_words);
+  void OnSpellCheckDone(const std::set<base::string16>& words,
+                        int request_id,
+                        const std::vector<base::string16>& misspelled_words);
+
+  bool IsMisspelled(const base::string16& word);
+
+  // Sends the misspelled words of the pending request to Blink.
+  void FinishRequest();
 
-  // Represents character attributes used for filtering out characters which
-  // are not supported by this SpellCheck object.
-  SpellcheckCharAttribute character_attributes_;
+  // Whether each word is misspelled, as returned by the JS API.
+  base::HashingMRUCache<base::string16, bool> misspelled_cache_;
+  // The words of the paragraphs checked lately.
+  base::HashingMRUCache<base::string16, Paragraph> paragraph_cache_;
 
-  // Represents word iterators used in this spellchecker. The |text_iterator_|
-  // splits text provided by WebKit into words, contractions, or concatenated
-  // words. The |contraction_iterator_| splits a concatenated word extracted by
-  // |text_iterator_| into word components so we can treat a concatenated word
-  // consisting only of correct words as a correct word.
-  SpellcheckWordIterator text_iterator_;
-  SpellcheckWordIterator contraction_iterator_;
+  scoped_refptr<base::SequencedTaskRunner> tokenizer_task_runner_;
+  // Lives on |tokenizer_task_runner_|.
+  std::unique_ptr<Tokenizer, base::OnTaskRunnerDeleter> tokenizer_;
 
   // The parameters of a pending background-spellchecking request.
   // (When WebKit sends two or more requests, we cancel the previous
   // requests so we do not have to use vectors.)
   std::unique_ptr<SpellcheckRequest> pending_request_param_;
+  int next_request_id_ = 0;
 
   v8::Isolate* isolate_;
   v8::Global<v8::Context> context_;
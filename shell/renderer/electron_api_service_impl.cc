@@ -10,11 +10,11 @@
 
 #include "base/environment.h"
 #include "base/macros.h"
-#include "base/threading/thread_restrictions.h"
 #include "mojo/public/cpp/system/platform_handle.h"
 #include "shell/common/atom_constants.h"
 #include "shell/common/gin_converters/blink_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
+#include "shell/common/heap_profiler.h"
 #include "shell/common/heap_snapshot.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/options_switches.h"
@@ -213,9 +213,8 @@ void ElectronApiServiceImpl::UpdateCrashpadPipeName(
 
 void ElectronApiServiceImpl::TakeHeapSnapshot(
     mojo::ScopedHandle file,
+    bool gzip,
     TakeHeapSnapshotCallback callback) {
-  base::ThreadRestrictions::ScopedAllowIO allow_io;
-
   base::PlatformFile platform_file;
   if (mojo::UnwrapPlatformFile(std::move(file), &platform_file) !=
       MOJO_RESULT_OK) {
@@ -223,12 +222,35 @@ void ElectronApiServiceImpl::TakeHeapSnapshot(
     std::move(callback).Run(false);
     return;
   }
-  base::File base_file(platform_file);
 
-  bool success =
-      electron::TakeHeapSnapshot(blink::MainThreadIsolate(), &base_file);
+  electron::TakeHeapSnapshotInBackground(
+      blink::MainThreadIsolate(), base::File(platform_file),
+      gzip ? HeapSnapshotCompression::kGzip : HeapSnapshotCompression::kNone,
+      std::move(callback));
+}
+
+void ElectronApiServiceImpl::StreamHeapSnapshot(
+    mojo::ScopedDataPipeProducerHandle pipe,
+    bool gzip,
+    StreamHeapSnapshotCallback callback) {
+  electron::TakeHeapSnapshotInBackground(
+      blink::MainThreadIsolate(), std::move(pipe),
+      gzip ? HeapSnapshotCompression::kGzip : HeapSnapshotCompression::kNone,
+      std::move(callback));
+}
+
+void ElectronApiServiceImpl::StartSamplingHeapProfiler(
+    uint64_t sampling_interval,
+    int32_t stack_depth,
+    StartSamplingHeapProfilerCallback callback) {
+  std::move(callback).Run(electron::StartSamplingHeapProfiler(
+      blink::MainThreadIsolate(), sampling_interval, stack_depth));
+}
 
-  std::move(callback).Run(success);
+void ElectronApiServiceImpl::StopSamplingHeapProfiler(
+    StopSamplingHeapProfilerCallback callback) {
+  std::move(callback).Run(
+      electron::StopSamplingHeapProfiler(blink::MainThreadIsolate()));
 }
 
 }  // namespace electron
@@ -39,7 +39,17 @@ class ElectronApiServiceImpl : public mojom::ElectronRenderer,
 #endif
   void UpdateCrashpadPipeName(const std::string& pipe_name) override;
   void TakeHeapSnapshot(mojo::ScopedHandle file,
+                        bool gzip,
                         TakeHeapSnapshotCallback callback) override;
+  void StreamHeapSnapshot(mojo::ScopedDataPipeProducerHandle pipe,
+                          bool gzip,
+                          StreamHeapSnapshotCallback callback) override;
+  void StartSamplingHeapProfiler(
+      uint64_t sampling_interval,
+      int32_t stack_depth,
+      StartSamplingHeapProfilerCallback callback) override;
+  void StopSamplingHeapProfiler(
+      StopSamplingHeapProfilerCallback callback) override;
 
   base::WeakPtr<ElectronApiServiceImpl> GetWeakPtr() {
     return weak_factory_.GetWeakPtr();
@@ -687,6 +687,17 @@ describe('app module', () => {
       app.setPath('music', __dirname)
       expect(app.getPath('music')).to.equal(__dirname)
     })
+
+    it('returns the overridden dictionaries path', () => {
+      const dictionariesPath = app.getPath('dictionaries')
+      expect(path.basename(dictionariesPath)).to.equal('Dictionaries')
+      try {
+        app.setPath('dictionaries', __dirname)
+        expect(app.getPath('dictionaries')).to.equal(__dirname)
+      } finally {
+        app.setPath('dictionaries', dictionariesPath)
+      }
+    })
   })
 
   describe('setPath(name, path)', () => {
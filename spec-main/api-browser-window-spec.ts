@@ -1028,6 +1028,19 @@ describe('BrowserWindow module', () => {
       // Values can be 0,2,3,4, or 6. We want 6, which is RGB + Alpha
       expect(imgBuffer[25]).to.equal(6)
     })
+
+    it('captures at the requested size', async () => {
+      const w = new BrowserWindow({ show: false, width: 400, height: 200, useContentSize: true })
+      w.loadURL('about:blank')
+      await emittedOnce(w, 'ready-to-show')
+      w.show()
+
+      const image = await w.capturePage(undefined, { width: 100 })
+      expect(image.getSize()).to.deep.equal({ width: 100, height: 50 })
+
+      const cropped = await w.capturePage({ x: 0, y: 0, width: 200, height: 100 }, { scaleFactor: 0.5 })
+      expect(cropped.getSize()).to.deep.equal({ width: 100, height: 50 })
+    })
   })
 
   describe('BrowserWindow.setProgressBar(progress)', () => {
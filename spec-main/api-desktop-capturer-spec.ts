@@ -129,6 +129,44 @@ ifdescribe(features.isDesktopCapturerEnabled() && !process.arch.includes('arm')
     expect(mediaSourceId).to.equal(foundSource!.id)
   })
 
+  describe('watchSources', () => {
+    it('throws an error for invalid options', async () => {
+      const promise = w.webContents.executeJavaScript(`
+        require('electron').desktopCapturer.watchSources(['window', 'screen'])
+      `)
+      await expect(promise).to.be.eventually.rejectedWith(Error, 'Invalid options')
+    })
+
+    it('emits every source before ready', async () => {
+      const result = await w.webContents.executeJavaScript(`new Promise((resolve, reject) => {
+        const watcher = require('electron').desktopCapturer.watchSources({
+          types: ['window', 'screen'],
+          thumbnailSize: { width: 0, height: 0 }
+        })
+        const added = []
+        watcher.on('source-added', (source) => added.push(source.id))
+        watcher.on('error', reject)
+        watcher.once('ready', () => {
+          const sources = watcher.getSources().map(source => source.id)
+          watcher.stop()
+          resolve({ added, sources })
+        })
+      })`)
+      expect(result.added).to.deep.equal(result.sources)
+    })
+
+    it('emits ready without sources if blocked by the main process', async () => {
+      w.webContents.once('desktop-capturer-get-sources', (event) => {
+        event.preventDefault()
+      })
+      const sources = await w.webContents.executeJavaScript(`new Promise((resolve) => {
+        const watcher = require('electron').desktopCapturer.watchSources({ types: ['screen'] })
+        watcher.once('ready', () => resolve(watcher.getSources().length))
+      })`)
+      expect(sources).to.equal(0)
+    })
+  })
+
   // TODO(deepak1556): currently fails on all ci, enable it after upgrade.
   it.skip('moveAbove should move the window at the requested place', async () => {
     // DesktopCapturer.getSources() is guaranteed to return in the correct
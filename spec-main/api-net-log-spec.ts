@@ -123,6 +123,77 @@ describe('netLog module', () => {
     expect(JSON.parse(dump).events.some((x: any) => x.params && x.params.bytes && Buffer.from(x.params.bytes, 'base64').includes(unique))).to.be.true('uuid present in dump')
   })
 
+  describe('ring buffer', () => {
+    const fetch = (url: string) => new Promise((resolve) => {
+      const req = net.request({ url, session: session.fromPartition('net-log') })
+      req.on('response', (response) => {
+        response.on('data', () => {}) // https://github.com/electron/electron/issues/19214
+        response.on('end', () => resolve())
+      })
+      req.end()
+    })
+
+    afterEach(async () => {
+      if (testNetLog().currentlyBuffering) {
+        await testNetLog().stopRingBuffer()
+      }
+    })
+
+    it('should start and stop when .startRingBuffer() and .stopRingBuffer() are called', async () => {
+      testNetLog().startRingBuffer()
+      expect(testNetLog().currentlyBuffering).to.be.true('currently buffering')
+      expect(() => testNetLog().startRingBuffer()).to.throw(/already a ring buffer running/)
+      await testNetLog().stopRingBuffer()
+      expect(testNetLog().currentlyBuffering).to.be.false('currently buffering')
+      await expect(testNetLog().stopRingBuffer()).to.be.rejectedWith('No ring buffer in progress')
+    })
+
+    it('should throw on invalid options', () => {
+      expect(() => testNetLog().startRingBuffer({ duration: -1 })).to.throw()
+      expect(() => testNetLog().startRingBuffer({ urls: ['not a pattern'] })).to.throw(/Invalid url pattern/)
+      expect(() => testNetLog().startRingBuffer({ captureMode: 'aoeu' as any })).to.throw()
+    })
+
+    it('should write the buffered events when .snapshot() is called', async () => {
+      testNetLog().startRingBuffer()
+      await fetch(`${serverUrl}/ring-buffer`)
+      await testNetLog().snapshot(dumpFileDynamic)
+      const dump = JSON.parse(fs.readFileSync(dumpFileDynamic, 'utf8'))
+      expect(dump.constants).to.have.property('logEventTypes')
+      expect(dump.events.some((x: any) => x.params && x.params.url === `${serverUrl}/ring-buffer`)).to.be.true('url present in snapshot')
+    })
+
+    it('should only keep the events of matching urls', async () => {
+      testNetLog().startRingBuffer({ urls: [`${serverUrl}/kept`] })
+      await fetch(`${serverUrl}/kept`)
+      await fetch(`${serverUrl}/dropped`)
+      await testNetLog().snapshot(dumpFileDynamic)
+      const dump = fs.readFileSync(dumpFileDynamic, 'utf8')
+      expect(dump).to.contain(`${serverUrl}/kept`)
+      expect(dump).not.to.contain(`${serverUrl}/dropped`)
+    })
+
+    it('should write the binary format when requested', async () => {
+      testNetLog().startRingBuffer()
+      await fetch(serverUrl)
+      await testNetLog().snapshot(dumpFileDynamic, { format: 'binary' })
+      const dump = fs.readFileSync(dumpFileDynamic)
+      expect(dump.slice(0, 4).toString()).to.equal('ENLB')
+      expect(dump[4]).to.equal(1)
+    })
+
+    it('should reject a pending .snapshot() when .stopRingBuffer() is called', async () => {
+      testNetLog().startRingBuffer()
+      const snapshot = testNetLog().snapshot(dumpFileDynamic)
+      await testNetLog().stopRingBuffer()
+      await expect(snapshot).to.be.rejectedWith('The ring buffer was stopped')
+    })
+
+    it('should reject .snapshot() without a ring buffer', async () => {
+      await expect(testNetLog().snapshot(dumpFileDynamic)).to.be.rejectedWith('No ring buffer in progress')
+    })
+  })
+
   ifit(process.platform !== 'linux')('should begin and end logging automatically when --log-net-log is passed', async () => {
     const appProcess = ChildProcess.spawn(process.execPath,
       [appPath], {
@@ -3,6 +3,9 @@ import { net as originalNet, session, ClientRequest } from 'electron'
 import * as http from 'http'
 import * as url from 'url'
 import { AddressInfo } from 'net'
+import * as fs from 'fs'
+import * as os from 'os'
+import * as path from 'path'
 
 const outstandingRequests: ClientRequest[] = []
 const net: {request: (typeof originalNet)['request']} = {
@@ -1263,6 +1266,161 @@ describe('net module', () => {
         urlRequest.end()
       })
     })
+
+    it('should deliver the body in chunks of at most highWaterMark bytes', async () => {
+      const body = randomString(10 * kOneKiloByte)
+      const serverUrl = await respondOnce.toSingleURL((request, response) => {
+        response.end(body)
+      })
+      const urlRequest = net.request({ url: serverUrl, highWaterMark: kOneKiloByte })
+      const chunks: Buffer[] = await new Promise((resolve, reject) => {
+        urlRequest.on('response', (response) => {
+          const chunks: Buffer[] = []
+          response.on('data', (chunk) => chunks.push(chunk))
+          response.on('end', () => resolve(chunks))
+          response.on('error', reject)
+        })
+        urlRequest.end()
+      })
+      for (const chunk of chunks) {
+        expect(chunk.length).to.be.at.most(kOneKiloByte)
+      }
+      expect(Buffer.concat(chunks).toString()).to.equal(body)
+    })
+
+    it('should stop reading from the network while the response is paused', async () => {
+      const bodySize = 32 * kOneMegaByte
+      const chunk = randomBuffer(kOneMegaByte)
+      let bytesSent = 0
+      let serverFinished = false
+      const serverUrl = await respondOnce.toSingleURL((request, response) => {
+        const writeMore = () => {
+          while (bytesSent < bodySize) {
+            bytesSent += chunk.length
+            if (!response.write(chunk)) {
+              response.once('drain', writeMore)
+              return
+            }
+          }
+          response.end(() => { serverFinished = true })
+        }
+        writeMore()
+      })
+      const urlRequest = net.request(serverUrl)
+      const response = await new Promise<Electron.IncomingMessage>((resolve) => {
+        urlRequest.on('response', resolve)
+        urlRequest.end()
+      })
+      await new Promise(resolve => setTimeout(resolve, 500))
+      expect(serverFinished).to.be.false('server finished while the response was paused')
+      expect(bytesSent).to.be.below(bodySize)
+
+      let bytesReceived = 0
+      response.on('data', (data) => { bytesReceived += data.length })
+      await new Promise(resolve => response.on('end', resolve))
+      expect(bytesReceived).to.equal(bodySize)
+    })
+
+    it('should reject an invalid highWaterMark', () => {
+      expect(() => {
+        net.request({ url: 'http://127.0.0.1', highWaterMark: 0 })
+      }).to.throw(/`highWaterMark` should be a positive integer/)
+    })
+
+    describe('with a destination', () => {
+      let tmpDir: string
+      beforeEach(() => { tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-net-spec-')) })
+      afterEach(() => { fs.rmdirSync(tmpDir, { recursive: true } as any) })
+
+      function download (options: any) {
+        return new Promise<{progress: number[][]}>((resolve, reject) => {
+          const urlRequest = net.request(options)
+          urlRequest.on('response', (response) => {
+            const progress: number[][] = []
+            response.on('data', () => expect.fail('Unexpected data event'))
+            response.on('progress' as any, (transferred: number, total: number) => progress.push([transferred, total]))
+            response.on('end', () => resolve({ progress }))
+            response.on('error', reject)
+          })
+          urlRequest.on('error', reject)
+          urlRequest.end()
+        })
+      }
+
+      it('writes the body to a file', async () => {
+        const body = randomBuffer(kOneMegaByte)
+        const serverUrl = await respondOnce.toSingleURL((request, response) => {
+          response.setHeader('Content-Length', body.length)
+          response.end(body)
+        })
+        const filePath = path.join(tmpDir, 'download')
+        const { progress } = await download({ url: serverUrl, destination: { path: filePath } })
+        expect(fs.readFileSync(filePath).equals(body)).to.be.true('file contents')
+        expect(progress[progress.length - 1]).to.deep.equal([body.length, body.length])
+      })
+
+      it('writes the body to a file descriptor', async () => {
+        const body = randomBuffer(kOneKiloByte)
+        const serverUrl = await respondOnce.toSingleURL((request, response) => {
+          response.end(body)
+        })
+        const filePath = path.join(tmpDir, 'download')
+        const fd = fs.openSync(filePath, 'w')
+        try {
+          await download({ url: serverUrl, destination: { fd } })
+        } finally {
+          fs.closeSync(fd)
+        }
+        expect(fs.readFileSync(filePath).equals(body)).to.be.true('file contents')
+      })
+
+      it('resumes a partial download with a Range request', async () => {
+        const body = randomBuffer(2 * kOneKiloByte)
+        const filePath = path.join(tmpDir, 'download')
+        fs.writeFileSync(filePath, body.slice(0, kOneKiloByte))
+        let rangeHeader: string | undefined
+        const serverUrl = await respondOnce.toSingleURL((request, response) => {
+          rangeHeader = request.headers.range
+          response.statusCode = 206
+          response.setHeader('Content-Range', `bytes ${kOneKiloByte}-${body.length - 1}/${body.length}`)
+          response.setHeader('Content-Length', body.length - kOneKiloByte)
+          response.end(body.slice(kOneKiloByte))
+        })
+        const { progress } = await download({ url: serverUrl, destination: { path: filePath, resume: true } })
+        expect(rangeHeader).to.equal(`bytes=${kOneKiloByte}-`)
+        expect(fs.readFileSync(filePath).equals(body)).to.be.true('file contents')
+        expect(progress[progress.length - 1]).to.deep.equal([body.length, body.length])
+      })
+
+      it('overwrites the file when the server ignores the range', async () => {
+        const body = randomBuffer(kOneKiloByte)
+        const filePath = path.join(tmpDir, 'download')
+        fs.writeFileSync(filePath, randomBuffer(2 * kOneKiloByte))
+        const serverUrl = await respondOnce.toSingleURL((request, response) => {
+          response.end(body)
+        })
+        await download({ url: serverUrl, destination: { path: filePath, resume: true } })
+        expect(fs.readFileSync(filePath).equals(body)).to.be.true('file contents')
+      })
+
+      it('keeps the file of an unsuccessful response', async () => {
+        const partial = randomBuffer(kOneKiloByte)
+        const filePath = path.join(tmpDir, 'download')
+        fs.writeFileSync(filePath, partial)
+        const serverUrl = await respondOnce.toSingleURL((request, response) => {
+          response.statusCode = 500
+          response.end('error')
+        })
+        await download({ url: serverUrl, destination: { path: filePath, resume: true } })
+        expect(fs.readFileSync(filePath).equals(partial)).to.be.true('file contents')
+      })
+
+      it('throws for an invalid destination', () => {
+        expect(() => {
+          net.request({ url: 'http://127.0.0.1', destination: {} } as any)
+        }).to.throw(/`destination` should have either a `path` or an `fd`/)
+      })
+    })
   })
 
   describe('Stability and performance', () => {
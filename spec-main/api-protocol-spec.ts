@@ -192,6 +192,57 @@ describe('protocol module', () => {
       await registerBufferProtocol(protocolName, (request, callback) => callback(text as any))
       await expect(ajax(protocolName + '://fake-host')).to.be.eventually.rejectedWith(Error, '404')
     })
+
+    it('sends a slice of a Buffer as response', async () => {
+      const padded = Buffer.from(`xx${text}yy`)
+      await registerBufferProtocol(protocolName, (request, callback) => callback(padded.slice(2, 2 + text.length)))
+      const r = await ajax(protocolName + '://fake-host')
+      expect(r.data).to.equal(text)
+    })
+
+    describe('with an asset table', () => {
+      it('serves assets by path', async () => {
+        protocol.registerBufferProtocol(protocolName, {
+          '/index.html': Buffer.from(text),
+          '/data.json': { mimeType: 'application/json', data: Buffer.from('{}') }
+        })
+        const r = await ajax(protocolName + '://fake-host/index.html?query')
+        expect(r.data).to.equal(text)
+        expect(r.headers).to.match(/^content-type: text\/html$/m)
+        const json = await ajax(protocolName + '://fake-host/data.json')
+        expect(json.headers).to.match(/^content-type: application\/json$/m)
+      })
+
+      it('serves assets by URL', async () => {
+        protocol.registerBufferProtocol(protocolName, {
+          [protocolName + '://host-a/file.txt']: Buffer.from('a'),
+          [protocolName + '://host-b/file.txt']: Buffer.from('b')
+        })
+        const a = await ajax(protocolName + '://host-a/file.txt')
+        expect(a.data).to.equal('a')
+        const b = await ajax(protocolName + '://host-b/file.txt')
+        expect(b.data).to.equal('b')
+      })
+
+      it('fails for missing assets', async () => {
+        protocol.registerBufferProtocol(protocolName, { '/index.html': Buffer.from(text) })
+        await expect(ajax(protocolName + '://fake-host/missing.html')).to.be.eventually.rejectedWith(Error, '404')
+      })
+
+      it('is not affected by later changes to the buffers', async () => {
+        const buffer = Buffer.from(text)
+        protocol.registerBufferProtocol(protocolName, { '/index.html': buffer })
+        buffer.fill(0)
+        const r = await ajax(protocolName + '://fake-host/index.html')
+        expect(r.data).to.equal(text)
+      })
+
+      it('throws for invalid assets', () => {
+        expect(() => {
+          protocol.registerBufferProtocol(protocolName, { '/index.html': 42 } as any)
+        }).to.throw(/Invalid asset for \/index.html/)
+      })
+    })
   })
 
   describe('protocol.registerFileProtocol', () => {
@@ -259,6 +310,86 @@ describe('protocol module', () => {
     })
   })
 
+  describe('protocol.registerStaticProtocol', () => {
+    const asarPath = path.join(fixturesPath, 'test.asar', 'a.asar')
+
+    it('serves files from a directory', async () => {
+      expect(protocol.registerStaticProtocol(protocolName, { root: path.join(fixturesPath, 'pages') })).to.equal(true)
+      const r = await ajax(protocolName + '://fake-host/a.html')
+      expect(r.data).to.equal(String(fs.readFileSync(path.join(fixturesPath, 'pages', 'a.html'))))
+      expect(r.headers).to.match(/^content-type: text\/html$/m)
+      expect(r.headers).to.match(/^etag: ".+"$/m)
+      expect(r.headers).to.match(/^cache-control: no-cache$/m)
+      expect(r.headers).to.include('access-control-allow-origin: *')
+    })
+
+    it('serves files from an asar archive', async () => {
+      protocol.registerStaticProtocol(protocolName, { root: asarPath, cacheControl: 'max-age=3600' })
+      const r = await ajax(protocolName + '://fake-host/file1')
+      expect(r.data).to.equal(String(fs.readFileSync(path.join(asarPath, 'file1'))))
+      expect(r.headers).to.match(/^cache-control: max-age=3600$/m)
+    })
+
+    it('maps hosts to roots', async () => {
+      protocol.registerStaticProtocol(protocolName, {
+        hosts: { pages: path.join(fixturesPath, 'pages'), archive: asarPath }
+      })
+      const page = await ajax(protocolName + '://pages/a.html')
+      expect(page.data).to.equal(String(fs.readFileSync(path.join(fixturesPath, 'pages', 'a.html'))))
+      const file = await ajax(protocolName + '://archive/file1')
+      expect(file.data).to.equal(String(fs.readFileSync(path.join(asarPath, 'file1'))))
+      await expect(ajax(protocolName + '://other/a.html')).to.be.eventually.rejectedWith(Error, '404')
+    })
+
+    it('supports Range requests', async () => {
+      protocol.registerStaticProtocol(protocolName, { root: path.join(fixturesPath, 'pages') })
+      const content = fs.readFileSync(path.join(fixturesPath, 'pages', 'a.html'))
+      const r = await ajax(protocolName + '://fake-host/a.html', { headers: { Range: 'bytes=0-3' } })
+      expect(r.status).to.equal(206)
+      expect(r.data).to.equal(String(content.slice(0, 4)))
+      expect(r.headers).to.include(`content-range: bytes 0-3/${content.length}`)
+    })
+
+    it('answers matching If-None-Match with 304', async () => {
+      protocol.registerStaticProtocol(protocolName, { root: path.join(fixturesPath, 'pages') })
+      const r = await ajax(protocolName + '://fake-host/a.html')
+      const etag = (r.headers.match(/^etag: (.+)$/m) as RegExpMatchArray)[1].trim()
+      const cached = await ajax(protocolName + '://fake-host/a.html', { headers: { 'If-None-Match': etag } })
+      expect(cached.status).to.equal(304)
+    })
+
+    it('does not serve files outside of the root', async () => {
+      protocol.registerStaticProtocol(protocolName, { root: path.join(fixturesPath, 'pages') })
+      await expect(ajax(protocolName + '://fake-host/..%2Fpages%2Fa.html')).to.be.eventually.rejectedWith(Error, '404')
+    })
+
+    it('calls the handler only for missing files', async () => {
+      const requests: string[] = []
+      protocol.registerStaticProtocol(protocolName, { root: path.join(fixturesPath, 'pages') }, (request, callback) => {
+        requests.push(request.url)
+        callback(path.join(fixturesPath, 'pages', 'b.html'))
+      })
+      await ajax(protocolName + '://fake-host/a.html')
+      const r = await ajax(protocolName + '://fake-host/missing.html')
+      expect(r.data).to.equal(String(fs.readFileSync(path.join(fixturesPath, 'pages', 'b.html'))))
+      expect(requests).to.deep.equal([protocolName + '://fake-host/missing.html'])
+    })
+
+    it('returns false when the scheme is already registered', async () => {
+      await registerStringProtocol(protocolName, (req, cb) => cb())
+      expect(protocol.registerStaticProtocol(protocolName, { root: fixturesPath })).to.equal(false)
+    })
+
+    it('throws for invalid options', () => {
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, {} as any)
+      }).to.throw(/Must pass a 'root' or 'hosts'/)
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, { root: 'relative' })
+      }).to.throw(/'root' must be an absolute path/)
+    })
+  })
+
   describe('protocol.registerHttpProtocol', () => {
     it('sends url as response', async () => {
       const server = http.createServer((req, res) => {
@@ -394,6 +525,125 @@ describe('protocol module', () => {
     })
   })
 
+  describe('protocol.setResponseCache', () => {
+    afterEach(async () => {
+      protocol.setResponseCache(protocolName, null)
+      await protocol.clearResponseCache(protocolName)
+    })
+
+    async function registerCountingStreamProtocol (headers: Record<string, string>) {
+      let count = 0
+      await registerStreamProtocol(protocolName, (request, callback) => {
+        count++
+        callback({ headers, data: getStream(3, request.headers['x-variant'] || text) })
+      })
+      return () => count
+    }
+
+    it('serves fresh responses without calling the handler again', async () => {
+      const count = await registerCountingStreamProtocol({ 'cache-control': 'max-age=60' })
+      protocol.setResponseCache(protocolName, {})
+      const r1 = await ajax(protocolName + '://fake-host/page')
+      const r2 = await ajax(protocolName + '://fake-host/page')
+      expect(r1.data).to.equal(text)
+      expect(r2.data).to.equal(text)
+      expect(count()).to.equal(1)
+    })
+
+    it('does not cache responses marked as no-store', async () => {
+      const count = await registerCountingStreamProtocol({ 'cache-control': 'no-store' })
+      protocol.setResponseCache(protocolName, {})
+      await ajax(protocolName + '://fake-host/page')
+      await ajax(protocolName + '://fake-host/page')
+      expect(count()).to.equal(2)
+    })
+
+    it('does not cache responses without freshness information', async () => {
+      const count = await registerCountingStreamProtocol({})
+      protocol.setResponseCache(protocolName, {})
+      await ajax(protocolName + '://fake-host/page')
+      await ajax(protocolName + '://fake-host/page')
+      expect(count()).to.equal(2)
+    })
+
+    it('keys responses on the request headers named in Vary', async () => {
+      const count = await registerCountingStreamProtocol({ 'cache-control': 'max-age=60', 'vary': 'x-variant' })
+      protocol.setResponseCache(protocolName, {})
+      const url = protocolName + '://fake-host/page'
+      const r1 = await ajax(url, { headers: { 'x-variant': 'a' } })
+      const r2 = await ajax(url, { headers: { 'x-variant': 'b' } })
+      const r3 = await ajax(url, { headers: { 'x-variant': 'a' } })
+      expect(r1.data).to.equal('a')
+      expect(r2.data).to.equal('b')
+      expect(r3.data).to.equal('a')
+      expect(count()).to.equal(2)
+    })
+
+    it('does not cache responses larger than maxEntrySize', async () => {
+      const count = await registerCountingStreamProtocol({ 'cache-control': 'max-age=60' })
+      protocol.setResponseCache(protocolName, { maxEntrySize: 4 })
+      await ajax(protocolName + '://fake-host/page')
+      await ajax(protocolName + '://fake-host/page')
+      expect(count()).to.equal(2)
+    })
+
+    it('drops cached responses when disabled or cleared', async () => {
+      const count = await registerCountingStreamProtocol({ 'cache-control': 'max-age=60' })
+      protocol.setResponseCache(protocolName, {})
+      await ajax(protocolName + '://fake-host/page')
+      await protocol.clearResponseCache(protocolName)
+      await ajax(protocolName + '://fake-host/page')
+      expect(count()).to.equal(2)
+      protocol.setResponseCache(protocolName, null)
+      protocol.setResponseCache(protocolName, {})
+      await ajax(protocolName + '://fake-host/page')
+      expect(count()).to.equal(3)
+    })
+
+    it('caches the responses of HTTP protocols', async () => {
+      let requests = 0
+      const server = http.createServer((req, res) => {
+        requests++
+        res.setHeader('Cache-Control', 'max-age=60')
+        res.end(text)
+      })
+      after(() => server.close())
+      await server.listen(0, '127.0.0.1')
+
+      const port = (server.address() as AddressInfo).port
+      await registerHttpProtocol(protocolName, (request, callback) => callback({ url: `http://127.0.0.1:${port}` }))
+      protocol.setResponseCache(protocolName, {})
+      const r1 = await ajax(protocolName + '://fake-host')
+      const r2 = await ajax(protocolName + '://fake-host')
+      expect(r1.data).to.equal(text)
+      expect(r2.data).to.equal(text)
+      expect(requests).to.equal(1)
+    })
+
+    it('replays the headers of cached HTTP responses unchanged', async () => {
+      const server = http.createServer((req, res) => {
+        res.setHeader('Cache-Control', 'max-age=60')
+        res.setHeader('Access-Control-Allow-Origin', '*')
+        res.end(text)
+      })
+      after(() => server.close())
+      await server.listen(0, '127.0.0.1')
+
+      const port = (server.address() as AddressInfo).port
+      await registerHttpProtocol(protocolName, (request, callback) => callback({ url: `http://127.0.0.1:${port}` }))
+      protocol.setResponseCache(protocolName, {})
+      const r1 = await ajax(protocolName + '://fake-host')
+      const r2 = await ajax(protocolName + '://fake-host')
+      expect(r2.data).to.equal(text)
+      expect(r2.headers).to.equal(r1.headers)
+    })
+
+    it('throws for invalid options', () => {
+      expect(() => protocol.setResponseCache(protocolName, { maxSize: -1 })).to.throw(/positive integers/)
+      expect(() => protocol.setResponseCache(protocolName, 'cache' as any)).to.throw(/object or null/)
+    })
+  })
+
   describe('protocol.isProtocolHandled', () => {
     it('returns true for built-in protocols', async () => {
       for (const p of ['about', 'file', 'http', 'https']) {
@@ -176,6 +176,86 @@ describe('session module', () => {
       expect(removeEventRemoved).to.equal(true)
     })
 
+    describe('ses.cookies.setMany()', () => {
+      it('sets all cookies', async () => {
+        const { cookies } = session.fromPartition('cookies-set-many')
+        const expirationDate = (+new Date()) / 1000 + 120
+        const details = []
+        for (let i = 0; i < 50; i++) {
+          details.push({ url, name: `many${i}`, value: `${i}`, expirationDate })
+        }
+        await cookies.setMany(details)
+        const list = await cookies.get({ url })
+        for (let i = 0; i < 50; i++) {
+          expect(list.some(c => c.name === `many${i}` && c.value === `${i}`)).to.equal(true)
+        }
+      })
+
+      it('rejects without setting anything when a cookie is invalid', async () => {
+        const { cookies } = session.fromPartition('cookies-set-many-invalid')
+        await expect(
+          cookies.setMany([{ url, name: 'valid', value: '1' }, { url: 'asdf', name: 'invalid', value: '1' }])
+        ).to.eventually.be.rejectedWith('Failed to get cookie domain')
+        const list = await cookies.get({ url })
+        expect(list.some(c => c.name === 'valid')).to.equal(false)
+      })
+
+      it('resolves for an empty list', async () => {
+        await session.defaultSession.cookies.setMany([])
+      })
+    })
+
+    describe('ses.cookies.removeMany()', () => {
+      it('removes all cookies', async () => {
+        const { cookies } = session.fromPartition('cookies-remove-many')
+        const expirationDate = (+new Date()) / 1000 + 120
+        await cookies.setMany([
+          { url, name: 'a', value: '1', expirationDate },
+          { url, name: 'b', value: '2', expirationDate },
+          { url, name: 'c', value: '3', expirationDate }
+        ])
+        await cookies.removeMany([{ url, name: 'a' }, { url, name: 'b' }])
+        const list = await cookies.get({ url })
+        expect(list.map(c => c.name)).to.deep.equal(['c'])
+      })
+    })
+
+    describe('ses.cookies.getAllForUrls()', () => {
+      it('merges the cookies of all urls', async () => {
+        const { cookies } = session.fromPartition('cookies-get-all-for-urls')
+        const expirationDate = (+new Date()) / 1000 + 120
+        await cookies.setMany([
+          { url: 'http://a.example.com', name: 'a', value: '1', expirationDate },
+          { url: 'http://b.example.com', name: 'b', value: '2', expirationDate },
+          { url: 'http://example.com', domain: 'example.com', name: 'shared', value: '3', expirationDate }
+        ])
+        const list = await cookies.getAllForUrls(['http://a.example.com', 'http://b.example.com'])
+        expect(list.map(c => c.name).sort()).to.deep.equal(['a', 'b', 'shared'])
+      })
+    })
+
+    describe('ses.cookies.setChangeBatchInterval()', () => {
+      it('emits the changes of a domain as one batch', async () => {
+        const { cookies } = session.fromPartition('cookies-changed-batch')
+        let changedEvents = 0
+        cookies.on('changed', () => changedEvents++)
+        cookies.setChangeBatchInterval(200)
+        const batch = emittedOnce(cookies, 'changed-batch')
+        const expirationDate = (+new Date()) / 1000 + 120
+        await cookies.setMany([
+          { url, name: 'a', value: '1', expirationDate },
+          { url, name: 'b', value: '2', expirationDate }
+        ])
+        const [, domain, changes] = await batch
+        cookies.setChangeBatchInterval(0)
+        expect(domain).to.equal('127.0.0.1')
+        expect(changes.map((c: any) => c.cookie.name).sort()).to.deep.equal(['a', 'b'])
+        expect(changes[0]).to.have.property('cause', 'explicit')
+        expect(changes[0]).to.have.property('removed', false)
+        expect(changedEvents).to.equal(0)
+      })
+    })
+
     describe('ses.cookies.flushStore()', async () => {
       it('flushes the cookies to disk', async () => {
         const name = 'foo'
@@ -883,4 +963,153 @@ describe('session module', () => {
       expect(headers!['user-agent']).to.equal(userAgent)
     })
   })
+
+  describe('ses.setNetworkEmulationProfile(profile)', () => {
+    afterEach(closeAllWindows)
+
+    let server: http.Server
+    let serverUrl: string
+    before(async () => {
+      server = http.createServer((req, res) => { res.end('hello') })
+      await new Promise(resolve => server.listen(0, '127.0.0.1', resolve))
+      serverUrl = `http://127.0.0.1:${(server.address() as AddressInfo).port}`
+    })
+    after(() => {
+      server.close()
+    })
+
+    const fetch = (ses: Session, url: string) => new Promise<string>((resolve, reject) => {
+      const request = net.request({ url, session: ses })
+      request.on('response', (response) => {
+        let data = ''
+        response.on('data', (chunk) => { data += chunk })
+        response.on('end', () => resolve(data))
+      })
+      request.on('error', reject)
+      request.end()
+    })
+
+    it('throws on invalid rules', () => {
+      const ses = session.fromPartition('' + Math.random())
+      expect(() => {
+        ses.setNetworkEmulationProfile({ rules: [{ urls: ['not a pattern'] }] })
+      }).to.throw(/Invalid url pattern/)
+      expect(() => {
+        ses.setNetworkEmulationProfile({ rules: [{ resourceTypes: ['nope'] }] })
+      }).to.throw(/Invalid resource type/)
+      expect(() => {
+        ses.setNetworkEmulationProfile({ rules: [{ failureRate: 2 }] })
+      }).to.throw(/failureRate/)
+    })
+
+    it('fails requests of the net module matching a lossy rule', async () => {
+      const ses = session.fromPartition('' + Math.random())
+      ses.setNetworkEmulationProfile({
+        rules: [{ urls: [`${serverUrl}/lossy`], failureRate: 1 }]
+      })
+      await expect(fetch(ses, `${serverUrl}/lossy`)).to.eventually.be.rejectedWith(/ERR_CONNECTION_RESET/)
+      expect(await fetch(ses, `${serverUrl}/other`)).to.equal('hello')
+      ses.setNetworkEmulationProfile(null)
+      expect(await fetch(ses, `${serverUrl}/lossy`)).to.equal('hello')
+    })
+
+    it('fails the same requests for the same seed', async () => {
+      const run = async () => {
+        const ses = session.fromPartition('' + Math.random())
+        ses.setNetworkEmulationProfile({ rules: [{ failureRate: 0.5 }], seed: 7 })
+        const results = []
+        for (let i = 0; i < 10; i++) {
+          results.push(await fetch(ses, serverUrl).then(() => true, () => false))
+        }
+        return results
+      }
+      expect(await run()).to.deep.equal(await run())
+    })
+
+    it('applies the conditions of a rule to renderers', async () => {
+      const ses = session.fromPartition('' + Math.random())
+      ses.setNetworkEmulationProfile({
+        rules: [{ resourceTypes: ['mainFrame'], conditions: { offline: true } }]
+      })
+      const w = new BrowserWindow({ show: false, webPreferences: { session: ses } })
+      await expect(w.loadURL(serverUrl)).to.eventually.be.rejected()
+      ses.setNetworkEmulationProfile(null)
+      await w.loadURL(serverUrl)
+    })
+  })
+
+  describe('ses.setWarmupConfig(config)', () => {
+    afterEach(closeAllWindows)
+
+    let server: http.Server
+    let serverUrl: string
+    let requestedPaths: string[]
+    beforeEach(async () => {
+      requestedPaths = []
+      server = http.createServer((req, res) => {
+        requestedPaths.push(req.url!)
+        res.setHeader('Cache-Control', 'max-age=60')
+        res.end('hello')
+      })
+      await new Promise(resolve => server.listen(0, '127.0.0.1', resolve))
+      serverUrl = `http://127.0.0.1:${(server.address() as AddressInfo).port}`
+    })
+    afterEach(() => {
+      server.close()
+    })
+
+    it('can be retrieved with getWarmupConfig()', () => {
+      const ses = session.fromPartition('' + Math.random())
+      ses.setWarmupConfig({
+        preconnect: [`${serverUrl}/some/path`],
+        dnsPrefetch: ['example.com'],
+        prefetch: [`${serverUrl}/asset.js`],
+        learnOrigins: true,
+        maxLearnedOrigins: 3
+      })
+      expect(ses.getWarmupConfig()).to.deep.equal({
+        preconnect: [`${serverUrl}/`],
+        dnsPrefetch: ['example.com'],
+        prefetch: [`${serverUrl}/asset.js`],
+        learnOrigins: true,
+        maxLearnedOrigins: 3
+      })
+    })
+
+    it('throws on invalid urls', () => {
+      const ses = session.fromPartition('' + Math.random())
+      expect(() => {
+        ses.setWarmupConfig({ preconnect: ['not a url'] })
+      }).to.throw(/Invalid preconnect origin/)
+      expect(() => {
+        ses.setWarmupConfig({ prefetch: ['file:///etc/hosts'] })
+      }).to.throw(/Invalid prefetch URL/)
+    })
+
+    it('prefetches resources when warmUp() is called', async () => {
+      const ses = session.fromPartition('' + Math.random())
+      ses.setWarmupConfig({ prefetch: [`${serverUrl}/asset.js`] })
+      ses.warmUp()
+      while (!requestedPaths.includes('/asset.js')) {
+        await new Promise(resolve => setTimeout(resolve, 50))
+      }
+    })
+
+    it('learns the origins used by the session', async () => {
+      const ses = session.fromPartition('persist:' + Math.random())
+      ses.setWarmupConfig({ learnOrigins: true })
+      const w = new BrowserWindow({ show: false, webPreferences: { session: ses } })
+      await w.loadURL(serverUrl)
+      expect(ses.getLearnedOrigins()).to.include(`${serverUrl}/`)
+      ses.clearLearnedOrigins()
+      expect(ses.getLearnedOrigins()).to.deep.equal([])
+    })
+
+    it('does not learn origins unless enabled', async () => {
+      const ses = session.fromPartition('persist:' + Math.random())
+      const w = new BrowserWindow({ show: false, webPreferences: { session: ses } })
+      await w.loadURL(serverUrl)
+      expect(ses.getLearnedOrigins()).to.deep.equal([])
+    })
+  })
 })
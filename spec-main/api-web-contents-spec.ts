@@ -3,8 +3,9 @@ import { AddressInfo } from 'net'
 import * as path from 'path'
 import * as fs from 'fs'
 import * as http from 'http'
+import * as zlib from 'zlib'
 import * as ChildProcess from 'child_process'
-import { BrowserWindow, ipcMain, webContents, session, WebContents, app, clipboard } from 'electron'
+import { BrowserWindow, ipcMain, webContents, session, WebContents, app, clipboard, nativeImage } from 'electron'
 import { emittedOnce } from './events-helpers'
 import { closeAllWindows } from './window-helpers'
 import { ifdescribe, ifit } from './spec-helpers'
@@ -1183,6 +1184,54 @@ describe('webContents module', () => {
     })
   })
 
+  describe('getIPCStats() API', () => {
+    afterEach(closeAllWindows)
+    it('counts messages received from the renderer per channel', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.webContents.loadURL('about:blank')
+      w.webContents.resetIPCStats()
+      const received = new Promise(resolve => {
+        let count = 0
+        ipcMain.on('ipc-stats', function listener () {
+          if (++count === 3) {
+            ipcMain.removeListener('ipc-stats', listener)
+            resolve()
+          }
+        })
+      })
+      w.webContents.executeJavaScript(`
+        const { ipcRenderer } = require('electron')
+        for (let i = 0; i < 3; i++) ipcRenderer.send('ipc-stats', 'x'.repeat(100))
+      `)
+      await received
+
+      const stats = w.webContents.getIPCStats()
+      expect(stats).to.have.property('ipc-stats')
+      expect(stats['ipc-stats'].received.count).to.equal(3)
+      expect(stats['ipc-stats'].received.bytes).to.be.at.least(300)
+      expect(stats['ipc-stats'].sent.count).to.equal(0)
+      expect(stats['ipc-stats'].dispatchTime.max).to.be.at.least(stats['ipc-stats'].dispatchTime.p50)
+    })
+
+    it('counts messages sent to the renderer', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.webContents.loadURL('about:blank')
+      w.webContents.resetIPCStats()
+      w.webContents.send('ipc-stats-sent', 'hello')
+      const stats = w.webContents.getIPCStats()
+      expect(stats['ipc-stats-sent'].sent.count).to.equal(1)
+      expect(stats['ipc-stats-sent'].sent.bytes).to.be.above(0)
+    })
+
+    it('is cleared by resetIPCStats()', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.webContents.loadURL('about:blank')
+      w.webContents.send('ipc-stats-reset')
+      w.webContents.resetIPCStats()
+      expect(w.webContents.getIPCStats()).to.deep.equal({})
+    })
+  })
+
   describe('referrer', () => {
     afterEach(closeAllWindows)
     it('propagates referrer information to new target=_blank windows', (done) => {
@@ -1355,6 +1404,94 @@ describe('webContents module', () => {
       const promise = w.webContents.takeHeapSnapshot('')
       return expect(promise).to.be.eventually.rejectedWith(Error, 'takeHeapSnapshot failed')
     })
+
+    it('can compress the snapshot with gzip', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+
+      const filePath = path.join(app.getPath('temp'), 'test.heapsnapshot.gz')
+      try {
+        await w.webContents.takeHeapSnapshot(filePath, { compression: 'gzip' })
+        const snapshot = JSON.parse(zlib.gunzipSync(fs.readFileSync(filePath)).toString())
+        expect(snapshot).to.have.property('snapshot')
+      } finally {
+        try {
+          fs.unlinkSync(filePath)
+        } catch (e) {
+          // ignore error
+        }
+      }
+    })
+
+    it('fails with an invalid compression', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+
+      const filePath = path.join(app.getPath('temp'), 'test.heapsnapshot')
+      const promise = w.webContents.takeHeapSnapshot(filePath, { compression: 'bogus' })
+      return expect(promise).to.be.eventually.rejectedWith(Error, 'Invalid compression')
+    })
+  })
+
+  describe('startSamplingHeapProfiler() / stopSamplingHeapProfiler()', () => {
+    afterEach(closeAllWindows)
+
+    it('returns an allocation profile', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('about:blank')
+      await w.webContents.startSamplingHeapProfiler({ samplingInterval: 1024 })
+      await w.webContents.executeJavaScript('window.garbage = new Array(100000).fill(0).map((_, i) => ({ i }))')
+      const profile = JSON.parse(await w.webContents.stopSamplingHeapProfiler())
+      expect(profile).to.have.property('head')
+      expect(profile.head).to.have.property('children')
+      expect(profile.samples).to.be.an('array').that.is.not.empty()
+    })
+
+    it('rejects when the profiler was not started', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+      await expect(w.webContents.stopSamplingHeapProfiler()).to.eventually.be.rejectedWith(Error, 'stopSamplingHeapProfiler failed')
+    })
+
+    it('rejects non-positive options', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+      await expect(w.webContents.startSamplingHeapProfiler({ samplingInterval: -1 })).to.eventually.be.rejectedWith(Error, 'must be positive')
+      await expect(w.webContents.startSamplingHeapProfiler({ stackDepth: 0 })).to.eventually.be.rejectedWith(Error, 'must be positive')
+    })
+
+    it('fails to start twice', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+      await w.webContents.startSamplingHeapProfiler()
+      await expect(w.webContents.startSamplingHeapProfiler()).to.eventually.be.rejectedWith(Error, 'startSamplingHeapProfiler failed')
+      await w.webContents.stopSamplingHeapProfiler()
+    })
+  })
+
+  describe('createHeapSnapshotStream()', () => {
+    afterEach(closeAllWindows)
+
+    const readAll = (stream: NodeJS.ReadableStream) => new Promise<Buffer>((resolve, reject) => {
+      const chunks: Buffer[] = []
+      stream.on('data', (chunk: Buffer) => chunks.push(chunk))
+      stream.on('end', () => resolve(Buffer.concat(chunks)))
+      stream.on('error', reject)
+    })
+
+    it('streams the snapshot to the main process', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('about:blank')
+      const data = await readAll(w.webContents.createHeapSnapshotStream())
+      expect(JSON.parse(data.toString())).to.have.property('snapshot')
+    })
+
+    it('streams a gzip compressed snapshot', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+      const data = await readAll(w.webContents.createHeapSnapshotStream({ compression: 'gzip' }))
+      expect(JSON.parse(zlib.gunzipSync(data).toString())).to.have.property('snapshot')
+    })
   })
 
   describe('setBackgroundThrottling()', () => {
@@ -1408,6 +1545,168 @@ describe('webContents module', () => {
         expect(data).to.be.an.instanceof(Buffer).that.is.not.empty()
       }
     })
+
+    it('prints only the given page ranges', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      const page = '<h1>1</h1><h1 style="page-break-before: always">2</h1><h1 style="page-break-before: always">3</h1>'
+      await w.loadURL(`data:text/html,${page}`)
+      const all = await w.webContents.printToPDF({})
+      const first = await w.webContents.printToPDF({ pageRanges: [{ from: 0, to: 0 }] })
+      expect(first.length).to.be.below(all.length)
+      await expect(w.webContents.printToPDF({ pageRanges: [{ from: 2, to: 1 }] })).to.eventually.be.rejectedWith(/pageRanges/)
+    })
+
+    it('can stream a PDF', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('data:text/html,<h1>Hello, World!</h1>')
+      const expected = await w.webContents.printToPDF({})
+      const chunks: Buffer[] = []
+      const stream = w.webContents.printToPDFStream({})
+      stream.on('data', (chunk: Buffer) => chunks.push(chunk))
+      await emittedOnce(stream, 'end')
+      const data = Buffer.concat(chunks)
+      expect(data.slice(0, 4).toString()).to.equal('%PDF')
+      expect(data.length).to.equal(expected.length)
+    })
+
+    it('can write a PDF to a file', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('data:text/html,<h1>Hello, World!</h1>')
+      const filePath = path.join(app.getPath('temp'), `print-to-pdf-${process.pid}.pdf`)
+      try {
+        await w.webContents.printToPDFFile(filePath, {})
+        const data = fs.readFileSync(filePath)
+        expect(data.slice(0, 4).toString()).to.equal('%PDF')
+      } finally {
+        if (fs.existsSync(filePath)) fs.unlinkSync(filePath)
+      }
+    })
+
+    it('limits the number of PDFs generated at once', async () => {
+      expect(() => webContents.setPrintToPDFConcurrency(0)).to.throw(/limit/)
+      const windows = [0, 1, 2].map(() => new BrowserWindow({ show: false, webPreferences: { sandbox: true } }))
+      await Promise.all(windows.map(w => w.loadURL('data:text/html,<h1>Hello, World!</h1>')))
+      // Count the PDFs that are being generated by the renderers.
+      let running = 0
+      let maxRunning = 0
+      for (const w of windows) {
+        const contents = w.webContents as any
+        const printToPDF = contents._printToPDF
+        contents._printToPDF = async (...args: any[]) => {
+          running++
+          maxRunning = Math.max(maxRunning, running)
+          try {
+            return await printToPDF.apply(contents, args)
+          } finally {
+            running--
+          }
+        }
+      }
+      webContents.setPrintToPDFConcurrency(1)
+      try {
+        const results = await Promise.all(windows.map(w => w.webContents.printToPDF({})))
+        for (const data of results) {
+          expect(data).to.be.an.instanceof(Buffer).that.is.not.empty()
+        }
+        expect(maxRunning).to.equal(1)
+      } finally {
+        webContents.setPrintToPDFConcurrency(Infinity)
+      }
+    })
+
+    it('rejects pending PDFs when the page is destroyed', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('data:text/html,<h1>Hello, World!</h1>')
+      const promise = w.webContents.printToPDF({})
+      w.destroy()
+      await expect(promise).to.eventually.be.rejected()
+    })
+  })
+
+  ifdescribe(features.isOffscreenRenderingEnabled())('webContents.createRenderPool()', () => {
+    const getPoolContents = () => webContents.getAllWebContents().filter(contents => contents.getType() === 'offscreen')
+    let pool: Electron.RenderPool
+    afterEach(() => {
+      if (pool) pool.destroy()
+    })
+
+    it('renders pages to html and png', async () => {
+      pool = webContents.createRenderPool({ width: 100, height: 50 })
+      const html = await pool.render({ url: 'data:text/html,<p>rendered</p>', format: 'html' })
+      expect(html).to.contain('<p>rendered</p>')
+      const png = await pool.render({ url: 'data:text/html,<p>rendered</p>', format: 'png' })
+      const image = nativeImage.createFromBuffer(png as Buffer)
+      expect(image.getSize().width).to.be.greaterThan(0)
+    })
+
+    ifit(features.isPrintingEnabled())('renders pages to pdf', async () => {
+      pool = webContents.createRenderPool()
+      const pdf = await pool.render({ url: 'data:text/html,<h1>Hello, World!</h1>', format: 'pdf' })
+      expect(pdf.slice(0, 4).toString()).to.equal('%PDF')
+    })
+
+    it('reuses its web contents between jobs', async () => {
+      const before = getPoolContents().length
+      pool = webContents.createRenderPool({ size: 1 })
+      await pool.render({ url: 'data:text/html,first', format: 'html' })
+      const html = await pool.render({ url: 'data:text/html,second', format: 'html' })
+      expect(html).to.contain('second')
+      expect(getPoolContents().length).to.equal(before + 1)
+    })
+
+    it('runs at most size jobs at once', async () => {
+      const before = getPoolContents().length
+      pool = webContents.createRenderPool({ size: 2 })
+      const jobs = [0, 1, 2, 3].map(i => pool.render({ url: `data:text/html,${i}`, format: 'html' }))
+      expect(pool.pendingCount).to.equal(2)
+      const results = await Promise.all(jobs)
+      results.forEach((html, i) => expect(html).to.contain(`${i}`))
+      expect(getPoolContents().length).to.equal(before + 2)
+    })
+
+    it('replaces an idle web contents that was destroyed', async () => {
+      const before = getPoolContents()
+      pool = webContents.createRenderPool({ size: 2 })
+      const released = new Promise(resolve => {
+        app.once('web-contents-created', (event, contents) => {
+          contents.on('did-finish-load', () => {
+            if (contents.getURL() === 'about:blank') setImmediate(resolve)
+          })
+        })
+      })
+      await pool.render({ url: 'data:text/html,first', format: 'html' })
+      await released
+      const [idle] = getPoolContents().filter(contents => !before.includes(contents))
+      (idle as any).destroy()
+      const html = await pool.render({ url: 'data:text/html,second', format: 'html' })
+      expect(html).to.contain('second')
+      expect(getPoolContents().length).to.equal(before.length + 1)
+    })
+
+    it('rejects jobs that time out', async () => {
+      pool = webContents.createRenderPool({ size: 1 })
+      const server = http.createServer(() => { /* never responds */ })
+      await new Promise(resolve => server.listen(0, '127.0.0.1', resolve))
+      try {
+        const { port } = server.address() as AddressInfo
+        await expect(pool.render({ url: `http://127.0.0.1:${port}`, format: 'html', timeout: 100 }))
+          .to.eventually.be.rejectedWith(/timed out/)
+        const html = await pool.render({ url: 'data:text/html,after', format: 'html' })
+        expect(html).to.contain('after')
+      } finally {
+        server.close()
+      }
+    })
+
+    it('rejects waiting jobs when destroyed', async () => {
+      pool = webContents.createRenderPool({ size: 1 })
+      const running = pool.render({ url: 'data:text/html,running', format: 'html' })
+      const waiting = pool.render({ url: 'data:text/html,waiting', format: 'html' })
+      pool.destroy()
+      await expect(waiting).to.eventually.be.rejectedWith(/destroyed/)
+      await expect(running).to.eventually.be.fulfilled()
+      await expect(pool.render({ url: 'data:text/html,late' })).to.eventually.be.rejectedWith(/destroyed/)
+    })
   })
 
   describe('PictureInPicture video', () => {
@@ -1608,4 +1907,48 @@ describe('webContents module', () => {
       expect(eventAuthInfo.realm).to.equal('Foo')
     })
   })
+
+  describe('createCaptureSession()', () => {
+    afterEach(closeAllWindows)
+
+    const showPage = async () => {
+      const w = new BrowserWindow({ show: false, width: 400, height: 200, useContentSize: true })
+      w.loadURL('about:blank')
+      await emittedOnce(w, 'ready-to-show')
+      w.show()
+      return w
+    }
+
+    it('captures snapshots at the size of the session', async () => {
+      const w = await showPage()
+      const session = w.webContents.createCaptureSession({ width: 100 })
+      const [first, second] = await Promise.all([session.capture(), session.capture()])
+      expect(first.getSize()).to.deep.equal({ width: 100, height: 50 })
+      expect(second.getSize()).to.deep.equal({ width: 100, height: 50 })
+      const third = await session.capture()
+      expect(third.getSize()).to.deep.equal({ width: 100, height: 50 })
+    })
+
+    it('encodes snapshots in the format of the session', async () => {
+      const w = await showPage()
+      const session = w.webContents.createCaptureSession({ height: 20, format: 'jpeg', quality: 50 })
+      const jpeg = await session.captureEncoded()
+      expect(jpeg[0]).to.equal(0xff)
+      expect(jpeg[1]).to.equal(0xd8)
+    })
+
+    it('rejects captures once stopped', async () => {
+      const w = await showPage()
+      const session = w.webContents.createCaptureSession()
+      const pending = session.capture()
+      session.stop()
+      await expect(pending).to.eventually.be.rejectedWith('The capture session was stopped')
+      await expect(session.capture()).to.eventually.be.rejectedWith('The capture session was stopped')
+    })
+
+    it('throws on an unknown format', () => {
+      const w = new BrowserWindow({ show: false })
+      expect(() => w.webContents.createCaptureSession({ format: 'gif' } as any)).to.throw('Unknown format: gif')
+    })
+  })
 })
@@ -8,7 +8,7 @@ describe('webFrame module', () => {
 
   afterEach(closeAllWindows)
 
-  it('calls a spellcheck provider', async () => {
+  const typeInSpellCheckPage = async (inputText: string, expectedWords: number) => {
     const w = new BrowserWindow({
       show: false,
       webPreferences: {
@@ -20,21 +20,36 @@ describe('webFrame module', () => {
     await w.webContents.executeJavaScript('document.querySelector("input").focus()', true)
 
     const spellCheckerFeedback =
-      new Promise<[string[], boolean]>(resolve => {
-        ipcMain.on('spec-spell-check', (e, words, callbackDefined) => {
-          if (words.length === 5) {
-            // The API calls the provider after every completed word.
-            // The promise is resolved only after this event is received with all words.
-            resolve([words, callbackDefined])
+      new Promise<[string[][], boolean]>(resolve => {
+        const calls: string[][] = []
+        const listener = (e: Electron.IpcMainEvent, words: string[], callbackDefined: boolean) => {
+          // The API calls the provider after every completed word, with the
+          // words it has not checked yet.
+          // The promise is resolved only after all words were received.
+          calls.push(words)
+          if (new Set(([] as string[]).concat(...calls)).size === expectedWords) {
+            ipcMain.removeListener('spec-spell-check', listener)
+            resolve([calls, callbackDefined])
           }
-        })
+        }
+        ipcMain.on('spec-spell-check', listener)
       })
-    const inputText = `spleling test you're `
     for (const keyCode of inputText) {
       w.webContents.sendInputEvent({ type: 'char', keyCode })
     }
-    const [words, callbackDefined] = await spellCheckerFeedback
+    return spellCheckerFeedback
+  }
+
+  it('calls a spellcheck provider', async () => {
+    const [calls, callbackDefined] = await typeInSpellCheckPage(`spleling test you're `, 5)
+    const words = Array.from(new Set(([] as string[]).concat(...calls)))
     expect(words.sort()).to.deep.equal(['spleling', 'test', `you're`, 'you', 're'].sort())
     expect(callbackDefined).to.be.true()
   })
+
+  it('calls a spellcheck provider once per word', async () => {
+    const [calls] = await typeInSpellCheckPage(`test spleling test spleling again `, 3)
+    const words = ([] as string[]).concat(...calls)
+    expect(words.sort()).to.deep.equal(['again', 'spleling', 'test'])
+  })
 })
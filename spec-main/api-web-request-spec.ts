@@ -107,6 +107,38 @@ describe('webRequest module', () => {
       })).to.eventually.be.rejectedWith('404')
     })
 
+    it('can read ranges of the upload body', async () => {
+      const postData = { name: 'post test', type: 'string' }
+      const expected = qs.stringify(postData)
+      let elements: any[] = []
+      let head = ''
+      let tail = ''
+      ses.webRequest.onBeforeRequest(async (details, callback) => {
+        const body = details.uploadBody!
+        elements = body.getElements()
+        head = (await body.read(0, 0, 4)).toString()
+        tail = (await body.read(0, 4)).toString()
+        callback({ cancel: true })
+      })
+      await expect(ajax(defaultURL, {
+        type: 'POST',
+        data: postData
+      })).to.eventually.be.rejectedWith('404')
+      expect(elements).to.deep.equal([{ type: 'bytes', length: expected.length }])
+      expect(head).to.equal(expected.substr(0, 4))
+      expect(tail).to.equal(expected.substr(4))
+    })
+
+    it('does not set uploadBody for requests without a body', async () => {
+      let hasBody = true
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        hasBody = details.uploadBody !== undefined
+        callback({})
+      })
+      await ajax(defaultURL)
+      expect(hasBody).to.be.false()
+    })
+
     it('can redirect the request', async () => {
       ses.webRequest.onBeforeRequest((details, callback) => {
         if (details.url === defaultURL) {
@@ -317,4 +349,132 @@ describe('webRequest module', () => {
       await expect(ajax(defaultURL)).to.eventually.be.rejectedWith('404')
     })
   })
+
+  describe('webRequest.setRules', () => {
+    afterEach(() => {
+      ses.webRequest.setRules([])
+      ses.webRequest.onBeforeRequest(null)
+    })
+
+    it('can block requests', async () => {
+      ses.webRequest.setRules([
+        { urls: [defaultURL + 'blocked/*'], action: 'block' }
+      ])
+      const { data } = await ajax(`${defaultURL}allowed/test`)
+      expect(data).to.equal('/allowed/test')
+      await expect(ajax(`${defaultURL}blocked/test`)).to.eventually.be.rejectedWith('404')
+    })
+
+    it('can redirect requests', async () => {
+      ses.webRequest.setRules([
+        { urls: [defaultURL + 'old'], action: 'redirect', redirectURL: `${defaultURL}new` }
+      ])
+      const { data } = await ajax(`${defaultURL}old`)
+      expect(data).to.equal('/new')
+    })
+
+    it('can modify headers', async () => {
+      ses.webRequest.setRules([{
+        urls: ['*://127.0.0.1/*'],
+        action: 'modifyHeaders',
+        requestHeaders: { Accept: '*/*;test/header' },
+        responseHeaders: { Custom: 'Changed' }
+      }])
+      const { data, headers } = await ajax(defaultURL)
+      expect(data).to.equal('/header/received')
+      expect(headers).to.match(/^custom: Changed$/m)
+    })
+
+    it('does not call onBeforeRequest for blocked requests', async () => {
+      let called = false
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        called = true
+        callback({})
+      })
+      ses.webRequest.setRules([{ urls: ['<all_urls>'], action: 'block' }])
+      await expect(ajax(defaultURL)).to.eventually.be.rejectedWith('404')
+      expect(called).to.be.false()
+    })
+
+    it('can match many patterns', async () => {
+      const urls = []
+      for (let i = 0; i < 10000; i++) {
+        urls.push(`*://*.host${i}.example/*`)
+      }
+      urls.push(defaultURL + 'blocked/*')
+      ses.webRequest.setRules([{ urls, action: 'block' }])
+      const { data } = await ajax(`${defaultURL}allowed`)
+      expect(data).to.equal('/allowed')
+      await expect(ajax(`${defaultURL}blocked/test`)).to.eventually.be.rejectedWith('404')
+    })
+
+    it('throws on invalid rules', () => {
+      expect(() => {
+        ses.webRequest.setRules([{ urls: ['<all_urls>'], action: 'explode' } as any])
+      }).to.throw(/Invalid rule action/)
+      expect(() => {
+        ses.webRequest.setRules([{ urls: ['<all_urls>'], action: 'redirect' }])
+      }).to.throw(/redirectURL/)
+      expect(() => {
+        ses.webRequest.setRules([{ urls: ['not a pattern'], action: 'block' }])
+      }).to.throw(/Invalid url pattern/)
+    })
+  })
+
+  describe('webRequest.setWorker', () => {
+    afterEach(async () => {
+      await ses.webRequest.setWorker(null)
+      ses.webRequest.onBeforeRequest(null)
+    })
+
+    it('calls the listeners of the worker', async () => {
+      await ses.webRequest.setWorker(`
+        webRequest.onBeforeRequest({ urls: ['*://*/blocked/*'] }, (details, callback) => {
+          callback({ cancel: true })
+        })
+      `)
+      const { data } = await ajax(`${defaultURL}allowed`)
+      expect(data).to.equal('/allowed')
+      await expect(ajax(`${defaultURL}blocked/test`)).to.eventually.be.rejectedWith('404')
+    })
+
+    it('can modify headers in the worker', async () => {
+      await ses.webRequest.setWorker(`
+        webRequest.onBeforeSendHeaders((details, callback) => {
+          const requestHeaders = details.requestHeaders
+          requestHeaders.Accept = '*/*;test/header'
+          callback({ requestHeaders })
+        })
+      `)
+      const { data } = await ajax(defaultURL)
+      expect(data).to.equal('/header/received')
+    })
+
+    it('exchanges messages with the worker', async () => {
+      let onMessage: (message: any) => void = () => {}
+      const received = new Promise<any>(resolve => { onMessage = resolve })
+      await ses.webRequest.setWorker(`
+        port.onmessage = (message) => port.postMessage({ echo: message })
+      `, (message: any) => onMessage(message))
+      ses.webRequest.postMessageToWorker({ value: 42 })
+      expect(await received).to.deep.equal({ echo: { value: 42 } })
+    })
+
+    it('takes precedence over the main process listener', async () => {
+      let called = false
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        called = true
+        callback({})
+      })
+      await ses.webRequest.setWorker(`
+        webRequest.onBeforeRequest((details, callback) => callback({}))
+      `)
+      await ajax(defaultURL)
+      expect(called).to.be.false()
+    })
+
+    it('rejects when the script throws', async () => {
+      await expect(ses.webRequest.setWorker('throw new Error("boom")')).to.eventually.be.rejectedWith(/boom/)
+    })
+  })
 })
@@ -24,6 +24,29 @@ describe('clipboard module', () => {
     })
   })
 
+  describe('clipboard.readAsync()', () => {
+    it('reads text', async () => {
+      const text = '千江有水千江月，万里无云万里天'
+      clipboard.writeText(text)
+      expect(await clipboard.readAsync('text')).to.equal(text)
+    })
+
+    it('reads images', async () => {
+      const p = path.join(fixtures, 'assets', 'logo.png')
+      const i = nativeImage.createFromPath(p)
+      clipboard.writeImage(i)
+      const image = await clipboard.readAsync('image')
+      expect(image.toDataURL()).to.equal(i.toDataURL())
+    })
+
+    it('resolves with an empty value when the format is missing', async () => {
+      clipboard.writeText('test')
+      expect(await clipboard.readAsync('rtf')).to.equal('')
+      const buffer = await clipboard.readAsync('application/x-electron-missing')
+      expect(buffer).to.be.an.instanceof(Buffer).that.is.empty()
+    })
+  })
+
   describe('clipboard.readHTML()', () => {
     it('returns markup correctly', () => {
       const text = '<string>Hi</string>'
@@ -90,6 +113,75 @@ describe('clipboard module', () => {
     })
   })
 
+  describe('clipboard.writeMany()', () => {
+    it('writes all the formats', async () => {
+      const p = path.join(fixtures, 'assets', 'logo.png')
+      const i = nativeImage.createFromPath(p)
+      const written = await clipboard.writeMany({
+        text: 'test',
+        rtf: '{\\rtf1\\utf8 text}',
+        image: i
+      })
+      expect(written).to.be.true()
+      expect(clipboard.readText()).to.equal('test')
+      expect(clipboard.readRTF()).to.equal('{\\rtf1\\utf8 text}')
+      expect(clipboard.readImage().toDataURL()).to.equal(i.toDataURL())
+    })
+
+    it('writes the formats of providers after the others', async () => {
+      let provided = false
+      const promise = clipboard.writeMany({
+        text: 'test',
+        rtf: () => {
+          provided = true
+          return '{\\rtf1\\utf8 text}'
+        }
+      })
+      expect(provided).to.be.false()
+      expect(clipboard.readText()).to.equal('test')
+      expect(await promise).to.be.true()
+      expect(clipboard.readText()).to.equal('test')
+      expect(clipboard.readRTF()).to.equal('{\\rtf1\\utf8 text}')
+    })
+
+    it('does not overwrite what was copied while providing', async () => {
+      const written = await clipboard.writeMany({
+        text: 'test',
+        rtf: async () => {
+          clipboard.writeText('copied later')
+          return '{\\rtf1\\utf8 text}'
+        }
+      })
+      expect(written).to.be.false()
+      expect(clipboard.readText()).to.equal('copied later')
+    })
+
+    it('throws an error when a custom format is not a Buffer or string', () => {
+      expect(() => {
+        clipboard.writeMany({ 'application/x-custom': 5 })
+      }).to.throw(/Custom formats must be Buffers or strings/)
+    })
+  })
+
+  describe('clipboard.readMany()', () => {
+    it('reads the formats that are on the clipboard', () => {
+      clipboard.write({ text: 'test', rtf: '{\\rtf1\\utf8 text}' })
+      const data = clipboard.readMany(['text', 'rtf', 'image'])
+      expect(data).to.deep.equal({ text: 'test', rtf: '{\\rtf1\\utf8 text}' })
+    })
+
+    it('reads custom formats as Buffers', async function () {
+      if (process.platform !== 'darwin') {
+        this.skip()
+      }
+
+      await clipboard.writeMany({ text: 'test', 'com.electron.custom': Buffer.from('custom') })
+      const data = clipboard.readMany(['text', 'com.electron.custom'])
+      expect(data.text).to.equal('test')
+      expect(data['com.electron.custom'].toString()).to.equal('custom')
+    })
+  })
+
   describe('clipboard.read/writeFindText(text)', () => {
     before(function () {
       if (process.platform !== 'darwin') {
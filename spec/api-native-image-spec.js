@@ -465,6 +465,115 @@ describe('nativeImage module', () => {
     })
   })
 
+  describe('async methods', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('creates an image from a path', async () => {
+      const image = await nativeImage.createFromPathAsync(logoPath)
+      expect(image.getSize()).to.deep.equal({ width: 538, height: 190 })
+      expect(image.toBitmap().equals(nativeImage.createFromPath(logoPath).toBitmap())).to.be.true()
+    })
+
+    it('creates an empty image from a missing path', async () => {
+      const image = await nativeImage.createFromPathAsync(path.join(__dirname, 'does-not-exist.png'))
+      expect(image.isEmpty()).to.be.true()
+    })
+
+    it('creates an image from a buffer', async () => {
+      const imageA = nativeImage.createFromPath(logoPath)
+      const imageB = await nativeImage.createFromBufferAsync(imageA.toPNG())
+      expect(imageB.toBitmap().equals(imageA.toBitmap())).to.be.true()
+      const imageC = await nativeImage.createFromBufferAsync(imageA.toBitmap(), { width: 538, height: 190 })
+      expect(imageC.getSize()).to.deep.equal({ width: 538, height: 190 })
+      expect(() => nativeImage.createFromBufferAsync(null)).to.throw('buffer must be a node Buffer')
+    })
+
+    it('encodes like the synchronous methods', async () => {
+      const image = nativeImage.createFromPath(logoPath).resize({ width: 100 })
+      expect((await image.toPNGAsync()).equals(image.toPNG())).to.be.true()
+      expect((await image.toJPEGAsync(80)).equals(image.toJPEG(80))).to.be.true()
+      expect(await image.toDataURLAsync()).to.equal(image.toDataURL())
+    })
+
+    it('resizes an image', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      expect((await image.resizeAsync({ width: 269 })).getSize()).to.deep.equal({ width: 269, height: 95 })
+      expect((await image.resizeAsync({ height: 200 })).getSize()).to.deep.equal({ width: 566, height: 200 })
+      expect((await image.resizeAsync({ width: 0, height: 0 })).isEmpty()).to.be.true()
+    })
+
+    it('runs operations on a task queue', async () => {
+      const queue = nativeImage.createTaskQueue(2)
+      expect(queue.concurrency).to.equal(2)
+      const results = Promise.all([1, 2, 3, 4].map(() => nativeImage.createFromPathAsync(logoPath, { queue })))
+      expect(queue.pending).to.equal(4)
+      for (const image of await results) {
+        expect(image.getSize()).to.deep.equal({ width: 538, height: 190 })
+      }
+      expect(queue.pending).to.equal(0)
+      expect(() => nativeImage.createTaskQueue(0)).to.throw(/concurrency/)
+    })
+
+    it('rejects the pending operations of a cancelled queue', async () => {
+      const queue = nativeImage.createTaskQueue(1)
+      const results = [1, 2, 3].map(() => nativeImage.createFromPathAsync(logoPath, { queue }).then(() => 'done', (error) => error.message))
+      queue.cancel()
+      expect(queue.pending).to.be.at.most(1)
+      for (const result of await Promise.all(results)) {
+        expect(result).to.equal('The image operation was cancelled')
+      }
+    })
+  })
+
+  describe('processBatch()', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('crops and resizes buffers, paths and images', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const results = await nativeImage.processBatch([image.toPNG(), logoPath, image], [
+        { type: 'crop', rect: { x: 0, y: 0, width: 190, height: 190 } },
+        { type: 'resize', width: 64 }
+      ])
+      expect(results).to.have.lengthOf(3)
+      for (const result of results) {
+        const output = nativeImage.createFromBuffer(result)
+        expect(output.getSize()).to.deep.equal({ width: 64, height: 64 })
+      }
+      expect(results[1].equals(results[2])).to.be.true()
+    })
+
+    it('matches cropping with the NativeImage methods', async () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const rect = { x: 30, y: 40, width: 25, height: 64 }
+      const [result] = await nativeImage.processBatch([image], [{ type: 'crop', rect }])
+      expect(result.equals(image.crop(rect).toPNG())).to.be.true()
+    })
+
+    it('encodes to JPEG and WebP', async () => {
+      const [jpeg] = await nativeImage.processBatch([logoPath], [], { format: 'jpeg', quality: 50 })
+      expect(nativeImage.createFromBuffer(jpeg).getSize()).to.deep.equal({ width: 538, height: 190 })
+      const [webp] = await nativeImage.processBatch([logoPath], [{ type: 'resize', height: 19 }], { format: 'webp' })
+      expect(webp.toString('ascii', 0, 4)).to.equal('RIFF')
+      expect(webp.toString('ascii', 8, 12)).to.equal('WEBP')
+    })
+
+    it('resolves with null for the images that failed', async () => {
+      const results = await nativeImage.processBatch([Buffer.from('not an image'), path.join(__dirname, 'does-not-exist.png'), logoPath], [
+        { type: 'crop', rect: { x: 1000, y: 1000, width: 10, height: 10 } }
+      ])
+      expect(results).to.deep.equal([null, null, null])
+      expect(await nativeImage.processBatch([], [])).to.deep.equal([])
+    })
+
+    it('validates its arguments', () => {
+      expect(() => nativeImage.processBatch(null, [])).to.throw('Must pass an array of images')
+      expect(() => nativeImage.processBatch([logoPath], [{ type: 'rotate' }])).to.throw('Unknown operation type: rotate')
+      expect(() => nativeImage.processBatch([logoPath], [{ type: 'crop' }])).to.throw('crop operations must have a rect')
+      expect(() => nativeImage.processBatch([logoPath], [], { format: 'gif' })).to.throw('Unknown format: gif')
+      expect(() => nativeImage.processBatch([42], [])).to.throw('Images must be Buffers, paths or NativeImages')
+    })
+  })
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       expect(nativeImage.createEmpty().crop({ width: 1, height: 2, x: 0, y: 0 }).isEmpty()).to.be.true()
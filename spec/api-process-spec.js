@@ -115,4 +115,33 @@ describe('process module', () => {
       expect(success).to.be.false()
     })
   })
+
+  describe('process.startSamplingHeapProfiler()', () => {
+    afterEach(() => {
+      process.stopSamplingHeapProfiler()
+    })
+
+    it('collects an allocation profile', () => {
+      expect(process.startSamplingHeapProfiler({ samplingInterval: 1024 })).to.be.true()
+      window.garbage = new Array(100000).fill(0).map((_, i) => ({ i }))
+      const profile = JSON.parse(process.stopSamplingHeapProfiler())
+      delete window.garbage
+      expect(profile).to.have.property('head')
+      expect(profile.samples).to.be.an('array')
+    })
+
+    it('returns false when already running', () => {
+      expect(process.startSamplingHeapProfiler()).to.be.true()
+      expect(process.startSamplingHeapProfiler()).to.be.false()
+    })
+
+    it('throws for non-positive options', () => {
+      expect(() => process.startSamplingHeapProfiler({ samplingInterval: 0 })).to.throw(TypeError, /must be positive/)
+      expect(() => process.startSamplingHeapProfiler({ stackDepth: -1 })).to.throw(TypeError, /must be positive/)
+    })
+
+    it('returns an empty profile when not running', () => {
+      expect(process.stopSamplingHeapProfiler()).to.equal('')
+    })
+  })
 })
@@ -70,6 +70,7 @@ declare namespace Electron {
   interface WebContentsInternal extends Electron.WebContents {
     _sendInternal(channel: string, ...args: any[]): void;
     _sendInternalToAll(channel: string, ...args: any[]): void;
+    _sendToFrameInternal(frameId: number, channel: string, ...args: any[]): void;
   }
 
   const deprecate: ElectronInternal.DeprecationUtil;
@@ -99,6 +100,8 @@ declare namespace ElectronInternal {
 
   interface DesktopCapturer {
     startHandling(captureWindow: boolean, captureScreen: boolean, thumbnailSize: Electron.Size, fetchWindowIcons: boolean): void;
+    startWatching(captureWindow: boolean, captureScreen: boolean, thumbnailSize: Electron.Size, fetchWindowIcons: boolean, interval: number): void;
+    stopWatching(): void;
     emit: typeof NodeJS.EventEmitter.prototype.emit | null;
   }
 
@@ -109,6 +112,10 @@ declare namespace ElectronInternal {
     fetchWindowIcons: boolean;
   }
 
+  interface WatchSourcesOptions extends GetSourcesOptions {
+    interval: number;
+  }
+
   interface GetSourcesResult {
     id: string;
     name: string;